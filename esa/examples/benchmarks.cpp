@@ -0,0 +1,797 @@
+#include "esa_accumulator.h"
+#include "acc_trie.h"
+#include "sharded_accumulator.h"
+#include "batch_scheduler.h"
+#include "hash_to_prime.h"
+#include "esa_manager.h"
+#include "secure_random.h"
+#include "nonce_pool.h"
+#include "esa_verifier.h"
+#ifdef __linux__
+#include "sn_server.h"
+#endif
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+#include <cstdlib>
+
+// OpenSSL内存分配计数（必须在任何OpenSSL分配之前安装）
+static std::atomic<size_t> openssl_mallocs{0};
+
+static void* counting_malloc(size_t num, const char* /* file */, int /* line */) {
+    openssl_mallocs.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(num);
+}
+
+static void* counting_realloc(void* addr, size_t num, const char* /* file */, int /* line */) {
+    openssl_mallocs.fetch_add(1, std::memory_order_relaxed);
+    return std::realloc(addr, num);
+}
+
+static void counting_free(void* addr, const char* /* file */, int /* line */) {
+    std::free(addr);
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 证明流水线：每个请求生成并验证一次成员关系证明
+static void run_proof_requests(ESAAccumulator& acc, const std::vector<BigInt>& elements, size_t requests, bool use_arena) {
+    for (size_t i = 0; i < requests; i++) {
+        const BigInt& element = elements[i % elements.size()];
+        if (use_arena) {
+            BigIntArena::Scope scope;
+            ZeroKnowledgeProof proof = acc.generate_membership_proof(element);
+            acc.verify_membership_proof(proof, element);
+        } else {
+            ZeroKnowledgeProof proof = acc.generate_membership_proof(element);
+            acc.verify_membership_proof(proof, element);
+        }
+    }
+}
+
+void benchmark_arena() {
+    std::cout << "\n=== BigIntArena 基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 16; i++) {
+        elements.push_back(BigInt(std::to_string(1000 + i)));
+        acc.add_element(elements.back());
+    }
+
+    const size_t requests = 2000;
+    for (bool use_arena : {false, true}) {
+        size_t before = openssl_mallocs.load();
+        auto start = std::chrono::steady_clock::now();
+        run_proof_requests(acc, elements, requests, use_arena);
+        double ms = elapsed_ms(start);
+        size_t mallocs = openssl_mallocs.load() - before;
+        std::cout << (use_arena ? "使用arena:   " : "不使用arena: ")
+                  << "单线程 " << requests << " 次请求, " << ms << " ms, "
+                  << "OpenSSL分配 " << mallocs << " 次 ("
+                  << static_cast<double>(mallocs) / requests << " 次/请求)" << std::endl;
+    }
+
+    // 多线程：每个线程持有自己的累加器副本，比较分配器争用
+    const size_t thread_count = std::max(2u, std::thread::hardware_concurrency());
+    for (bool use_arena : {false, true}) {
+        std::vector<ESAAccumulator*> accs;
+        for (size_t t = 0; t < thread_count; t++) {
+            accs.push_back(new ESAAccumulator(false));
+            for (const auto& element : elements) {
+                accs.back()->add_element(element);
+            }
+        }
+
+        size_t before = openssl_mallocs.load();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < thread_count; t++) {
+            threads.emplace_back([&, t]() {
+                run_proof_requests(*accs[t], elements, requests / thread_count, use_arena);
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        double ms = elapsed_ms(start);
+        size_t mallocs = openssl_mallocs.load() - before;
+        std::cout << (use_arena ? "使用arena:   " : "不使用arena: ")
+                  << thread_count << " 线程, " << ms << " ms, OpenSSL分配 " << mallocs << " 次" << std::endl;
+
+        for (auto* a : accs) {
+            delete a;
+        }
+    }
+}
+
+void benchmark_multi_intersection() {
+    std::cout << "\n=== 多路交集基准测试 ===" << std::endl;
+
+    // 三个关键词的倒排列表，最小的只有1000个元素
+    std::mt19937_64 gen(42);
+    std::vector<size_t> sizes = {1000, 200000, 500000};
+    std::vector<SortedElementSet> postings;
+    std::vector<std::unordered_set<uint64_t>> hashed;
+    for (size_t n : sizes) {
+        std::vector<uint64_t> ids;
+        for (size_t i = 0; i < n; i++) {
+            ids.push_back(gen() % 2000000);
+        }
+        postings.emplace_back(ids);
+        hashed.emplace_back(ids.begin(), ids.end());
+    }
+
+    const int rounds = 50;
+    size_t hash_result = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        // 哈希探测：用最小集合的元素逐个探测其余集合
+        hash_result = 0;
+        for (uint64_t id : hashed[0]) {
+            if (hashed[1].count(id) && hashed[2].count(id)) {
+                hash_result++;
+            }
+        }
+    }
+    double hash_ms = elapsed_ms(start) / rounds;
+
+    size_t gallop_result = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        std::vector<uint64_t> out;
+        gallop_result = SortedSetOps::intersect_k({&postings[2], &postings[1], &postings[0]}, out);
+    }
+    double gallop_ms = elapsed_ms(start) / rounds;
+
+    std::cout << "哈希探测:      " << hash_ms << " ms/查询, 结果 " << hash_result << std::endl;
+    std::cout << "多路galloping: " << gallop_ms << " ms/查询, 结果 " << gallop_result << std::endl;
+}
+
+void benchmark_trie_rehash() {
+    std::cout << "\n=== AccTrie 根摘要重新哈希基准测试 ===" << std::endl;
+
+    std::mt19937_64 gen(7);
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (int i = 0; i < 2000; i++) {
+        entries.emplace_back("kw" + std::to_string(gen() % 100000), "doc" + std::to_string(i));
+    }
+
+    AccTrie single;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& entry : entries) {
+        single.insert(entry.first, entry.second);
+    }
+    double single_ms = elapsed_ms(start);
+
+    AccTrie batched(single.get_group_order(), single.get_generator());
+    start = std::chrono::steady_clock::now();
+    batched.insert_batch(entries);
+    double batch_ms = elapsed_ms(start);
+
+    std::cout << "逐条插入(每次计算根摘要): " << single_ms << " ms" << std::endl;
+    std::cout << "批量插入(统一重新哈希):   " << batch_ms << " ms" << std::endl;
+    std::cout << "根摘要一致: " << (single.root_digest() == batched.root_digest() ? "是" : "否") << std::endl;
+}
+
+void benchmark_sharded_ingest() {
+    std::cout << "\n=== 分片累加器批量写入基准测试 ===" << std::endl;
+
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 20000; i++) {
+        elements.push_back(BigInt(std::to_string(1000003ULL * i)));
+    }
+
+    ShardedAccumulator sharded(8);
+    ESAAccumulator single(sharded.get_group_order(), sharded.get_generator(), false);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& element : elements) {
+        single.add_element(element);
+    }
+    double single_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    sharded.add_elements(elements);
+    double sharded_ms = elapsed_ms(start);
+
+    std::cout << "单累加器逐个添加: " << single_ms << " ms" << std::endl;
+    std::cout << "8分片并行批量添加(" << std::thread::hardware_concurrency() << " 核): " << sharded_ms << " ms" << std::endl;
+    std::cout << "分片之积等于单累加器: "
+              << (sharded.commitment().product == single.get_accumulator_value() ? "是" : "否") << std::endl;
+}
+
+void benchmark_hash_to_prime() {
+    std::cout << "\n=== 哈希到素数基准测试 ===" << std::endl;
+
+    const size_t count = 20000;
+    HashToPrimeEngine engine(count);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        engine.prime_for(BigInt::from_u64(1000003ULL * (i + 1)));
+    }
+    double cold_ms = elapsed_ms(start);
+
+    // 热点关键字：反复映射同一批元素
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        engine.prime_for(BigInt::from_u64(1000003ULL * (i % 256 + 1)));
+    }
+    double hot_ms = elapsed_ms(start);
+    HashToPrimeEngine::Stats stats = engine.stats();
+
+    // 素数代表是256位的，64位判定另取随机64位素数比较
+    std::vector<BigInt> candidates;
+    for (size_t i = 0; i < 2000; i++) {
+        candidates.push_back(CryptoUtils::generate_prime(64));
+    }
+    start = std::chrono::steady_clock::now();
+    for (const auto& candidate : candidates) {
+        CryptoUtils::miller_rabin(candidate, 40);
+    }
+    double miller_rabin_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (const auto& candidate : candidates) {
+        CryptoUtils::is_prime(candidate);
+    }
+    double bpsw_ms = elapsed_ms(start);
+
+    std::cout << "未命中: " << cold_ms * 1000 / count << " us/元素, 每个元素平均 "
+              << static_cast<double>(stats.candidates) / stats.misses << " 个候选, 其中 "
+              << static_cast<double>(stats.prime_tests) / stats.misses << " 个进入素性检验" << std::endl;
+    std::cout << "缓存命中: " << hot_ms * 1000 / count << " us/元素" << std::endl;
+    std::cout << "64位素数判定: miller_rabin(40轮) " << miller_rabin_ms * 1000 / candidates.size()
+              << " us, is_prime(Baillie-PSW) " << bpsw_ms * 1000 / candidates.size() << " us" << std::endl;
+}
+
+void benchmark_non_membership() {
+    std::cout << "\n=== 非成员关系证明批量生成基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    std::vector<BigInt> members;
+    for (int i = 1; i <= 2000; i++) {
+        members.push_back(BigInt::from_u64(1000003ULL * i));
+    }
+    acc.add_elements(members);
+
+    std::vector<BigInt> queries;
+    for (int i = 1; i <= 256; i++) {
+        queries.push_back(BigInt::from_u64(999983ULL * i + 1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ZeroKnowledgeProof> single;
+    for (const auto& query : queries) {
+        single.push_back(acc.generate_non_membership_proof(query));
+    }
+    double single_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<ZeroKnowledgeProof> batched = acc.generate_non_membership_proofs(queries);
+    double batched_ms = elapsed_ms(start);
+
+    size_t verified = 0;
+    for (size_t i = 0; i < queries.size(); i++) {
+        if (acc.verify_non_membership_proof(batched[i], queries[i])) {
+            verified++;
+        }
+    }
+
+    std::cout << "集合大小 " << members.size() << ", 查询 " << queries.size() << " 个" << std::endl;
+    std::cout << "逐个生成: " << single_ms << " ms" << std::endl;
+    std::cout << "乘积树批量生成: " << batched_ms << " ms" << std::endl;
+    std::cout << "批量证明验证通过: " << verified << "/" << queries.size() << std::endl;
+}
+
+void benchmark_aggregate_witness() {
+    std::cout << "\n=== 聚合见证基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    std::vector<BigInt> members;
+    for (int i = 1; i <= 2000; i++) {
+        members.push_back(BigInt::from_u64(1000003ULL * i));
+    }
+    acc.add_elements(members);
+
+    for (size_t k : {1, 16, 128}) {
+        std::vector<BigInt> subset(members.begin(), members.begin() + k);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<BigInt> witnesses;
+        for (const auto& element : subset) {
+            witnesses.push_back(acc.generate_witness(element));
+        }
+        double single_gen_ms = elapsed_ms(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < k; i++) {
+            acc.verify_witness(witnesses[i], subset[i]);
+        }
+        double single_verify_ms = elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        GroupElement aggregate = acc.generate_aggregate_witness(subset);
+        double aggregate_gen_ms = elapsed_ms(start);
+        start = std::chrono::steady_clock::now();
+        bool ok = acc.verify_aggregate_witness(aggregate, subset);
+        double aggregate_verify_ms = elapsed_ms(start);
+
+        std::cout << "k=" << k << " 逐个见证: 生成 " << single_gen_ms << " ms, 验证 " << single_verify_ms
+                  << " ms, 大小 " << k << " 个群元素" << std::endl;
+        std::cout << "k=" << k << " 聚合见证: 生成 " << aggregate_gen_ms << " ms, 验证 " << aggregate_verify_ms
+                  << " ms, 大小 1 个群元素, " << (ok ? "通过" : "失败") << std::endl;
+    }
+}
+
+void benchmark_update_proof() {
+    std::cout << "\n=== 批量更新PoE基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    uint64_t next = 1;
+    for (size_t batch : {64, 1024, 8192}) {
+        std::vector<BigInt> elements;
+        for (size_t i = 0; i < batch; i++) {
+            elements.push_back(BigInt::from_u64(1000003ULL * next++));
+        }
+        GroupElement previous = acc.get_universal_value();
+        std::vector<BigInt> applied;
+        ExponentiationProof proof;
+        auto start = std::chrono::steady_clock::now();
+        acc.add_elements(elements, applied, proof);
+        double prove_ms = elapsed_ms(start);
+        GroupElement current = acc.get_universal_value();
+
+        // 两种验证都要重算素数代表，单独计时，只比较模幂部分
+        start = std::chrono::steady_clock::now();
+        std::vector<BigInt> primes;
+        for (const auto& element : applied) {
+            primes.push_back(CryptoUtils::hash_to_prime(element));
+        }
+        double hash_ms = elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        BigInt exponent("1");
+        for (const auto& prime : primes) {
+            exponent *= prime;
+        }
+        bool direct_ok = (previous ^ exponent) == current;
+        double direct_ms = elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        bool poe_ok = ExponentiationProof::verify(acc.get_universal_group(), previous, primes, current, proof);
+        double poe_ms = elapsed_ms(start);
+
+        std::cout << "批量 " << batch << ": 更新并证明 " << prove_ms << " ms, 哈希到素数 " << hash_ms
+                  << " ms, 直接验证 " << direct_ms << " ms (" << (direct_ok ? "通过" : "失败")
+                  << "), PoE验证 " << poe_ms << " ms (" << (poe_ok ? "通过" : "失败") << ")" << std::endl;
+    }
+}
+
+void benchmark_multi_exp() {
+    std::cout << "\n=== 多重幂基准测试 ===" << std::endl;
+
+    BigInt modulus = CryptoUtils::generate_prime(2048);
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t n : {2, 32, 1000}) {
+        std::vector<BigInt> bases, exponents;
+        for (size_t i = 0; i < n; i++) {
+            bases.push_back(CryptoUtils::random_range(BigInt("2"), modulus));
+            exponents.push_back(BigInt::random(256));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        BigInt naive("1");
+        for (size_t i = 0; i < n; i++) {
+            naive = (naive * CryptoUtils::mod_pow(bases[i], exponents[i], modulus)) % modulus;
+        }
+        double naive_ms = elapsed_ms(start);
+        start = std::chrono::steady_clock::now();
+        BigInt single = CryptoUtils::mod_pow(bases[0], exponents[0], modulus);
+        double single_ms = elapsed_ms(start);
+        start = std::chrono::steady_clock::now();
+        BigInt combined = CryptoUtils::multi_exp(bases, exponents, modulus);
+        double multi_ms = elapsed_ms(start);
+        start = std::chrono::steady_clock::now();
+        BigInt parallel = CryptoUtils::multi_exp(bases, exponents, modulus, threads);
+        double parallel_ms = elapsed_ms(start);
+
+        std::cout << "n=" << n << " (2048位模数, 256位指数): 逐项模幂 " << naive_ms << " ms, 多重幂 " << multi_ms
+                  << " ms, " << threads << "线程 " << parallel_ms << " ms, 单次模幂 " << single_ms << " ms, "
+                  << (combined == naive && parallel == naive ? "一致" : "不一致") << std::endl;
+    }
+
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 1000; i++) {
+        elements.push_back(BigInt::from_u64(7919ULL * i));
+    }
+    acc.add_elements(elements);
+    std::vector<ZeroKnowledgeProof> proofs;
+    for (const auto& element : elements) {
+        proofs.push_back(acc.generate_membership_proof(element));
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t valid = 0;
+    for (size_t i = 0; i < elements.size(); i++) {
+        valid += acc.verify_membership_proof(proofs[i], elements[i]) ? 1 : 0;
+    }
+    double single_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    bool batch_ok = acc.verify_membership_proofs(proofs, elements);
+    double batch_ms = elapsed_ms(start);
+    std::cout << "1000个成员证明: 逐个验证 " << single_ms << " ms (" << valid << " 通过), 批量验证 " << batch_ms
+              << " ms (" << (batch_ok ? "通过" : "失败") << ")" << std::endl;
+}
+
+void benchmark_trapdoor_manager() {
+    std::cout << "\n=== 陷门管理节点基准测试 ===" << std::endl;
+
+    ESAAccumulatorManager manager(false);
+    ESAAccumulator public_acc(manager.get_group_order(), manager.get_generator(), manager.get_universal_group(), false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 5000; i++) {
+        elements.push_back(BigInt::from_u64(1000003ULL * i));
+    }
+    public_acc.add_elements(elements);
+    manager.add_elements(elements);
+    public_acc.flush();
+    manager.flush();
+
+    // 每轮删除一个元素并为另一个元素生成通用累加器见证
+    const size_t rounds = 5;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; i++) {
+        public_acc.remove_element(elements[i]);
+        public_acc.generate_aggregate_witness({elements[rounds + i]});
+    }
+    double public_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; i++) {
+        manager.remove_element(elements[i]);
+        manager.generate_universal_witness(elements[rounds + i]);
+    }
+    double manager_ms = elapsed_ms(start);
+
+    GroupElement witness = manager.generate_universal_witness(elements[rounds]);
+    std::cout << "集合大小 5000, " << rounds << " 轮 删除+见证: 公开累加器 " << public_ms << " ms, 陷门管理节点 "
+              << manager_ms << " ms, 见证"
+              << (public_acc.verify_aggregate_witness(witness, {elements[rounds]}) ? "通过" : "失败") << std::endl;
+}
+
+void benchmark_constant_time() {
+    std::cout << "\n=== 常数时间模幂基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    for (const BigInt& modulus : {acc.get_group_order(), CryptoUtils::generate_prime(2048)}) {
+        size_t rounds = modulus.bit_length() > 64 ? 200 : 20000;
+        std::vector<BigInt> bases, exponents;
+        for (size_t i = 0; i < rounds; i++) {
+            bases.push_back(CryptoUtils::random_range(BigInt("2"), modulus));
+            exponents.push_back(CryptoUtils::random_range(BigInt("1"), modulus));
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; i++) {
+            CryptoUtils::mod_pow(bases[i], exponents[i], modulus);
+        }
+        double variable_us = elapsed_ms(start) * 1000 / rounds;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; i++) {
+            CryptoUtils::mod_pow_secret(bases[i], exponents[i], modulus);
+        }
+        double constant_us = elapsed_ms(start) * 1000 / rounds;
+        std::cout << modulus.bit_length() << "位模数: 可变时间 " << variable_us << " us/次, 常数时间 "
+                  << constant_us << " us/次" << std::endl;
+    }
+
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 100; i++) {
+        elements.push_back(BigInt::from_u64(7919ULL * i));
+    }
+    acc.add_elements(elements);
+    for (bool hardened : {false, true}) {
+        acc.set_constant_time(hardened);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < 2000; i++) {
+            acc.generate_membership_proof(elements[i % elements.size()]);
+        }
+        std::cout << "2000个成员证明生成(" << (hardened ? "常数时间" : "固定底数表") << "): " << elapsed_ms(start)
+                  << " ms" << std::endl;
+    }
+}
+
+void benchmark_secure_random() {
+    std::cout << "\n=== 证明随机数生成基准测试 ===" << std::endl;
+
+    BigInt q = ESAAccumulator(false).get_group_order();
+    BigInt one("1");
+    const size_t count = 200000;
+    size_t bytes = (q.bit_length() + 7) / 8;
+    std::vector<uint8_t> buffer(bytes);
+
+    // 原做法：每个随机数一次RAND_bytes（经过全局DRBG）再取模
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        RAND_bytes(buffer.data(), static_cast<int>(bytes));
+        BigInt value = one + BigInt::from_bytes(buffer) % (q - one);
+    }
+    double rand_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        SecureRandom::local().uniform(one, q);
+    }
+    double single_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    SecureRandom::local().uniform_batch(one, q, count);
+    double batch_ms = elapsed_ms(start);
+    std::cout << count << "个 [1, q) 随机数: RAND_bytes+取模 " << rand_ms << " ms, SecureRandom " << single_ms
+              << " ms, 批量 " << batch_ms << " ms" << std::endl;
+
+    const size_t threads = 4;
+    for (bool buffered : {false, true}) {
+        start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, buffered]() {
+                std::vector<uint8_t> local(bytes);
+                for (size_t i = 0; i < count / threads; i++) {
+                    if (buffered) {
+                        SecureRandom::local().fill(local.data(), bytes);
+                    } else {
+                        RAND_bytes(local.data(), static_cast<int>(bytes));
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::cout << threads << "线程取 " << count << " 次随机字节(" << (buffered ? "SecureRandom" : "RAND_bytes")
+                  << "): " << elapsed_ms(start) << " ms" << std::endl;
+    }
+    const SecureRandom::Stats& stats = SecureRandom::local().stats();
+    std::cout << "本线程: 补充缓冲 " << stats.refills << " 次, 重新播种 " << stats.reseeds << " 次, 拒绝 "
+              << stats.rejections << " 个候选" << std::endl;
+}
+
+void benchmark_nonce_pool() {
+    std::cout << "\n=== 证明随机数预计算池基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 100; i++) {
+        elements.push_back(BigInt::from_u64(7919ULL * i));
+    }
+    acc.add_elements(elements);
+
+    const size_t proofs = 1000;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < proofs; i++) {
+        acc.generate_membership_proof(elements[i % elements.size()]);
+    }
+    double online_ms = elapsed_ms(start);
+
+    // 池容量覆盖整段突发，模拟空闲时间已把队列补满
+    NoncePool::Config config;
+    config.capacity = proofs;
+    auto pool = std::make_shared<NoncePool>(acc.get_generator(), acc.get_group_order() - BigInt("1"), config);
+    acc.set_nonce_pool(pool);
+    start = std::chrono::steady_clock::now();
+    pool->prefill();
+    double offline_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < proofs; i++) {
+        acc.generate_membership_proof(elements[i % elements.size()]);
+    }
+    double pooled_ms = elapsed_ms(start);
+    NoncePool::Stats stats = pool->stats();
+    std::cout << proofs << "个成员证明: 现场计算 " << online_ms << " ms, 预计算池在线部分 " << pooled_ms
+              << " ms (离线预计算 " << offline_ms << " ms)" << std::endl;
+    std::cout << "池状态: 深度 " << stats.depth << "/" << stats.capacity << ", 取出 " << stats.served << ", 取空 "
+              << stats.exhausted << ", 已生成 " << stats.produced << std::endl;
+}
+
+void benchmark_proof_bundle() {
+    std::cout << "\n=== 成员关系证明包基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 2000; i++) {
+        elements.push_back(BigInt::from_u64(7919ULL * i + 11));
+    }
+    acc.add_elements(elements);
+    acc.flush();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> single_bytes;
+    for (const auto& element : elements) {
+        acc.generate_membership_proof(element).serialize_binary(single_bytes);
+    }
+    double single_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    MembershipProofBundle bundle = acc.generate_membership_proofs(elements);
+    std::vector<uint8_t> bundle_bytes;
+    bundle.serialize_binary(bundle_bytes);
+    double bundle_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    bool ok = acc.verify_membership_bundle(bundle, elements);
+    double verify_ms = elapsed_ms(start);
+    std::cout << elements.size() << "个成员证明: 逐个生成 " << single_ms << " ms / " << single_bytes.size()
+              << " 字节, 证明包 " << bundle_ms << " ms / " << bundle_bytes.size() << " 字节, 验证 " << verify_ms
+              << " ms " << (ok ? "通过" : "失败") << std::endl;
+}
+
+void benchmark_stateless_verifier() {
+    std::cout << "\n=== 无状态验证器基准测试 ===" << std::endl;
+
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 2000; i++) {
+        elements.push_back(BigInt::from_u64(7919ULL * i + 11));
+    }
+    acc.add_elements(elements);
+    std::vector<ZeroKnowledgeProof> proofs;
+    for (const auto& element : elements) {
+        proofs.push_back(acc.generate_membership_proof(element));
+    }
+
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(1, acc);
+    auto start = std::chrono::steady_clock::now();
+    bool single_ok = true;
+    for (size_t i = 0; i < proofs.size(); i++) {
+        single_ok = verifier.verify_membership(proofs[i], elements[i], 1) && single_ok;
+    }
+    double single_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    bool batch_ok = verifier.verify_membership_batch(proofs, elements, 1, 4);
+    double batch_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    bool full_ok = acc.verify_membership_proofs(proofs, elements);
+    double full_ms = elapsed_ms(start);
+    std::cout << proofs.size() << "个成员证明: 验证器逐个 " << single_ms << " ms" << (single_ok ? "" : "(失败)")
+              << ", 验证器批量(4线程) " << batch_ms << " ms" << (batch_ok ? "" : "(失败)") << ", 完整累加器批量 "
+              << full_ms << " ms" << (full_ok ? "" : "(失败)") << std::endl;
+}
+
+void benchmark_batch_scheduler() {
+    std::cout << "\n=== 请求合并调度器基准测试 ===" << std::endl;
+
+    const size_t producers = 8;
+    const size_t per_producer = 500;
+
+    // 基线：多个调用者共享一把锁，逐个调用add_element
+    ESAAccumulator direct(false);
+    std::mutex direct_mutex;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < producers; t++) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < per_producer; i++) {
+                std::lock_guard<std::mutex> lock(direct_mutex);
+                direct.add_element(BigInt::from_u64(1000000 * (t + 1) + i));
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    double direct_ms = elapsed_ms(start);
+
+    ESAAccumulator batched(direct.get_group_order(), direct.get_generator(), false);
+    BatchScheduler::Config config;
+    config.max_batch_size = 128;
+    config.max_delay = std::chrono::microseconds(200);
+    std::vector<double> latencies(producers * per_producer);
+    {
+        BatchScheduler scheduler(batched, config);
+        threads.clear();
+        start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < producers; t++) {
+            threads.emplace_back([&, t]() {
+                // 每个调用者保持少量未完成请求
+                std::vector<std::pair<std::future<bool>, std::chrono::steady_clock::time_point>> inflight;
+                for (size_t i = 0; i < per_producer; i++) {
+                    inflight.emplace_back(scheduler.submit_insert(BigInt::from_u64(1000000 * (t + 1) + i)),
+                                          std::chrono::steady_clock::now());
+                    if (inflight.size() == 16 || i + 1 == per_producer) {
+                        for (size_t j = 0; j < inflight.size(); j++) {
+                            inflight[j].first.get();
+                            latencies[t * per_producer + i + 1 - inflight.size() + j] = elapsed_ms(inflight[j].second);
+                        }
+                        inflight.clear();
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+    double batched_ms = elapsed_ms(start);
+    std::sort(latencies.begin(), latencies.end());
+
+    size_t total = producers * per_producer;
+    std::cout << "加锁逐个添加: " << total << " 次, " << direct_ms << " ms" << std::endl;
+    std::cout << "调度器微批次: " << total << " 次, " << batched_ms << " ms, p50 "
+              << latencies[total / 2] << " ms, p99 " << latencies[total * 99 / 100] << " ms" << std::endl;
+    std::cout << "累加器值一致: "
+              << (direct.get_accumulator_value() == batched.get_accumulator_value() ? "是" : "否") << std::endl;
+}
+
+#ifdef __linux__
+void benchmark_storage_node() {
+    std::cout << "\n=== 存储节点回环基准测试 ===" << std::endl;
+
+    SNServer server(4);
+    if (!server.start("127.0.0.1", 0)) {
+        std::cout << "存储节点启动失败" << std::endl;
+        return;
+    }
+    SNClient client;
+    if (!client.connect("127.0.0.1", server.port())) {
+        std::cout << "连接存储节点失败" << std::endl;
+        return;
+    }
+
+    const int requests = 2000;
+    for (int i = 0; i < requests; i++) {
+        client.insert("kw" + std::to_string(i % 500), "doc" + std::to_string(i));
+    }
+
+    // 逐个请求：每次等待响应后再发送下一个
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < requests; i++) {
+        client.query("kw" + std::to_string(i % 700));
+    }
+    double sequential_ms = elapsed_ms(start);
+
+    // 流水线：先发送全部请求，再统一接收
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < requests; i++) {
+        client.send_query("kw" + std::to_string(i % 700));
+    }
+    SNClient::Response response;
+    for (int i = 0; i < requests && client.receive(response); i++) {
+    }
+    double pipelined_ms = elapsed_ms(start);
+
+    std::cout << "逐个查询: " << requests << " 次, " << sequential_ms << " ms" << std::endl;
+    std::cout << "流水线查询: " << requests << " 次, " << pipelined_ms << " ms" << std::endl;
+    server.stop();
+}
+#endif
+
+int main() {
+    CRYPTO_set_mem_functions(counting_malloc, counting_realloc, counting_free);
+
+    std::cout << "=== ESA累加器基准测试 ===" << std::endl;
+    benchmark_arena();
+    benchmark_multi_intersection();
+    benchmark_trie_rehash();
+    benchmark_sharded_ingest();
+    benchmark_hash_to_prime();
+    benchmark_non_membership();
+    benchmark_aggregate_witness();
+    benchmark_update_proof();
+    benchmark_multi_exp();
+    benchmark_trapdoor_manager();
+    benchmark_constant_time();
+    benchmark_secure_random();
+    benchmark_nonce_pool();
+    benchmark_proof_bundle();
+    benchmark_stateless_verifier();
+    benchmark_batch_scheduler();
+#ifdef __linux__
+    benchmark_storage_node();
+#endif
+    return 0;
+}
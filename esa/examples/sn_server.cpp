@@ -0,0 +1,32 @@
+#include "sn_server.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+
+// 存储节点守护进程：esa_sn_server [端口] [工作线程数]
+int main(int argc, char** argv) {
+    uint16_t port = argc > 1 ? static_cast<uint16_t>(std::atoi(argv[1])) : 50051;
+    size_t workers = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 4;
+
+    // 在启动任何线程之前屏蔽信号，由主线程同步等待
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    SNServer server(workers);
+    server.set_verbose(true);
+    if (!server.start("0.0.0.0", port)) {
+        std::cerr << "存储节点启动失败" << std::endl;
+        return 1;
+    }
+
+    int received;
+    sigwait(&signals, &received);
+    SNServer::Stats stats = server.stats();
+    std::cout << "收到信号 " << received << ", 停止服务。连接 " << stats.connections
+              << ", 请求 " << stats.requests << std::endl;
+    server.stop();
+    return 0;
+}
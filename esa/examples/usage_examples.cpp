@@ -1,5 +1,13 @@
 #include "esa_accumulator.h"
+#include "acc_trie.h"
+#include "sharded_accumulator.h"
+#include "esa_manager.h"
+#include "esa_verifier.h"
+#ifdef __linux__
+#include "sn_server.h"
+#endif
 #include <iostream>
+#include <iterator>
 
 void demonstrate_basic_operations() {
     std::cout << "=== 基本操作演示 ===" << std::endl;
@@ -37,6 +45,13 @@ void demonstrate_set_operations() {
     // 计算并集
     SetOperationResult union_result = acc1.compute_union(acc2.get_current_set());
     std::cout << "并集大小: " << union_result.result_set.size() << std::endl;
+    
+    // 另一个操作数的摘要取acc2公布的通用累加器值
+    std::vector<GroupElement> other_digest = {acc2.get_universal_value()};
+    std::cout << "交集证明验证: " << (acc1.verify_set_operation_proof(intersection, other_digest) ? "成功" : "失败")
+              << std::endl;
+    std::cout << "并集证明验证: " << (acc1.verify_set_operation_proof(union_result, other_digest) ? "成功" : "失败")
+              << std::endl;
 }
 
 void demonstrate_witness_system() {
@@ -59,6 +74,17 @@ void demonstrate_witness_system() {
     acc.add_element(BigInt("400"));
     acc.update_witness(witness, BigInt("400"), true);
     std::cout << "见证更新成功" << std::endl;
+    
+    // 多元素查询的聚合见证
+    std::vector<BigInt> first = {BigInt("100"), BigInt("200")};
+    std::vector<BigInt> second = {BigInt("300")};
+    GroupElement aggregate = acc.generate_aggregate_witness(first);
+    std::cout << "聚合见证验证: " << (acc.verify_aggregate_witness(aggregate, first) ? "成功" : "失败") << std::endl;
+    
+    GroupElement combined = acc.combine_aggregate_witnesses(aggregate, first,
+                                                            acc.generate_aggregate_witness(second), second);
+    std::vector<BigInt> all = {BigInt("100"), BigInt("200"), BigInt("300")};
+    std::cout << "合并见证验证: " << (acc.verify_aggregate_witness(combined, all) ? "成功" : "失败") << std::endl;
 }
 
 
@@ -82,7 +108,7 @@ void demonstrate_complement_operations() {
     std::cout << "补集大小: " << complement.result_set.size() << std::endl;
     
     // 验证补集证明
-    bool complement_valid = acc1.verify_set_operation_proof(complement);
+    bool complement_valid = acc1.verify_set_operation_proof(complement, {acc2.get_universal_value()});
     std::cout << "补集证明验证: " << (complement_valid ? "成功" : "失败") << std::endl;
 }
 
@@ -107,6 +133,185 @@ void demonstrate_element_update() {
     std::cout << "250在集合中: " << (acc.contains(BigInt("250")) ? "是" : "否") << std::endl;
 }
 
+void demonstrate_streaming_set_operations() {
+    std::cout << "\n=== 流式集合操作演示 ===" << std::endl;
+    
+    ESAAccumulator acc(false);
+    for (int i = 1; i <= 10; i++) {
+        acc.add_element(BigInt(std::to_string(i * 10)));
+    }
+    
+    // 另一个关键词的倒排列表，直接以有序列的形式给出
+    SortedElementSet posting(std::vector<uint64_t>{5, 20, 40, 45, 60, 100, 120});
+    
+    std::vector<uint64_t> intersection;
+    size_t intersection_size = acc.stream_intersection(posting, std::back_inserter(intersection));
+    std::cout << "交集大小: " << intersection_size << ", 元素:";
+    for (uint64_t id : intersection) {
+        std::cout << " " << id;
+    }
+    std::cout << std::endl;
+    
+    // 只统计个数时不需要任何输出缓冲
+    struct CountingSink {
+        CountingSink& operator*() { return *this; }
+        CountingSink& operator++(int) { return *this; }
+        CountingSink& operator=(uint64_t) { return *this; }
+    };
+    std::cout << "并集大小: " << acc.stream_union(posting, CountingSink()) << std::endl;
+    std::cout << "差集大小: " << acc.stream_difference(posting, CountingSink()) << std::endl;
+    
+    // 三个关键词的合取查询，整个查询只有一个证明
+    SortedElementSet third(std::vector<uint64_t>{20, 60, 70, 100});
+    SetOperationResult conjunctive = acc.compute_multi_intersection({&posting, &third});
+    std::cout << "三路交集大小: " << conjunctive.result_set.size() << std::endl;
+    std::vector<GroupElement> digests = {acc.compute_set_digest(posting), acc.compute_set_digest(third)};
+    std::cout << "三路交集证明验证: " << (acc.verify_set_operation_proof(conjunctive, digests) ? "成功" : "失败")
+              << std::endl;
+}
+
+void demonstrate_acc_trie() {
+    std::cout << "\n=== 累加器前缀树演示 ===" << std::endl;
+    
+    AccTrie trie;
+    trie.insert("apple", "doc1");
+    trie.insert("apple", "doc2");
+    trie.insert("banana", "doc3");
+    AccTrie::UpdateResult update = trie.insert("cherry", "doc4");
+    std::cout << "插入cherry: 前序=" << update.keyp << ", 后序=" << (update.keyn.empty() ? "<尾部>" : update.keyn) << std::endl;
+    
+    // 叶子链表按字典序遍历
+    std::cout << "有序关键词:";
+    for (const AccTrieLeaf* leaf = trie.first_leaf(); leaf; leaf = leaf->next) {
+        std::cout << " " << leaf->key << "(" << leaf->values.size() << ")";
+    }
+    std::cout << std::endl;
+    
+    // 不存在的关键词返回相邻叶子作为证明，两个邻居都对照插入时得到的根摘要验证
+    AccTrie::QueryResult absent = trie.query("avocado");
+    std::cout << "查询avocado: 前序=" << absent.keyp << ", 后序=" << absent.keyn << std::endl;
+    std::cout << "不存在证明验证: " << (AccTrie::verify_absence(absent, update.root) ? "成功" : "失败") << std::endl;
+    
+    // 前缀查询沿叶子链表顺序扫描，整个结果只需要一组边界证明
+    AccTrie::UpdateResult added = trie.insert("apricot", "doc5");
+    AccTrie::RangeResult prefix = trie.prefix_query("ap");
+    std::cout << "前缀ap匹配 " << prefix.entries.size() << " 个关键词, 完整性验证: "
+              << (AccTrie::verify_prefix(prefix, "ap", added.root) ? "成功" : "失败") << std::endl;
+    
+    // 根摘要承诺全部叶子的累加器值，客户端沿路径重新哈希即可验证
+    AccTrie::Digest root = trie.root_digest();
+    AccTrie::PathProof path = trie.prove_path("banana");
+    std::cout << "banana路径证明(" << path.steps.size() << " 层)验证: "
+              << (AccTrie::verify_path(path, root) ? "成功" : "失败") << std::endl;
+    
+    AccTrie::Stats stats = trie.stats();
+    std::cout << "叶子数: " << stats.leaves << ", Node4数: " << stats.node4 << std::endl;
+}
+
+void demonstrate_sharded_accumulator() {
+    std::cout << "\n=== 分片累加器演示 ===" << std::endl;
+    
+    ShardedAccumulator sharded(3);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 30; i++) {
+        elements.push_back(BigInt(std::to_string(2000 + i)));
+    }
+    std::cout << "批量添加: " << sharded.add_elements(elements) << " 个元素" << std::endl;
+    for (size_t i = 0; i < sharded.shard_count(); i++) {
+        std::cout << "分片 " << i << ": " << sharded.shard(i).size() << " 个元素" << std::endl;
+    }
+    
+    // 成员关系证明由元素所属的分片生成和验证
+    ESAAccumulator& owner = sharded.shard(sharded.shard_for(elements[0]));
+    ZeroKnowledgeProof proof = owner.generate_membership_proof(elements[0]);
+    std::cout << "分片内成员证明验证: " << (owner.verify_membership_proof(proof, elements[0]) ? "成功" : "失败") << std::endl;
+    
+    // 扩容只迁移一部分元素，全体元素的累加器值不变
+    GroupElement before = sharded.commitment().product;
+    std::cout << "新增分片迁移: " << sharded.add_shard() << " 个元素" << std::endl;
+    std::cout << "全体累加器值不变: " << (sharded.commitment().product == before ? "是" : "否") << std::endl;
+}
+
+void demonstrate_trapdoor_manager() {
+    std::cout << "\n=== 陷门管理节点演示 ===" << std::endl;
+    
+    // 管理节点持有RSA群的陷门 φ(N)，公开节点只做验证，两者使用同一组群参数
+    ESAAccumulatorManager manager(false);
+    ESAAccumulator verifier(manager.get_group_order(), manager.get_generator(), manager.get_universal_group(), false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 20; i++) {
+        elements.push_back(BigInt(std::to_string(3000 + i)));
+    }
+    manager.add_elements(elements);
+    verifier.add_elements(elements);
+    
+    // 删除和见证生成都与集合大小无关
+    manager.remove_element(elements[0]);
+    verifier.remove_element(elements[0]);
+    GroupElement witness = manager.generate_universal_witness(elements[1]);
+    std::cout << "陷门见证验证: " << (verifier.verify_aggregate_witness(witness, {elements[1]}) ? "成功" : "失败") << std::endl;
+    ZeroKnowledgeProof proof = manager.generate_non_membership_proof(elements[0]);
+    std::cout << "陷门非成员证明验证: " << (verifier.verify_non_membership_proof(proof, elements[0]) ? "成功" : "失败") << std::endl;
+}
+
+void demonstrate_stateless_verifier() {
+    std::cout << "\n=== 无状态验证器演示 ===" << std::endl;
+    
+    ESAAccumulator server(false);
+    std::vector<BigInt> elements;
+    for (int i = 1; i <= 20; i++) {
+        elements.push_back(BigInt(std::to_string(4000 + i)));
+    }
+    server.add_elements(elements);
+    
+    // 客户端只保存公开参数和服务端公布的批次状态，不复制集合
+    ESAVerifier client(server.get_group_order(), server.get_generator());
+    client.trust(1, server);
+    ZeroKnowledgeProof proof = server.generate_membership_proof(elements[0]);
+    std::cout << "批次1成员证明验证: " << (client.verify_membership(proof, elements[0], 1) ? "成功" : "失败") << std::endl;
+    MembershipProofBundle bundle = server.generate_membership_proofs(elements);
+    std::cout << "证明包验证: " << (client.verify_membership_bundle(bundle, elements) ? "成功" : "失败") << std::endl;
+    
+    server.add_element(BigInt("5000"));
+    client.trust(2, server);
+    std::cout << "旧证明在批次2下验证: " << (client.verify_membership(proof, elements[0], 2) ? "成功" : "失败") << std::endl;
+}
+
+#ifdef __linux__
+void demonstrate_storage_node() {
+    std::cout << "\n=== 存储节点演示 ===" << std::endl;
+    
+    // 在回环地址上启动存储节点，端口由系统分配
+    SNServer server(2);
+    if (!server.start("127.0.0.1", 0)) {
+        std::cout << "存储节点启动失败" << std::endl;
+        return;
+    }
+    SNClient client;
+    if (!client.connect("127.0.0.1", server.port())) {
+        std::cout << "连接存储节点失败" << std::endl;
+        return;
+    }
+    
+    // 流水线发送多个插入请求，再按到达顺序取回响应
+    client.send_insert("apple", "doc1");
+    client.send_insert("banana", "doc2");
+    client.send_insert("cherry", "doc3");
+    SNClient::Response response;
+    for (int i = 0; i < 3 && client.receive(response); i++) {
+        std::cout << "请求 " << response.request_id << " 插入 " << response.update.key
+                  << (response.update.success ? " 成功" : " 失败") << std::endl;
+    }
+    
+    // 流水线请求的处理顺序不定，用一次同步插入的根摘要作为可信根
+    AccTrie::UpdateResult last = client.insert("date", "doc4");
+    AccTrie::QueryResult absent = client.query("blueberry");
+    std::cout << "查询blueberry: " << (absent.exists ? "存在" : "不存在") << ", 不存在证明验证: "
+              << (AccTrie::verify_absence(absent, last.root) ? "成功" : "失败") << std::endl;
+    server.stop();
+}
+#endif
+
 int main() {
     std::cout << "=== ESA累加器功能演示 ===" << std::endl;
     
@@ -116,6 +321,14 @@ int main() {
         demonstrate_witness_system();
         demonstrate_complement_operations();
         demonstrate_element_update();
+        demonstrate_streaming_set_operations();
+        demonstrate_acc_trie();
+        demonstrate_sharded_accumulator();
+        demonstrate_trapdoor_manager();
+        demonstrate_stateless_verifier();
+#ifdef __linux__
+        demonstrate_storage_node();
+#endif
         
         std::cout << "\n=== 所有功能演示完成 ===" << std::endl;
         
@@ -0,0 +1,184 @@
+#ifndef ACC_TRIE_H
+#define ACC_TRIE_H
+
+#include "esa_accumulator.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 叶子节点：完整键、值集合、累加器值、前后向指针
+// 累加器中除了各个值的元素外，还包含一个指向前序叶子键的链接元素，
+// 因此相邻关系本身也被累加器承诺，可用于不存在证明（keyp/keyn）
+struct AccTrieLeaf {
+    std::string key;
+    std::vector<std::string> values;
+    ESAAccumulator acc;
+    AccTrieLeaf* prev;
+    AccTrieLeaf* next;
+
+    AccTrieLeaf(const std::string& key, const BigInt& group_order, const GroupElement& generator)
+        : key(key), acc(group_order, generator, false), prev(nullptr), next(nullptr) {}
+};
+
+// 累加器前缀树
+// 内部节点采用ART风格的自适应节点（4/16/48/256个孩子）并做路径压缩，
+// 叶子按键的字典序串成双向链表
+// 内部节点携带孩子摘要的哈希（Merkle化），根摘要承诺所有叶子的累加器值；
+// 更新只把路径上的节点标记为脏，计算根摘要时才重新哈希脏路径
+class AccTrie {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    // 插入/删除结果，对应 InsertKVResponse / DeleteKVResponse
+    struct UpdateResult {
+        bool success = false;
+        std::string keyp;           // 前序叶子的key
+        std::string key;
+        std::string keyn;           // 后序叶子的key
+        GroupElement ln_acc;        // 当前key对应叶子的累加器值
+        GroupElement old_lnn_acc;   // 后序叶子的旧累加器值
+        GroupElement new_lnn_acc;   // 后序叶子的新累加器值
+        Digest root{};              // 更新后的根摘要
+    };
+
+    // 路径证明中的一层内部节点，position为路径经过的孩子下标，-1表示经过终止叶子
+    struct PathStep {
+        std::string prefix;
+        bool has_terminal = false;
+        Digest terminal{};
+        std::vector<std::pair<uint8_t, Digest>> children;
+        int position = -1;
+    };
+
+    // 叶子累加器值到根摘要的路径证明，steps从根到叶子排列；key为空表示整棵树为空
+    struct PathProof {
+        bool valid = false;
+        std::string key;
+        GroupElement ln_acc;
+        GroupElement ln_universal;  // 叶子的通用累加器值，在 RSAGroup::rsa2048() 中
+        std::vector<PathStep> steps;
+        GroupElement end_acc;       // 尾部哨兵的累加器值，同样由根摘要承诺
+        GroupElement end_universal;
+    };
+
+    // 单关键词查询结果，对应 SKQSNResponse
+    struct QueryResult {
+        bool exists = false;
+        std::string keyword;
+        std::vector<std::string> values;
+        GroupElement ln_acc;        // 存在证明：当前key对应叶子的累加器值
+        std::string keyp;           // 不存在证明：前序叶子的key
+        std::string keyn;           // 不存在证明：后序叶子的key
+        GroupElement lnn_acc;       // 不存在证明：后序叶子的累加器值
+        GroupElement link_witness;  // 不存在证明：keyp链接元素在后序叶子通用累加器中的聚合见证
+        PathProof keyp_path;        // 不存在证明：前序叶子的路径证明，keyp为空时无效
+        PathProof keyn_path;        // 不存在证明：后序叶子的路径证明，keyn为空时为 prove_end()
+    };
+
+    // 范围/前缀查询结果中的一个叶子
+    struct RangeEntry {
+        std::string key;
+        std::vector<std::string> values;
+        GroupElement ln_acc;
+        PathProof path;             // 叶子到根摘要的路径证明
+    };
+
+    // 范围/前缀查询结果：沿叶子链表顺序收集的连续叶子以及左右边界证明
+    // 第一个叶子承诺keyp，后一个叶子承诺前一个叶子，右邻居承诺最后一个叶子，
+    // 所有叶子和两个边界都带路径证明，因此验证者可以对照可信根确认结果中间没有遗漏的关键词
+    struct RangeResult {
+        std::vector<RangeEntry> entries;
+        std::string keyp;           // 左邻居：范围之前的最后一个key，空表示链表头
+        std::string keyn;           // 右邻居：范围之后的第一个key，空表示尾部哨兵
+        GroupElement lnn_acc;       // 右邻居的累加器值
+        GroupElement link_witness;  // 最后一个叶子（或keyp）的链接元素在右邻居通用累加器中的聚合见证
+        PathProof keyp_path;        // keyp为空时无效
+        PathProof keyn_path;        // keyn为空时为 prove_end()
+    };
+
+    // 节点统计
+    struct Stats {
+        size_t leaves = 0;
+        size_t node4 = 0;
+        size_t node16 = 0;
+        size_t node48 = 0;
+        size_t node256 = 0;
+        size_t inner_bytes = 0;     // 内部节点占用的字节数
+    };
+
+    AccTrie();
+    AccTrie(const BigInt& group_order, const GroupElement& generator);
+    ~AccTrie();
+
+    AccTrie(const AccTrie&) = delete;
+    AccTrie& operator=(const AccTrie&) = delete;
+
+    // 基本操作
+    UpdateResult insert(const std::string& key, const std::string& value);
+    UpdateResult remove(const std::string& key, const std::string& value);
+    QueryResult query(const std::string& key);
+    RangeResult range_query(const std::string& lo, const std::string& hi);  // lo <= key <= hi
+    RangeResult prefix_query(const std::string& prefix);
+
+    // 批量插入：所有结构修改完成后统一重新哈希，公共路径前缀只哈希一次
+    // 每个结果中的root都是整批插入之后的根摘要
+    std::vector<UpdateResult> insert_batch(const std::vector<std::pair<std::string, std::string>>& entries);
+
+    // 认证结构
+    Digest root_digest();
+    PathProof prove_path(const std::string& key);
+    // 尾部哨兵的证明：树非空时为最后一个叶子的路径证明（其中带有哨兵的累加器值），空树时路径为空
+    PathProof prove_end();
+
+    // 有序访问
+    const AccTrieLeaf* find(const std::string& key) const;
+    const AccTrieLeaf* lower_bound(const std::string& key) const;  // 第一个 >= key 的叶子
+    const AccTrieLeaf* first_leaf() const { return head; }
+    const AccTrieLeaf* last_leaf() const { return tail; }
+
+    size_t size() const { return leaf_count; }
+    Stats stats() const;
+
+    const BigInt& get_group_order() const { return group_order; }
+    const GroupElement& get_generator() const { return generator; }
+
+    // 值与链接到累加器元素的映射（带域分离的完整SHA-256摘要）
+    static BigInt value_element(const std::string& value);
+    static BigInt link_element(const std::string& prev_key);
+    // 验证不存在证明：keyp < keyword < keyn，两个邻居都由可信根摘要承诺，且keyp的链接元素属于后序叶子
+    // keyp为空表示keyword之前没有叶子，keyn为空表示后序是链表尾部的哨兵累加器
+    static bool verify_absence(const QueryResult& result, const Digest& root);
+    // 验证范围/前缀查询的完整性：边界在范围之外，结果连续，每个叶子和两个边界都在可信根之下，
+    // 且每个叶子的通用累加器与其值和前序链接一致
+    static bool verify_range(const RangeResult& result, const std::string& lo, const std::string& hi,
+                             const Digest& root);
+    static bool verify_prefix(const RangeResult& result, const std::string& prefix, const Digest& root);
+    // 用O(深度)次哈希验证叶子累加器值属于根摘要
+    static bool verify_path(const PathProof& proof, const Digest& root);
+
+private:
+    using NodeRef = uintptr_t;  // 最低位为1表示叶子
+
+    BigInt group_order;
+    GroupElement generator;
+    NodeRef root;
+    AccTrieLeaf* head;
+    AccTrieLeaf* tail;
+    size_t leaf_count;
+    ESAAccumulator end_acc;  // 尾部哨兵，累加最后一个叶子的链接元素
+
+    AccTrieLeaf* find_leaf(const std::string& key) const;
+    AccTrieLeaf* lower_bound_leaf(const std::string& key) const;
+    ESAAccumulator& successor_acc(AccTrieLeaf* successor) { return successor ? successor->acc : end_acc; }
+    void link_leaf(AccTrieLeaf* leaf, AccTrieLeaf* successor, UpdateResult& result);
+    void unlink_leaf(AccTrieLeaf* leaf, UpdateResult& result);
+    void mark_path(const std::string& key);
+    UpdateResult insert_unhashed(const std::string& key, const std::string& value);
+    template<typename InRange>
+    RangeResult scan_from(AccTrieLeaf* leaf, InRange in_range);
+    static bool verify_chain(const RangeResult& result, const Digest& root);
+};
+
+#endif // ACC_TRIE_H
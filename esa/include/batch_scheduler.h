@@ -0,0 +1,87 @@
+#ifndef BATCH_SCHEDULER_H
+#define BATCH_SCHEDULER_H
+
+#include "esa_accumulator.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 请求合并调度器
+// 并发提交的插入/删除/查询请求在一个可配置的时间窗口内被收集成微批次：
+// 整个批次的更新合并为一次累加器更新，批次中的查询在更新之后的同一个快照上回答，
+// 结果通过future返回给各个调用者。
+// 每个插入/删除的结果与按提交顺序逐个执行时一致；批次中的查询看到的是整个批次应用之后的状态
+class BatchScheduler {
+public:
+    struct Config {
+        size_t max_batch_size = 256;                          // 达到该数量立即处理
+        std::chrono::microseconds max_delay{500};             // 第一个请求最多等待的时间
+    };
+
+    // 查询结果，proof为成员或非成员关系证明
+    struct QueryResult {
+        bool member = false;
+        uint64_t epoch = 0;              // 回答该查询的快照所在批次编号
+        GroupElement accumulator;        // 快照的累加器值
+        ZeroKnowledgeProof proof{ProofType::MEMBERSHIP};
+    };
+
+    struct Stats {
+        uint64_t batches = 0;
+        uint64_t requests = 0;
+        uint64_t max_batch = 0;
+        uint64_t coalesced = 0;          // 在批次内相互抵消、没有改动累加器的更新个数
+    };
+
+    // 调度器运行期间，累加器只能通过调度器访问
+    explicit BatchScheduler(ESAAccumulator& accumulator);
+    BatchScheduler(ESAAccumulator& accumulator, const Config& config);
+    ~BatchScheduler();
+
+    BatchScheduler(const BatchScheduler&) = delete;
+    BatchScheduler& operator=(const BatchScheduler&) = delete;
+
+    std::future<bool> submit_insert(const BigInt& element);
+    std::future<bool> submit_remove(const BigInt& element);
+    std::future<QueryResult> submit_query(const BigInt& element);
+
+    // 处理完已提交的请求后停止，之后提交的请求立即返回失败
+    void stop();
+    Stats stats() const;
+
+private:
+    enum class Kind {
+        INSERT,
+        REMOVE,
+        QUERY
+    };
+
+    struct Request {
+        Kind kind;
+        BigInt element;
+        std::promise<bool> update_result;
+        std::promise<QueryResult> query_result;
+        std::chrono::steady_clock::time_point arrival;   // 入队时间，批次窗口从队首请求算起
+    };
+
+    ESAAccumulator& accumulator;
+    Config config;
+
+    mutable std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::vector<Request> queue;
+    bool stopping;
+    uint64_t epoch;
+    Stats counters;
+    std::thread dispatcher;
+
+    void enqueue(Request request);
+    void dispatch_loop();
+    void apply_batch(std::vector<Request>& batch);
+};
+
+#endif // BATCH_SCHEDULER_H
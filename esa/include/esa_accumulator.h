@@ -7,8 +7,82 @@
 #include <string>
 #include <random>
 #include <chrono>
+#include <memory>
 #include <openssl/sha.h>
 #include <openssl/evp.h>
+#include <openssl/bn.h>
+
+// 大整数临时对象池（按请求作用域）
+// 作用域内构造的BigInt从池中取BIGNUM，析构时归还池中而不是BN_free，
+// 最外层作用域结束时一次性释放多余的BIGNUM；池与BN_CTX均为线程私有，无锁
+class BigIntArena {
+public:
+    struct Stats {
+        size_t bn_allocated = 0;   // 实际调用BN_new的次数
+        size_t bn_reused = 0;      // 从池中复用的次数
+        size_t bn_freed = 0;       // 实际调用BN_free的次数
+    };
+
+    explicit BigIntArena(size_t retain_limit = 256);
+    ~BigIntArena();
+
+    BigIntArena(const BigIntArena&) = delete;
+    BigIntArena& operator=(const BigIntArena&) = delete;
+
+    BIGNUM* acquire();
+    void release(BIGNUM* bn);
+    BN_CTX* ctx();
+
+    // 释放池中超出保留上限的BIGNUM
+    void trim();
+    // 释放池中全部BIGNUM
+    void reset();
+
+    const Stats& stats() const { return counters; }
+    size_t pooled() const { return free_list.size(); }
+
+    // 当前线程的活动池（没有作用域时为nullptr）
+    static BigIntArena* current();
+
+    // RAII作用域：将池设为当前线程的活动池，嵌套作用域沿用外层池
+    class Scope {
+    public:
+        Scope();                             // 使用线程私有的默认池
+        explicit Scope(BigIntArena& arena);  // 使用调用方提供的池
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        BigIntArena* previous;
+        BigIntArena* active;
+        bool outermost;
+    };
+
+    // 运算用的BN_CTX：有活动池时借用池的ctx，否则临时创建
+    class CtxGuard {
+    public:
+        CtxGuard();
+        ~CtxGuard();
+
+        CtxGuard(const CtxGuard&) = delete;
+        CtxGuard& operator=(const CtxGuard&) = delete;
+
+        BN_CTX* get() const { return ctx; }
+        operator BN_CTX*() const { return ctx; }
+
+    private:
+        BN_CTX* ctx;
+        bool owned;
+    };
+
+private:
+    std::vector<BIGNUM*> free_list;
+    BN_CTX* bn_ctx;
+    size_t retain_limit;
+    Stats counters;
+};
 
 // 大整数类型
 class BigInt {
@@ -52,6 +126,8 @@ public:
     size_t bit_length() const;
     bool is_zero() const;
     bool is_one() const;
+    bool fits_u64() const;
+    uint64_t to_u64() const;  // 仅当fits_u64()时有意义
     
     // 获取内部BIGNUM指针（用于OpenSSL函数）
     BIGNUM* get_bn() const { return value; }
@@ -69,6 +145,7 @@ public:
     static BigInt random_range(const BigInt& min, const BigInt& max);
     static BigInt from_hex(const std::string& hex);
     static BigInt from_bytes(const std::vector<uint8_t>& bytes);
+    static BigInt from_u64(uint64_t word);
     std::vector<uint8_t> to_bytes() const;
 };
 
@@ -91,6 +168,7 @@ public:
     // 群运算
     GroupElement operator*(const GroupElement& other) const;
     GroupElement operator^(const BigInt& exponent) const; // 模幂运算
+    GroupElement pow_secret(const BigInt& exponent) const; // 常数时间模幂，指数为秘密值时使用
     GroupElement inverse() const;
     
     // 比较运算
@@ -108,6 +186,43 @@ public:
     static GroupElement identity(const BigInt& modulus);
 };
 
+// 未知阶群参数
+// 通用累加器 U = g^u、基于Bezout系数的非成员关系见证、聚合见证和Wesolowski证明
+// 都要求群的阶不公开：阶已知时任何人都能对任意元素开 x 次根。这里使用RSA模数 N = p·q
+// 的乘法群，基取 4 = 2²，落在二次剩余子群中。
+// -1 的阶为2且任何人都知道，Q^ℓ 与 (-Q)^ℓ 只差一个符号，会让证明对 ±result 同时成立。
+// 因此元素取 QR_N^+ 中的规范代表 |x| = min(x, N-x)，x 与 -x 视为同一个元素：
+// contains() 只接受规范代表，产生群元素的一方先用 canonical() 规范化，验证时比较规范代表。
+// 默认参数是RSA-2048分解挑战的模数，其分解没有人知道，不需要可信设置；
+// generate() 在本地生成模数并可返回陷门 φ(N)，生成方能伪造任意见证，只能用于可信的管理节点
+class RSAGroup {
+private:
+    BigInt modulus;
+    GroupElement base;
+    
+public:
+    RSAGroup() = default;   // 无效参数
+    RSAGroup(const BigInt& modulus, const BigInt& base);
+    
+    // 模数至少1024位且为奇数，基在 (1, N) 中且与 N 互素
+    bool valid() const;
+    // element 属于这个群：模数相同、值非零且是规范代表（值小于 N-值）
+    bool contains(const GroupElement& element) const;
+    // 规范代表 |x| = min(x, N-x)，模数不同的元素原样返回
+    GroupElement canonical(const GroupElement& element) const;
+    
+    const BigInt& get_modulus() const { return modulus; }
+    const GroupElement& get_base() const { return base; }
+    
+    bool operator==(const RSAGroup& other) const { return modulus == other.modulus && base == other.base; }
+    bool operator!=(const RSAGroup& other) const { return !(*this == other); }
+    
+    // 本地生成两个 bits/2 位素数的乘积；trapdoor非空时返回 φ(N) = (p-1)(q-1)，p、q 不保留
+    static RSAGroup generate(size_t bits, BigInt* trapdoor = nullptr);
+    // RSA-2048分解挑战模数，基为4，进程内共享
+    static const RSAGroup& rsa2048();
+};
+
 // 证明类型枚举
 enum class ProofType {
     MEMBERSHIP,      // 成员关系证明
@@ -118,6 +233,35 @@ enum class ProofType {
     COMPLEMENT       // 补集证明
 };
 
+// Fiat-Shamir 证明记录
+// 按 标签 || 长度 || 大端字节 的格式流式吸收数据到增量哈希上下文，直接挤出挑战值，
+// 不经过十进制字符串转换
+class Transcript {
+public:
+    enum class Hash {
+        SHA256,
+        SHA3_256
+    };
+
+    explicit Transcript(const char* domain, Hash hash = Hash::SHA256);
+    Transcript(const Transcript& other);
+    Transcript& operator=(const Transcript& other);
+    ~Transcript();
+
+    // 吸收数据
+    void append_message(const char* label, const uint8_t* data, size_t length);
+    void append_u64(const char* label, uint64_t value);
+    void append_bigint(const char* label, const BigInt& value);
+    void append_group_element(const char* label, const GroupElement& element);
+
+    // 挤出挑战值（结果同时被吸收，后续挑战依赖之前的全部输出）
+    void challenge_bytes(const char* label, uint8_t out[32]);
+    BigInt challenge(const char* label, const BigInt& modulus);
+
+private:
+    EVP_MD_CTX* ctx;
+};
+
 // 零知识证明结构
 class ZeroKnowledgeProof {
 private:
@@ -152,31 +296,284 @@ public:
     // 序列化
     std::string serialize() const;
     static ZeroKnowledgeProof deserialize(const std::string& data);
+    
+    // 二进制序列化：版本、类型、有效性，之后依次为模数、承诺、挑战、响应和辅助数据，
+    // 每个大整数编码为4字节大端长度加大端字节。不包含证明者的随机数
+    void serialize_binary(std::vector<uint8_t>& out) const;  // 追加到out末尾
+    static ZeroKnowledgeProof deserialize_binary(const uint8_t* data, size_t length);  // 格式错误时返回无效证明
 };
 
+// Wesolowski 指数运算证明
+// PoE：证明 base^x = result，x = ∏factors 以因子列表给出。挑战 ℓ 是由 Fiat-Shamir 种子派生的128位素数，
+// 证明为 Q = base^(x div ℓ)；验证 Q^ℓ · base^(x mod ℓ) = result，只有两次与ℓ等长的模幂，
+// x mod ℓ 由各因子逐个约简得到，验证代价与x的位数无关。
+// PoKE：不公开x，证明者附带 z = g^x 和 r = x mod ℓ（g 为群的基），另取挑战α，
+// Q = (base·g^α)^(x div ℓ)，验证 Q^ℓ · (base·g^α)^r = result · z^α
+// 两者的可靠性依赖群的阶未知（阶已知时可直接算出 Q = (result·base^-(x mod ℓ))^(ℓ^-1)，
+// 验证方也能把x约简后自己检查），因此只接受RSAGroup，所有群元素都必须属于该群
+class ExponentiationProof {
+public:
+    enum class Kind : uint8_t {
+        POE = 1,
+        POKE = 2
+    };
+    
+    ExponentiationProof() : kind(Kind::POE), is_valid(false) {}
+    
+    static ExponentiationProof prove(const RSAGroup& group, const GroupElement& base,
+                                     const std::vector<BigInt>& factors, const GroupElement& result);
+    static bool verify(const RSAGroup& group, const GroupElement& base, const std::vector<BigInt>& factors,
+                       const GroupElement& result, const ExponentiationProof& proof);
+    
+    static ExponentiationProof prove_knowledge(const RSAGroup& group, const GroupElement& base,
+                                               const BigInt& exponent, const GroupElement& result);
+    static bool verify_knowledge(const RSAGroup& group, const GroupElement& base,
+                                 const GroupElement& result, const ExponentiationProof& proof);
+    
+    Kind get_kind() const { return kind; }
+    const GroupElement& get_quotient() const { return quotient; }
+    const GroupElement& get_exponent_commitment() const { return exponent_commitment; }  // 仅PoKE
+    const BigInt& get_remainder() const { return remainder; }                            // 仅PoKE
+    bool valid() const { return is_valid; }
+    
+    // 二进制序列化：版本、种类、有效性，之后依次为模数、Q、z、r，编码与ZeroKnowledgeProof相同
+    void serialize_binary(std::vector<uint8_t>& out) const;
+    static ExponentiationProof deserialize_binary(const uint8_t* data, size_t length);
+    
+private:
+    Kind kind;
+    GroupElement quotient;
+    GroupElement exponent_commitment;
+    BigInt remainder;
+    bool is_valid;
+};
+
+// 集合操作证明
+// 集合摘要 D(X) = h^(∏ prime(x)) 与通用累加器同构（本累加器集合的摘要就是U），在未知阶群中绑定整个集合。
+// 操作数摘要由验证方从可信渠道取得，证明中不携带；r = ∏ prime(R) 由验证方从收到的结果集合计算。
+// - 交集 R = O_1 ∩ ... ∩ O_k：W_i = D(O_i \ R) 满足 W_i^r = D(O_i)（PoE），Σ c_i·w_i = 1 说明
+//   各剩余部分没有公共元素：E_i = W_i^|c_i|（PoKE），∏_{c_i>0} E_i = h·∏_{c_i<0} E_i
+// - 差集/补集 R = S \ T：W = D(S \ R) 满足 W^r = D(S)（PoE）和 W^f = D(T)（PoKE，S \ R ⊆ T）；
+//   α·r - β·t = 1 说明 R 与 T 不相交：E = D(T)^β（PoKE），A^r = h·E（PoE）
+// - 并集 R = S ∪ T：按升序给结果中每个元素标注属于S、T或两者，h^(∏标注S的素数) = D(S)（PoE），T同理
+// 可靠性依赖强RSA假设和素数代表两两不同；验证代价与结果大小成正比，与操作数大小无关
+class SetOperationProof {
+public:
+    SetOperationProof() : type(ProofType::UNION), is_valid(false) {}
+    explicit SetOperationProof(ProofType t) : type(t), is_valid(false) {}
+    
+    ProofType get_type() const { return type; }
+    const std::vector<GroupElement>& get_witnesses() const { return witnesses; }
+    const std::vector<GroupElement>& get_terms() const { return terms; }
+    const std::vector<int8_t>& get_signs() const { return signs; }
+    const std::vector<uint8_t>& get_labels() const { return labels; }
+    const std::vector<ExponentiationProof>& get_subproofs() const { return subproofs; }
+    bool valid() const { return is_valid; }
+    
+private:
+    friend class ESAAccumulator;
+    
+    ProofType type;
+    std::vector<GroupElement> witnesses;          // 交集的 W_i，差集的 W
+    std::vector<GroupElement> terms;              // 交集的 E_i（c_i = 0 时为无效元素），差集的 E、A
+    std::vector<int8_t> signs;                    // 交集 c_i 的符号
+    std::vector<uint8_t> labels;                  // 并集：位0表示属于S，位1表示属于T
+    std::vector<ExponentiationProof> subproofs;   // 按上面的顺序排列的PoE/PoKE
+    bool is_valid;
+};
+
+// 成员关系证明包
+// 同一累加器值下一批元素的成员关系证明。Fiat-Shamir转录以 (域, 累加器值) 为共同前缀，
+// 各证明从前缀的摘要中间状态复制后只吸收自己的承诺和元素；挑战由验证方重算，包中不携带。
+// 二进制编码为版本、有效性、模数、累加器值和证明个数，之后每个证明的承诺和响应按模数字节宽定长排列
+class MembershipProofBundle {
+public:
+    MembershipProofBundle() : is_valid(false) {}
+    
+    size_t size() const { return commitments.size(); }
+    const GroupElement& get_accumulator() const { return accumulator; }
+    const std::vector<GroupElement>& get_commitments() const { return commitments; }
+    const std::vector<BigInt>& get_responses() const { return responses; }
+    bool valid() const { return is_valid; }
+    
+    void serialize_binary(std::vector<uint8_t>& out) const;
+    static MembershipProofBundle deserialize_binary(const uint8_t* data, size_t length);
+    
+private:
+    friend class ESAAccumulator;
+    
+    GroupElement accumulator;
+    std::vector<GroupElement> commitments;
+    std::vector<BigInt> responses;
+    bool is_valid;
+};
+
+// 有序列式元素集合
+// 元素以升序去重的uint64_t列连续存储，供归并式集合运算按顺序扫描
+class SortedElementSet {
+private:
+    std::vector<uint64_t> ids;
+    
+public:
+    SortedElementSet() = default;
+    explicit SortedElementSet(std::vector<uint64_t> unsorted_ids);
+    
+    // 从哈希集合构建；有元素超过64位时返回false
+    static bool from_set(const std::unordered_set<BigInt, BigInt::Hash>& set, SortedElementSet& out);
+    void to_set(std::unordered_set<BigInt, BigInt::Hash>& out) const;
+    
+    bool insert(uint64_t id);
+    bool erase(uint64_t id);
+    bool contains(uint64_t id) const;
+    void clear() { ids.clear(); }
+    
+    size_t size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+    const uint64_t* data() const { return ids.data(); }
+    std::vector<uint64_t>::const_iterator begin() const { return ids.begin(); }
+    std::vector<uint64_t>::const_iterator end() const { return ids.end(); }
+    const std::vector<uint64_t>& column() const { return ids; }
+};
+
+// 有序集合的流式归并运算
+// 结果按升序逐个写入调用方提供的输出迭代器，不构造完整结果集合，返回写出的元素个数
+namespace SortedSetOps {
+    template <typename OutputIt>
+    size_t merge_union(const SortedElementSet& a, const SortedElementSet& b, OutputIt out) {
+        const uint64_t* x = a.data();
+        const uint64_t* x_end = x + a.size();
+        const uint64_t* y = b.data();
+        const uint64_t* y_end = y + b.size();
+        size_t count = 0;
+        while (x != x_end && y != y_end) {
+            if (*x < *y) {
+                *out++ = *x++;
+            } else if (*y < *x) {
+                *out++ = *y++;
+            } else {
+                *out++ = *x++;
+                y++;
+            }
+            count++;
+        }
+        for (; x != x_end; ++x, ++count) {
+            *out++ = *x;
+        }
+        for (; y != y_end; ++y, ++count) {
+            *out++ = *y;
+        }
+        return count;
+    }
+    
+    template <typename OutputIt>
+    size_t merge_intersection(const SortedElementSet& a, const SortedElementSet& b, OutputIt out) {
+        const uint64_t* x = a.data();
+        const uint64_t* x_end = x + a.size();
+        const uint64_t* y = b.data();
+        const uint64_t* y_end = y + b.size();
+        size_t count = 0;
+        while (x != x_end && y != y_end) {
+            if (*x < *y) {
+                x++;
+            } else if (*y < *x) {
+                y++;
+            } else {
+                *out++ = *x++;
+                y++;
+                count++;
+            }
+        }
+        return count;
+    }
+    
+    // a - b
+    template <typename OutputIt>
+    size_t merge_difference(const SortedElementSet& a, const SortedElementSet& b, OutputIt out) {
+        const uint64_t* x = a.data();
+        const uint64_t* x_end = x + a.size();
+        const uint64_t* y = b.data();
+        const uint64_t* y_end = y + b.size();
+        size_t count = 0;
+        while (x != x_end && y != y_end) {
+            if (*x < *y) {
+                *out++ = *x++;
+                count++;
+            } else if (*y < *x) {
+                y++;
+            } else {
+                x++;
+                y++;
+            }
+        }
+        for (; x != x_end; ++x, ++count) {
+            *out++ = *x;
+        }
+        return count;
+    }
+    
+    // 多路交集：按大小升序处理操作数，以最小集合的元素为候选，
+    // 在其余集合中做指数（galloping）搜索，末端块内用SIMD比较；
+    // 代价由最小集合的大小决定。结果按升序追加到out，返回结果个数
+    size_t intersect_k(std::vector<const SortedElementSet*> operands, std::vector<uint64_t>& out);
+    
+    // 在有序数组data[pos, n)中查找第一个 >= target 的位置
+    size_t gallop_lower_bound(const uint64_t* data, size_t n, size_t pos, uint64_t target);
+}
+
 // 集合操作结果
 struct SetOperationResult {
     std::unordered_set<BigInt, BigInt::Hash> result_set;
-    ZeroKnowledgeProof proof;
+    SetOperationProof proof;
     bool is_valid;
     
-    SetOperationResult() : proof(ProofType::UNION), is_valid(false) {}
+    SetOperationResult() : is_valid(false) {}
 };
 
+class FixedBaseTable;
+class NoncePool;
+
 // ESA累加器主类
+// 通用累加器的维护和依赖u的生成操作是虚函数，由持有RSA群陷门的ESAAccumulatorManager替换；
+// 成员保持私有，子类只通过受保护的钩子改变U的维护方式
 class ESAAccumulator {
 private:
     // 群参数
     GroupElement generator;
-    GroupElement accumulator_value;
+    mutable GroupElement accumulator_value;
     BigInt group_order;
+    BigInt exponent_order;  // 生成元所在乘法群的阶 p-1，指数在其下约简
+    
+    // 群的阶已知，累加器状态保存在指数域：更新只做一次模加，
+    // accumulator_value = g^accumulator_exponent 在读取时用固定底数表惰性计算
+    BigInt accumulator_exponent;   // Σx mod exponent_order
+    mutable bool accumulator_stale;
+    mutable std::shared_ptr<const FixedBaseTable> generator_table;
     
     // 当前集合
     std::unordered_set<BigInt, BigInt::Hash> current_set;
     
-    // 辅助数据结构
-    std::unordered_map<BigInt, GroupElement, BigInt::Hash> element_commitments;
-    std::mt19937_64 rng;
+    // 有序列式视图（惰性重建），wide_elements为超过64位、无法放入列中的元素个数
+    mutable SortedElementSet sorted_set;
+    mutable size_t wide_elements;
+    mutable bool sorted_dirty;
+    
+    // 通用累加器 U = h^u 在未知阶的RSA群中（h 为 universal_group 的基），u 为所有元素素数代表之积，
+    // 指数不约简，用于基于Bezout系数的非成员关系见证和聚合见证。u 由素数代表上的增量乘积树维护：
+    // 每个元素占一个叶子槽位，删除时叶子置1并回收槽位，变化的路径和 U 在使用时惰性重算
+    // 新增元素先进入pending_inserts，到读取U或u时才求素数代表并放入叶子
+    mutable std::unordered_map<BigInt, size_t, BigInt::Hash> prime_slots;
+    mutable std::vector<size_t> free_slots;
+    mutable std::unordered_set<BigInt, BigInt::Hash> pending_inserts;
+    mutable std::vector<std::vector<BigInt>> prime_tree;   // prime_tree[0]为叶子，最后一层为根
+    mutable std::vector<size_t> dirty_slots;
+    RSAGroup universal_group;
+    mutable GroupElement universal_value;
+    mutable std::vector<BigInt> pending_primes;   // U有效时之后新增的素数，使用时一次乘方
+    mutable bool universal_dirty;                 // 有删除，U需要由u重新计算
+    
+    bool verbose;
+    bool constant_time;   // 随机数等秘密指数走常数时间模幂
+    std::shared_ptr<NoncePool> nonce_pool;   // 预计算的 (r, g^r)，为空时现场计算
     
     // 内部方法
     GroupElement hash_to_group(const BigInt& input);
@@ -184,10 +581,62 @@ private:
     GroupElement compute_commitment(const BigInt& element);
     bool verify_commitment(const GroupElement& commitment, const BigInt& element);
     
+    // Fiat-Shamir 挑战: c = H(domain || C || A [|| element]) mod group_order
+    BigInt element_challenge(const char* domain, const GroupElement& commitment, const BigInt& element) const;
+    // 成员关系证明的校验指数 (s - c·element) mod exponent_order，有效证明满足 g^e = C
+    BigInt membership_exponent(const ZeroKnowledgeProof& proof, const BigInt& element) const;
+    BigInt membership_exponent(const BigInt& challenge, const BigInt& response, const BigInt& element) const;
+    // 证明包的转录前缀：域和累加器值
+    Transcript bundle_transcript(const GroupElement& accumulator) const;
+    // 随机线性组合检查全部 g^(e_i) = C_i，阶为2的分量用Jacobi符号逐项检查
+    bool verify_commitment_exponents(const std::vector<GroupElement>& commitments,
+                                     const std::vector<BigInt>& exponents, size_t threads) const;
+    // g^exponent，指数先约简到exponent_order再查固定底数表
+    GroupElement generator_pow(const BigInt& exponent) const;
+    const FixedBaseTable& generator_pow_table() const;
+    // 秘密指数的 g^exponent：constant_time 打开时不查固定底数表，改用常数时间模幂
+    GroupElement generator_pow_secret(const BigInt& exponent) const;
+    // 证明随机数 r 及承诺 g^r，设置了nonce_pool时从池中取
+    void next_nonce(BigInt& r, GroupElement& commitment);
+    
+    // 通用累加器维护
+    BigInt prime_representative(const BigInt& element) const;
+    void reset_prime_tree();
+    void flush_universal() const;
+    void place_prime(const BigInt& element, const BigInt& prime) const;
+    const BigInt& universal_exponent() const;
+    BigInt prime_product(const std::vector<BigInt>& elements) const;
+    
+    // 集合操作证明，见 SetOperationProof；结果集合按升序排列后求素数代表
+    std::vector<BigInt> sorted_primes(const std::unordered_set<BigInt, BigInt::Hash>& set) const;
+    // remainders[i] 为第i个操作数去掉结果后的元素，第0个操作数是当前集合
+    void prove_intersection(SetOperationResult& result, const std::vector<std::vector<BigInt>>& remainders);
+    void prove_difference(SetOperationResult& result, ProofType type,
+                          const std::unordered_set<BigInt, BigInt::Hash>& other_set,
+                          const std::unordered_set<BigInt, BigInt::Hash>& common);
+    bool verify_intersection(const SetOperationProof& proof, const std::vector<BigInt>& result_primes,
+                             const std::vector<GroupElement>& other_digests) const;
+    bool verify_difference(const SetOperationProof& proof, const std::vector<BigInt>& result_primes,
+                           const GroupElement& other_digest) const;
+    
+protected:
+    // 集合变化时维护U：默认放入素数代表乘积树，U在读取时惰性重算
+    virtual void universal_insert(const BigInt& element);
+    virtual void universal_erase(const BigInt& element);
+    // 当前集合对应的U
+    virtual const GroupElement& current_universal() const;
+    // 更换通用累加器所在的未知阶群，U在下次读取时由u重新计算
+    void set_universal_group(const RSAGroup& group);
+    
 public:
     // 构造函数
-    ESAAccumulator();
-    ~ESAAccumulator() = default;
+    explicit ESAAccumulator(bool verbose = true);
+    // 复用已有的群参数，不再生成安全素数（大量累加器共享同一个群时使用）
+    ESAAccumulator(const BigInt& group_order, const GroupElement& generator, bool verbose = true);
+    // 通用累加器使用指定的未知阶群（默认为 RSAGroup::rsa2048()）
+    ESAAccumulator(const BigInt& group_order, const GroupElement& generator, const RSAGroup& universal_group,
+                   bool verbose = true);
+    virtual ~ESAAccumulator() = default;
     
     // 基本操作
     bool add_element(const BigInt& element);
@@ -195,13 +644,41 @@ public:
     bool update_element(const BigInt& old_element, const BigInt& new_element);
     bool contains(const BigInt& element) const;
     
+    // 批量操作：累加器值只更新一次，返回实际添加/移除的元素个数
+    size_t add_elements(const std::vector<BigInt>& elements);
+    size_t remove_elements(const std::vector<BigInt>& elements);
+    // 批量更新并用PoE证明通用累加器的变化：添加时 U_old^(∏x) = U_new，删除时 U_new^(∏x) = U_old。
+    // applied 返回实际生效的元素，与更新前后的U和证明一起交给验证方
+    size_t add_elements(const std::vector<BigInt>& elements, std::vector<BigInt>& applied, ExponentiationProof& proof);
+    size_t remove_elements(const std::vector<BigInt>& elements, std::vector<BigInt>& applied, ExponentiationProof& proof);
+    // 验证方只需重算生效元素的素数代表，不需要与批量大小成正比的模幂；
+    // group 为验证方信任的通用累加器参数，previous、current 不在该群中时拒绝
+    static bool verify_batch_update(const RSAGroup& group, const GroupElement& previous, const GroupElement& current,
+                                    const std::vector<BigInt>& applied, bool is_addition,
+                                    const ExponentiationProof& proof);
+    
     // 零知识证明生成
     ZeroKnowledgeProof generate_membership_proof(const BigInt& element);
     ZeroKnowledgeProof generate_non_membership_proof(const BigInt& element);
+    // 一批元素的成员关系证明包：共享转录前缀只序列化和哈希一次，随机数整批抽取，
+    // 承诺、挑战和响应分段交给threads个线程计算。有元素不在集合中时返回无效证明包
+    MembershipProofBundle generate_membership_proofs(const std::vector<BigInt>& elements, size_t threads = 1);
+    // 非成员关系见证 (a, d)：a·u ≡ 1 (mod x)，d = h^((a·u-1)/x)，验证 0 < a < x 且 U^a = d^x·h。
+    // 群的阶未知，伪造需要对 U^a·h^-1 开 x 次根（强RSA假设）。
+    // 证明中response为a，commitment为d，auxiliary_data[0]为生成时的U
+    // 批量生成时在所有查询元素的素数代表上建乘积树，沿余数树向下分发 u mod X 和 h^floor(u/X)，
+    // 整批只需一次与u等长的模幂
+    virtual std::vector<ZeroKnowledgeProof> generate_non_membership_proofs(const std::vector<BigInt>& elements);
     
     // 见证生成和更新
     BigInt generate_witness(const BigInt& element);
     bool update_witness(BigInt& witness, const BigInt& element, bool is_addition);
+    // 子集K的聚合成员关系见证 W = h^(u/∏x_K)，x为素数代表，验证 W^(∏x_K) = U 只需一次模幂。
+    // 见证大小与|K|无关；K中有元素不在集合中时返回无效群元素
+    virtual GroupElement generate_aggregate_witness(const std::vector<BigInt>& elements);
+    // Shamir技巧：由不相交子集K1、K2各自的聚合见证得到K1∪K2的见证，子集相交时返回无效群元素
+    GroupElement combine_aggregate_witnesses(const GroupElement& witness1, const std::vector<BigInt>& elements1,
+                                             const GroupElement& witness2, const std::vector<BigInt>& elements2) const;
     
     // 集合操作
     SetOperationResult compute_union(const std::unordered_set<BigInt, BigInt::Hash>& other_set);
@@ -209,22 +686,71 @@ public:
     SetOperationResult compute_difference(const std::unordered_set<BigInt, BigInt::Hash>& other_set);
     SetOperationResult compute_complement(const std::unordered_set<BigInt, BigInt::Hash>& other_set);
     
+    // 多关键词合取查询：当前集合与多个有序集合求交，整个查询只生成一个聚合证明
+    SetOperationResult compute_multi_intersection(const std::vector<const SortedElementSet*>& other_sets);
+    
+    // 流式集合操作（基于有序列式视图，结果写入输出迭代器，返回结果个数）
+    template <typename OutputIt>
+    size_t stream_union(const SortedElementSet& other_set, OutputIt out) const {
+        return SortedSetOps::merge_union(get_sorted_set(), other_set, out);
+    }
+    template <typename OutputIt>
+    size_t stream_intersection(const SortedElementSet& other_set, OutputIt out) const {
+        return SortedSetOps::merge_intersection(get_sorted_set(), other_set, out);
+    }
+    template <typename OutputIt>
+    size_t stream_difference(const SortedElementSet& other_set, OutputIt out) const {
+        return SortedSetOps::merge_difference(get_sorted_set(), other_set, out);
+    }
+    
     // 证明验证
     bool verify_membership_proof(const ZeroKnowledgeProof& proof, const BigInt& element);
+    // 随机线性组合批量验证：全部有效时返回true，任一无效时以压倒性概率返回false
+    // （不指出是哪一个，调用方可退回逐个验证）；承诺的乘积用一次多重幂计算
+    bool verify_membership_proofs(const std::vector<ZeroKnowledgeProof>& proofs, const std::vector<BigInt>& elements,
+                                  size_t threads = 1);
+    // 证明包的累加器值必须是当前值，承诺用与verify_membership_proofs相同的随机线性组合一次检查
+    bool verify_membership_bundle(const MembershipProofBundle& bundle, const std::vector<BigInt>& elements,
+                                  size_t threads = 1);
     bool verify_non_membership_proof(const ZeroKnowledgeProof& proof, const BigInt& element);
-    bool verify_set_operation_proof(const SetOperationResult& result);
-    bool verify_complement_proof(const ZeroKnowledgeProof& proof, const std::unordered_set<BigInt, BigInt::Hash>& other_set);
+    // other_digests 为除本累加器外各操作数的可信摘要 D(X)，按计算时的顺序给出；
+    // 本累加器一侧的摘要取当前的U
+    bool verify_set_operation_proof(const SetOperationResult& result, const std::vector<GroupElement>& other_digests);
+    // 另一个操作数以明文给出，由它计算摘要
+    bool verify_complement_proof(const SetOperationResult& result,
+                                 const std::unordered_set<BigInt, BigInt::Hash>& other_set);
     
     // 见证验证
     bool verify_witness(const BigInt& witness, const BigInt& element);
+    bool verify_aggregate_witness(const GroupElement& witness, const std::vector<BigInt>& elements) const;
+    
+    // 集合摘要 D(X) = h^(∏ prime(x))，与通用累加器值同构，可作为其他关键词集合的可信承诺
+    GroupElement compute_set_digest(const std::unordered_set<BigInt, BigInt::Hash>& set) const;
+    GroupElement compute_set_digest(const SortedElementSet& set) const;
     
     // 获取器
     const std::unordered_set<BigInt, BigInt::Hash>& get_current_set() const { return current_set; }
-    GroupElement get_accumulator_value() const { return accumulator_value; }
+    const GroupElement& get_accumulator_value() const;
+    const GroupElement& get_universal_value() const;
+    const RSAGroup& get_universal_group() const { return universal_group; }
+    const BigInt& get_group_order() const { return group_order; }
+    const GroupElement& get_generator() const { return generator; }
     size_t size() const { return current_set.size(); }
+    const SortedElementSet& get_sorted_set() const;
+    // 立即完成所有惰性状态（累加器值、通用累加器、有序视图），例如在写入突发结束后、并发只读之前调用
+    void flush() const;
+    bool sorted_set_complete() const { get_sorted_set(); return wide_elements == 0; }
     
     // 调试和测试
     void print_state() const;
+    void set_verbose(bool enabled) { verbose = enabled; }
+    // 证明生成中秘密相关的模幂是否使用常数时间实现（默认打开），验证始终走可变时间的快速路径
+    void set_constant_time(bool enabled) { constant_time = enabled; }
+    bool constant_time_enabled() const { return constant_time; }
+    bool verbose_enabled() const { return verbose; }
+    // 证明随机数改从预计算池中取，池的生成元和指数阶必须与本累加器相同；传入空指针恢复现场计算
+    bool set_nonce_pool(std::shared_ptr<NoncePool> pool);
+    const std::shared_ptr<NoncePool>& get_nonce_pool() const { return nonce_pool; }
 };
 
 // 密码学工具函数
@@ -233,6 +759,10 @@ namespace CryptoUtils {
     BigInt sha256(const BigInt& input);
     BigInt sha3_256(const BigInt& input);
     BigInt hash_to_group(const BigInt& input, const BigInt& modulus);
+    // 把元素确定性地映射为256位素数：计数器模式SHA-256候选，取第一个素数
+    BigInt hash_to_prime(const BigInt& input);
+    // 两两相乘求积，使每次乘法两边规模接近；空列表的积为1
+    BigInt balanced_product(std::vector<BigInt> factors);
     
     // 素数相关
     bool is_prime(const BigInt& n, int rounds = 40);
@@ -243,8 +773,19 @@ namespace CryptoUtils {
     // 模运算
     BigInt mod_inverse(const BigInt& a, const BigInt& m);
     BigInt mod_pow(const BigInt& base, const BigInt& exp, const BigInt& mod);
+    // 常数时间模幂：指数带BN_FLG_CONSTTIME，奇模数走OpenSSL固定窗口Montgomery实现，
+    // 预计算表按缓存行交错存放，访存模式与指数无关；偶模数没有常数时间实现，退回mod_pow
+    BigInt mod_pow_secret(const BigInt& base, const BigInt& exp, const BigInt& mod);
     BigInt mod_sqrt(const BigInt& a, const BigInt& p);
-    
+    // 多重幂 ∏ bases[i]^exponents[i] mod modulus，负指数按底数的逆元计算；
+    // 少量项用Straus交错窗口，大量项用Pippenger桶方法，threads>1时按项分段并行。
+    // 模数为0或负指数对应的底数不可逆时返回0
+    BigInt multi_exp(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents,
+                     const BigInt& modulus, size_t threads = 1);
+    // 群元素版本，所有底数须在同一个群中，否则（或底数不可逆时）返回无效元素
+    GroupElement multi_exp(const std::vector<GroupElement>& bases, const std::vector<BigInt>& exponents,
+                           size_t threads = 1);
+
     // 随机数生成
     BigInt random_bits(size_t bits);
     BigInt random_range(const BigInt& min, const BigInt& max);
@@ -0,0 +1,69 @@
+#ifndef ESA_C_API_H
+#define ESA_C_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * ESA累加器的C接口（供Go节点通过cgo调用）
+ *
+ * 所有缓冲区都由调用方分配和释放，接口内部不会保留指向它们的指针。
+ * 批量数据采用长度前缀的扁平格式：每一项为4字节大端长度加内容，项与项直接相连。
+ *   - 元素项：元素的大端无符号字节（长度0表示0）
+ *   - 证明项：ZeroKnowledgeProof::serialize_binary 的输出
+ * 输出缓冲区不足时返回 ESA_ERR_BUFFER_TOO_SMALL，并通过 out_len 返回所需的字节数，
+ * 调用方扩容后重试即可。一次调用处理一整批数据，以摊薄cgo的调用开销。
+ * 接口内部的C++异常（内存不足等）不会越过C边界，统一返回 ESA_ERR_INTERNAL。
+ * 同一个句柄可以在多个线程（goroutine）间共享：每个调用在句柄的互斥锁内执行，
+ * 对同一句柄的调用相互串行，不同句柄之间可以并行。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esa_accumulator esa_accumulator;
+
+enum {
+    ESA_OK = 0,
+    ESA_ERR_ARGUMENT = -1,          /* 空指针等非法参数 */
+    ESA_ERR_FORMAT = -2,            /* 输入缓冲区格式错误 */
+    ESA_ERR_BUFFER_TOO_SMALL = -3,  /* 输出缓冲区不足，out_len 为所需大小 */
+    ESA_ERR_INTERNAL = -4           /* 内部错误（内存不足等） */
+};
+
+/* 创建与销毁 */
+esa_accumulator* esa_accumulator_new(void);
+/* 使用已有的群参数（大端字节），多个累加器共享同一个群时使用；
+ * 群阶小于3或生成元不在 [1, 群阶) 中时返回NULL */
+esa_accumulator* esa_accumulator_new_with_params(const uint8_t* group_order, size_t group_order_len,
+                                                 const uint8_t* generator, size_t generator_len);
+void esa_accumulator_free(esa_accumulator* acc);
+
+/* 状态查询 */
+size_t esa_accumulator_size(const esa_accumulator* acc);
+/* 输出两项：群阶、生成元 */
+int esa_accumulator_params(const esa_accumulator* acc, uint8_t* out, size_t out_cap, size_t* out_len);
+/* 输出累加器值的大端字节（不带长度前缀） */
+int esa_accumulator_value(const esa_accumulator* acc, uint8_t* out, size_t out_cap, size_t* out_len);
+
+/* 批量更新，count 返回实际添加/移除的元素个数 */
+int esa_add_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len, size_t* count);
+int esa_remove_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len, size_t* count);
+
+/* 批量生成成员关系证明，每个元素对应一个证明项（元素不在集合中时为无效证明）。
+ * 返回 ESA_ERR_BUFFER_TOO_SMALL 时生成的证明会保留下来，之后以相同的元素重试且累加器未变时
+ * 直接复制，不再重新生成；因此也可以先传 out = NULL 查询所需大小 */
+int esa_prove_membership_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len,
+                               uint8_t* out, size_t out_cap, size_t* out_len);
+
+/* 批量验证成员关系证明，results[i] 为1表示第i个证明有效，count 返回证明个数 */
+int esa_verify_membership_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len,
+                                const uint8_t* proofs, size_t proofs_len,
+                                uint8_t* results, size_t results_cap, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESA_C_API_H */
@@ -0,0 +1,56 @@
+#ifndef ESA_MANAGER_H
+#define ESA_MANAGER_H
+
+#include "esa_accumulator.h"
+#include <memory>
+#include <vector>
+
+// 持有陷门的管理节点累加器
+// 陷门是通用累加器所在RSA群的 φ(N)：u 以 u mod φ(N) 维护，删除元素就是乘以 x^-1，
+// 单个或聚合成员见证是 U^(∏x^-1)，非成员关系见证直接开 x 次根，
+// 都只需常数次模运算和一次模幂，与集合大小无关。不持有陷门的一方在这个群中开根等价于强RSA问题。
+// 生成的见证和证明与 ESAAccumulator 的格式相同，由使用同一个RSA群、不持有陷门的
+// ESAAccumulator 或 ESAVerifier 验证。持有陷门即可伪造任意见证，只能部署在可信的管理节点上
+class ESAAccumulatorManager : public ESAAccumulator {
+public:
+    // 新生成 Z_p 群参数和 kModulusBits 位的RSA模数，模数的分解只保留为陷门
+    explicit ESAAccumulatorManager(bool verbose = true);
+    // 复用已有的 Z_p 群参数，新生成RSA模数
+    ESAAccumulatorManager(const BigInt& group_order, const GroupElement& generator, bool verbose = true);
+    // 使用可信设置给出的RSA群和 φ(N)；陷门不满足 h^φ(N) = 1 时不启用陷门，退回公开路径
+    ESAAccumulatorManager(const BigInt& group_order, const GroupElement& generator, const RSAGroup& universal_group,
+                          const BigInt& trapdoor, bool verbose = true);
+
+    static const size_t kModulusBits = 2048;
+
+    bool has_trapdoor() const { return !trapdoor.is_zero(); }
+
+    // 单个元素在U中的成员见证 W = U^(x^-1)，满足 W^x = U；元素不在集合中时返回无效群元素
+    GroupElement generate_universal_witness(const BigInt& element);
+    GroupElement generate_aggregate_witness(const std::vector<BigInt>& elements) override;
+    // a = 1，d = (U·h^-1)^(x^-1)，满足 U^a = d^x·h
+    std::vector<ZeroKnowledgeProof> generate_non_membership_proofs(const std::vector<BigInt>& elements) override;
+
+protected:
+    void universal_insert(const BigInt& element) override;
+    void universal_erase(const BigInt& element) override;
+    const GroupElement& current_universal() const override;
+
+private:
+    BigInt trapdoor;                                                // φ(N)，未启用时为0
+    mutable BigInt trapdoor_exponent;                               // u mod φ(N)，pending_inserts中的元素尚未乘入
+    mutable std::unordered_set<BigInt, BigInt::Hash> pending_inserts;
+    mutable GroupElement trapdoor_value;                            // h^trapdoor_exponent
+    mutable bool trapdoor_stale;
+
+    // 校验并启用陷门
+    void install_trapdoor(const BigInt& candidate);
+    // x^-1 mod φ(N)，不可逆（x 整除 φ(N)，概率可忽略）时返回0
+    BigInt exponent_inverse(const BigInt& prime) const;
+    void rebuild_trapdoor_exponent();
+    void flush_pending() const;
+    // h^exponent，指数由陷门导出，constant_time 打开时走常数时间模幂
+    GroupElement base_pow(const BigInt& exponent) const;
+};
+
+#endif // ESA_MANAGER_H
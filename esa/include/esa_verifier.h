@@ -0,0 +1,72 @@
+#ifndef ESA_VERIFIER_H
+#define ESA_VERIFIER_H
+
+#include "esa_accumulator.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 无状态验证器
+// 只持有公开参数 (p, g)、通用累加器所在的未知阶群、生成元的固定底数表和最近若干个可信累加器值，不保存集合，
+// 内存占用与集合大小无关。累加器值由调用方从可信渠道（签名的批次公告、调度器的快照等）
+// 按批次编号登记，证明必须对应某个已登记的批次才能通过。
+// 验证方法都是const的，可在多个线程中同时调用；登记新批次与验证之间由内部互斥锁保护
+class ESAVerifier {
+public:
+    // 登记的可信状态；universal只在验证非成员关系证明和聚合见证时需要
+    struct Epoch {
+        uint64_t epoch = 0;
+        GroupElement accumulator;
+        GroupElement universal;
+    };
+
+    // 通用累加器默认在 RSAGroup::rsa2048() 中，与 ESAAccumulator 的默认值相同
+    ESAVerifier(const BigInt& group_order, const GroupElement& generator, size_t cache_capacity = 8);
+    ESAVerifier(const BigInt& group_order, const GroupElement& generator, const RSAGroup& universal_group,
+                size_t cache_capacity = 8);
+
+    ESAVerifier(const ESAVerifier&) = delete;
+    ESAVerifier& operator=(const ESAVerifier&) = delete;
+
+    // 登记批次，已有相同编号时覆盖；超过容量时淘汰编号最小的批次。
+    // universal 不在本验证器的未知阶群中时按未提供处理
+    void trust(uint64_t epoch, const GroupElement& accumulator, const GroupElement& universal = GroupElement());
+    // 登记累加器当前的值
+    void trust(uint64_t epoch, const ESAAccumulator& accumulator);
+    bool lookup(uint64_t epoch, Epoch& out) const;
+    bool latest(Epoch& out) const;
+    size_t cached_epochs() const;
+
+    bool verify_membership(const ZeroKnowledgeProof& proof, const BigInt& element, uint64_t epoch) const;
+    // 挑战的重算和 g^e = C 的检查分给threads个线程，任一无效时返回false
+    bool verify_membership_batch(const std::vector<ZeroKnowledgeProof>& proofs, const std::vector<BigInt>& elements,
+                                 uint64_t epoch, size_t threads = 1) const;
+    // 证明包自带累加器值，必须与某个已登记批次的值相同
+    bool verify_membership_bundle(const MembershipProofBundle& bundle, const std::vector<BigInt>& elements,
+                                  size_t threads = 1) const;
+    bool verify_non_membership(const ZeroKnowledgeProof& proof, const BigInt& element, uint64_t epoch) const;
+    bool verify_aggregate_witness(const GroupElement& witness, const std::vector<BigInt>& elements,
+                                  uint64_t epoch) const;
+
+    const BigInt& get_group_order() const { return group_order; }
+    const GroupElement& get_generator() const { return generator; }
+    const RSAGroup& get_universal_group() const { return universal_group; }
+
+private:
+    BigInt group_order;
+    BigInt exponent_order;
+    GroupElement generator;
+    RSAGroup universal_group;
+    std::shared_ptr<const FixedBaseTable> generator_table;
+    size_t capacity;
+
+    mutable std::mutex cache_mutex;
+    std::vector<Epoch> epochs;   // 按编号升序
+
+    bool find_accumulator(const GroupElement& accumulator) const;
+    // 由挑战和响应得到校验指数 (s - c·x) mod (p-1)，有效证明满足 g^e = C
+    BigInt membership_exponent(const BigInt& challenge, const BigInt& response, const BigInt& element) const;
+};
+
+#endif // ESA_VERIFIER_H
@@ -0,0 +1,36 @@
+#ifndef FIXED_BASE_TABLE_H
+#define FIXED_BASE_TABLE_H
+
+#include "esa_accumulator.h"
+#include <memory>
+#include <vector>
+
+// 固定底数幂表
+// 预计算 g^(d·2^(w·j))（j为窗口序号，1 <= d < 2^w），求 g^e 时每个非零窗口只做一次
+// Montgomery乘法，不需要平方。建表后只读，可在线程之间共享
+class FixedBaseTable {
+public:
+    FixedBaseTable(const GroupElement& base, size_t exponent_bits, int window = 4);
+    ~FixedBaseTable();
+
+    FixedBaseTable(const FixedBaseTable&) = delete;
+    FixedBaseTable& operator=(const FixedBaseTable&) = delete;
+
+    // 指数超过建表位数或模数为偶数时退回普通模幂
+    GroupElement pow(const BigInt& exponent) const;
+
+    const GroupElement& get_base() const { return base; }
+    size_t exponent_bits() const { return bits; }
+
+    // 进程内按 (模数, 底数, 位数) 共享的表，同一组群参数的累加器只建一次表
+    static std::shared_ptr<const FixedBaseTable> shared(const GroupElement& base, size_t exponent_bits);
+
+private:
+    GroupElement base;
+    size_t bits;
+    int window;
+    BN_MONT_CTX* mont;
+    std::vector<BigInt> table;   // table[j·(2^w-1) + d-1] = g^(d·2^(w·j))，Montgomery形式
+};
+
+#endif // FIXED_BASE_TABLE_H
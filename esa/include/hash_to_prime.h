@@ -0,0 +1,59 @@
+#ifndef HASH_TO_PRIME_H
+#define HASH_TO_PRIME_H
+
+#include "esa_accumulator.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 哈希到素数引擎
+// 候选值由计数器模式的 SHA-256("esa-h2p" || 元素 || 计数器) 产生，每个摘要是一个256位候选，
+// 固定最高位和最低位后先经过模30030的轮筛和小素数试除，剩下的交给 BN_check_prime。
+// 素数代表有约2^246种取值，生日界远超实际集合规模，累加器和集合摘要的绑定性不受代表碰撞影响。
+// 元素到素数的映射放在LRU缓存中，热点关键字不再重复搜索。所有方法都是线程安全的
+class HashToPrimeEngine {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t candidates = 0;     // 产生的候选个数
+        uint64_t sieved = 0;         // 被轮筛和试除排除的候选
+        uint64_t prime_tests = 0;    // 进入素性检验的候选
+    };
+
+    explicit HashToPrimeEngine(size_t cache_capacity = 1 << 16);
+
+    HashToPrimeEngine(const HashToPrimeEngine&) = delete;
+    HashToPrimeEngine& operator=(const HashToPrimeEngine&) = delete;
+
+    // 元素的256位素数代表，结果只由元素决定，与缓存状态无关
+    BigInt prime_for(const BigInt& element);
+
+    Stats stats() const;
+    size_t cache_size() const;
+    void clear_cache();
+
+    // 进程内共享的实例，CryptoUtils::hash_to_prime 使用它
+    static HashToPrimeEngine& shared();
+
+    // 64位整数的确定性素性判定：小素数试除、以2为底的强伪素数检验和强Lucas检验。
+    // 只是 CryptoUtils::is_prime 对小整数的快速路径，素数代表不走这里
+    static bool baillie_psw(uint64_t n);
+
+private:
+    using Entry = std::pair<std::string, std::string>;  // 元素字节 -> 素数的大端字节
+
+    size_t capacity;
+    mutable std::mutex cache_mutex;
+    std::list<Entry> lru;                                          // 表头为最近使用
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    Stats counters;
+
+    static std::string search(const std::string& element_bytes, Stats& local);
+};
+
+#endif // HASH_TO_PRIME_H
@@ -0,0 +1,76 @@
+#ifndef NONCE_POOL_H
+#define NONCE_POOL_H
+
+#include "esa_accumulator.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 证明随机数预计算池（离线/在线拆分）
+// Schnorr式证明的承诺 C = g^r 与待证明的内容无关，可以提前算好：后台低优先级线程维护一个
+// (r, g^r) 队列，队列低于低水位时补充到容量上限。证明生成时直接取一对，在线部分只剩挑战哈希
+// 和一次模乘加。队列取空时在调用线程现场计算并计入exhausted。
+// 每个随机数只会被取出一次；池可以由同一组群参数的多个累加器共享
+class NoncePool {
+public:
+    struct Config {
+        size_t capacity = 1024;       // 队列上限
+        size_t low_watermark = 256;   // 低于该深度时唤醒后台线程
+        size_t batch_size = 64;       // 后台线程每次加锁入队的个数
+        bool constant_time = true;    // g^r 使用常数时间模幂，关闭时查固定底数表
+    };
+
+    struct Nonce {
+        BigInt r;
+        GroupElement commitment;   // g^r
+    };
+
+    struct Stats {
+        size_t depth = 0;          // 当前可用的预计算对数
+        size_t capacity = 0;
+        uint64_t produced = 0;     // 入队的预计算对数（后台线程和prefill）
+        uint64_t served = 0;       // 从队列直接取走的个数
+        uint64_t exhausted = 0;    // 队列为空、在调用线程现场计算的次数
+        uint64_t refills = 0;      // 后台线程被唤醒补充的次数
+    };
+
+    // r 在 [1, exponent_order) 中均匀选取
+    NoncePool(const GroupElement& generator, const BigInt& exponent_order);
+    NoncePool(const GroupElement& generator, const BigInt& exponent_order, const Config& config);
+    ~NoncePool();
+
+    NoncePool(const NoncePool&) = delete;
+    NoncePool& operator=(const NoncePool&) = delete;
+
+    Nonce take();
+    // 在调用线程中把队列填满，例如服务启动后接收请求之前
+    void prefill();
+    // 停止后台线程，之后take全部现场计算
+    void stop();
+
+    const GroupElement& get_generator() const { return generator; }
+    const BigInt& get_exponent_order() const { return exponent_order; }
+    Stats stats() const;
+
+private:
+    GroupElement generator;
+    BigInt exponent_order;
+    Config config;
+    std::shared_ptr<const FixedBaseTable> table;
+
+    mutable std::mutex queue_mutex;
+    std::condition_variable refill_needed;
+    std::deque<Nonce> queue;
+    bool stopping;
+    Stats counters;
+    std::thread worker;
+
+    std::vector<Nonce> compute(size_t count) const;
+    void refill_loop();
+};
+
+#endif // NONCE_POOL_H
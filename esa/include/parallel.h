@@ -0,0 +1,40 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// 线程扇出
+// 库内的并行路径共用：调用线程自己承担第0份工作，其余交给临时线程，返回前全部汇合。
+// 工作线程不继承调用线程的 BigIntArena 作用域，需要时由 fn 自己打开
+namespace Parallel {
+
+// 在workers个线程上执行 fn(worker)，worker从0开始，0号在调用线程中执行
+template <typename Fn>
+void run(size_t workers, Fn fn) {
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < workers; t++) {
+        pool.emplace_back([&fn, t]() { fn(t); });
+    }
+    fn(size_t(0));
+    for (auto& worker : pool) {
+        worker.join();
+    }
+}
+
+// 把 [0, n) 分成至多threads段连续区间，执行 fn(worker, begin, end)，区间可能为空
+template <typename Fn>
+void ranges(size_t n, size_t threads, Fn fn) {
+    size_t workers = std::max<size_t>(1, std::min(threads, n));
+    size_t chunk = (n + workers - 1) / workers;
+    run(workers, [&fn, n, chunk](size_t worker) {
+        size_t begin = std::min(n, worker * chunk);
+        fn(worker, begin, std::min(n, begin + chunk));
+    });
+}
+
+} // namespace Parallel
+
+#endif // PARALLEL_H
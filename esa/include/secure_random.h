@@ -0,0 +1,62 @@
+#ifndef SECURE_RANDOM_H
+#define SECURE_RANDOM_H
+
+#include "esa_accumulator.h"
+#include <cstdint>
+#include <vector>
+
+// 线程私有的缓冲CSPRNG
+// 用RAND_bytes取得的32字节密钥驱动ChaCha20，一次生成一整块密钥流放入缓冲，取数只是拷贝，
+// 不再每次进入OpenSSL全局DRBG的锁。每次补充缓冲时取密钥流的前32字节作为新密钥（快速密钥擦除），
+// 已经用过的输出无法由当前状态倒推；进程fork后或累计输出达到上限时重新从RAND_bytes播种。
+// 区间内的均匀标量用拒绝采样得到，没有取模偏差。
+// RAND_bytes或ChaCha20失败时清除密钥和缓冲并抛出std::runtime_error，绝不用未播种的密钥输出
+class SecureRandom {
+public:
+    struct Stats {
+        uint64_t refills = 0;     // 补充缓冲的次数
+        uint64_t reseeds = 0;     // 从RAND_bytes重新播种的次数
+        uint64_t rejections = 0;  // 拒绝采样丢弃的候选
+    };
+
+    ~SecureRandom();
+
+    SecureRandom(const SecureRandom&) = delete;
+    SecureRandom& operator=(const SecureRandom&) = delete;
+
+    // 当前线程的实例
+    static SecureRandom& local();
+
+    void fill(uint8_t* out, size_t length);
+    uint64_t next_u64();
+    // [min, max) 中的均匀随机数，max <= min 时返回min
+    BigInt uniform(const BigInt& min, const BigInt& max);
+    // 一次取count个 [min, max) 中的均匀随机数（例如一批证明的随机数），只计算一次区间参数
+    std::vector<BigInt> uniform_batch(const BigInt& min, const BigInt& max, size_t count);
+    // 恰好bits位以内的随机数
+    BigInt random_bits(size_t bits);
+
+    // 立即丢弃当前密钥和缓冲，从RAND_bytes重新播种，失败时抛出std::runtime_error
+    void reseed();
+
+    const Stats& stats() const { return counters; }
+
+private:
+    SecureRandom();
+
+    void refill();
+    // 清除密钥和缓冲，并强制下次取数前重新播种
+    void discard();
+    // 抽取一个 [0, range) 中的值到out，range_bits/range_bytes/top_mask 由调用方预先算好
+    void sample_below(const BigInt& range, size_t range_bytes, uint8_t top_mask, BigInt& out);
+
+    EVP_CIPHER_CTX* cipher;
+    uint8_t key[32];
+    std::vector<uint8_t> buffer;
+    size_t position;
+    uint64_t output_since_seed;
+    uint64_t seeded_generation;   // 播种时的fork代数
+    Stats counters;
+};
+
+#endif // SECURE_RANDOM_H
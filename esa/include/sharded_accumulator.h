@@ -0,0 +1,75 @@
+#ifndef SHARDED_ACCUMULATOR_H
+#define SHARDED_ACCUMULATOR_H
+
+#include "esa_accumulator.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// 分片累加器
+// 元素通过带虚拟节点的一致性哈希环分配到N个ESAAccumulator（对应不同的存储节点），
+// 所有分片共享同一组群参数。批量更新按分片拆分后并行执行，
+// 顶层承诺聚合各分片的累加器值
+class ShardedAccumulator {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    // 顶层承诺
+    struct Commitment {
+        Digest digest{};            // SHA-256 transcript(分片数, 各分片编号与累加器值)
+        GroupElement product;       // 各分片累加器值之积，等于全体元素的累加器值
+    };
+
+    explicit ShardedAccumulator(size_t shard_count, size_t virtual_nodes = 64, bool verbose = false);
+    ShardedAccumulator(const BigInt& group_order, const GroupElement& generator,
+                       size_t shard_count, size_t virtual_nodes = 64, bool verbose = false);
+
+    ShardedAccumulator(const ShardedAccumulator&) = delete;
+    ShardedAccumulator& operator=(const ShardedAccumulator&) = delete;
+
+    // 单元素操作，路由到所属分片
+    bool add_element(const BigInt& element);
+    bool remove_element(const BigInt& element);
+    bool contains(const BigInt& element) const;
+
+    // 批量操作：按分片拆分，每个分片一次批量更新，分片之间并行
+    size_t add_elements(const std::vector<BigInt>& elements);
+    size_t remove_elements(const std::vector<BigInt>& elements);
+
+    // 扩容：加入一个新分片，只迁移哈希环上归属发生变化的元素，返回迁移的元素个数
+    size_t add_shard();
+
+    // 路由与访问
+    size_t shard_for(const BigInt& element) const;
+    size_t shard_count() const { return shards.size(); }
+    ESAAccumulator& shard(size_t index) { return *shards[index]; }
+    const ESAAccumulator& shard(size_t index) const { return *shards[index]; }
+    size_t size() const;
+
+    Commitment commitment() const;
+    // 根据各分片公开的累加器值重新计算顶层承诺
+    static Commitment aggregate(const std::vector<GroupElement>& shard_values);
+
+    const BigInt& get_group_order() const { return group_order; }
+    const GroupElement& get_generator() const { return generator; }
+    void set_worker_threads(size_t count) { worker_threads = count; }
+
+private:
+    BigInt group_order;
+    GroupElement generator;
+    std::vector<std::unique_ptr<ESAAccumulator>> shards;
+    std::vector<std::pair<uint64_t, uint32_t>> ring;  // (哈希点, 分片编号)，按哈希点排序
+    size_t virtual_nodes;
+    size_t worker_threads;
+    bool verbose;
+
+    void init_shards(size_t shard_count);
+    void add_ring_points(uint32_t shard_id);
+    std::vector<std::vector<BigInt>> partition(const std::vector<BigInt>& elements) const;
+    template<typename Op>
+    size_t run_parallel(const std::vector<std::vector<BigInt>>& parts, Op op);
+};
+
+#endif // SHARDED_ACCUMULATOR_H
@@ -0,0 +1,178 @@
+#ifndef SN_SERVER_H
+#define SN_SERVER_H
+
+#include "acc_trie.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 存储节点协议（对应 proto/ma_sn.proto 中的 SNMAService）
+// 帧格式：4字节大端长度 | 8字节大端请求编号 | 1字节方法 | 消息体
+// 长度不含自身，消息体中字符串和大整数都编码为4字节大端长度加内容。
+// 响应帧带回请求编号，同一连接上可以流水线发送多个请求，响应可能乱序到达
+namespace SNProtocol {
+    enum class Method : uint8_t {
+        INSERT_KV = 1,               // InsertKVToSN
+        DELETE_KV = 2,               // DeleteKVOnSN
+        SINGLE_KEYWORD_QUERY = 3,    // SingleKeywordQueryOnSN
+        GET_PARAMS = 4               // 获取群参数，客户端验证证明时使用
+    };
+
+    enum class Status : uint8_t {
+        OK = 0,
+        BAD_REQUEST = 1
+    };
+
+    const size_t kLengthSize = 4;
+    const size_t kHeaderSize = 9;                 // 请求编号 + 方法
+    const size_t kMaxFrameSize = 16 * 1024 * 1024;
+}
+
+// 存储节点服务器
+// 一个epoll事件循环线程负责所有连接的读写和分帧，完整的请求交给工作线程池处理，
+// 工作线程通过eventfd把响应交回事件循环。AccTrie的访问由一把互斥锁串行化。
+// 每个连接的在途请求数有上限，达到上限或输出积压过多时暂停读取该连接，缓冲区不会无限增长
+class SNServer {
+public:
+    struct Stats {
+        uint64_t connections = 0;
+        uint64_t requests = 0;
+        uint64_t bad_frames = 0;
+    };
+
+    explicit SNServer(size_t worker_count = 4);
+    SNServer(const BigInt& group_order, const GroupElement& generator, size_t worker_count = 4);
+    ~SNServer();
+
+    SNServer(const SNServer&) = delete;
+    SNServer& operator=(const SNServer&) = delete;
+
+    // 监听host:port（port为0时由系统分配），成功后后台线程开始服务；
+    // 套接字、epoll或eventfd任一步失败时释放已创建的描述符并返回false
+    bool start(const std::string& host, uint16_t port);
+    void stop();
+    bool running() const { return loop_running.load(); }
+    uint16_t port() const { return bound_port; }
+
+    AccTrie& get_trie() { return trie; }
+    Stats stats() const;
+    void set_verbose(bool enabled) { verbose = enabled; }
+
+private:
+    struct Connection {
+        int fd;
+        std::vector<uint8_t> input;
+        size_t input_offset = 0;
+        std::vector<uint8_t> output;
+        size_t output_offset = 0;
+        size_t in_flight = 0;     // 已交给工作线程、尚未取回响应的请求数
+        uint32_t events = 0;      // 当前在epoll中关注的事件
+    };
+
+    struct Task {
+        uint64_t connection_id;
+        uint64_t request_id;
+        uint8_t method;
+        std::vector<uint8_t> body;
+    };
+
+    struct Completion {
+        uint64_t connection_id;
+        std::vector<uint8_t> frame;
+    };
+
+    AccTrie trie;
+    std::mutex trie_mutex;
+    size_t worker_count;
+    bool verbose;
+
+    int listen_fd;
+    int epoll_fd;
+    int wake_fd;
+    uint16_t bound_port;
+    std::atomic<bool> loop_running;
+    std::thread loop_thread;
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t next_connection_id;
+
+    std::vector<std::thread> workers;
+    std::mutex task_mutex;
+    std::condition_variable task_ready;
+    std::deque<Task> tasks;
+    bool workers_stopping;
+
+    std::mutex completion_mutex;
+    std::vector<Completion> completions;
+
+    std::atomic<uint64_t> connection_count;
+    std::atomic<uint64_t> request_count;
+    std::atomic<uint64_t> bad_frame_count;
+
+    void event_loop();
+    void accept_connections();
+    void handle_readable(uint64_t connection_id);
+    void handle_writable(uint64_t connection_id);
+    // 分帧并派发不超过在途上限的请求，遇到非法帧时返回false
+    bool dispatch_frames(uint64_t connection_id, Connection& connection);
+    void drain_completions();
+    void close_connection(uint64_t connection_id);
+    bool flush_output(Connection& connection);
+    void update_interest(uint64_t connection_id, Connection& connection);
+
+    void worker_main();
+    std::vector<uint8_t> handle_request(const Task& task);
+};
+
+// 存储节点客户端（阻塞套接字）
+// send_* 只发送请求并返回请求编号，receive 按到达顺序读取响应，二者配合实现流水线；
+// insert/remove/query 为发送后立即等待响应的同步调用，只能在没有未取回响应时使用
+class SNClient {
+public:
+    struct Response {
+        uint64_t request_id = 0;
+        SNProtocol::Method method = SNProtocol::Method::GET_PARAMS;
+        SNProtocol::Status status = SNProtocol::Status::OK;
+        AccTrie::UpdateResult update;   // INSERT_KV / DELETE_KV
+        AccTrie::QueryResult query;     // SINGLE_KEYWORD_QUERY
+    };
+
+    SNClient();
+    ~SNClient();
+
+    SNClient(const SNClient&) = delete;
+    SNClient& operator=(const SNClient&) = delete;
+
+    // 连接后同步获取群参数
+    bool connect(const std::string& host, uint16_t port);
+    void close();
+
+    uint64_t send_insert(const std::string& key, const std::string& value);
+    uint64_t send_delete(const std::string& key, const std::string& value);
+    uint64_t send_query(const std::string& keyword);
+    bool receive(Response& response);
+
+    AccTrie::UpdateResult insert(const std::string& key, const std::string& value);
+    AccTrie::UpdateResult remove(const std::string& key, const std::string& value);
+    AccTrie::QueryResult query(const std::string& keyword);
+
+    const BigInt& get_group_order() const { return group_order; }
+    const GroupElement& get_generator() const { return generator; }
+
+private:
+    int fd;
+    uint64_t next_request_id;
+    BigInt group_order;
+    GroupElement generator;
+
+    uint64_t send_request(SNProtocol::Method method, const std::vector<uint8_t>& body);
+    bool read_exact(uint8_t* data, size_t length);
+};
+
+#endif // SN_SERVER_H
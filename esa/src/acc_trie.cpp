@@ -0,0 +1,1109 @@
+#include "acc_trie.h"
+#include <openssl/sha.h>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ART风格的自适应内部节点
+namespace {
+    using NodeRef = uintptr_t;
+
+    enum class NodeKind : uint8_t {
+        N4,
+        N16,
+        N48,
+        N256
+    };
+
+    struct Inner {
+        NodeKind kind;
+        uint16_t count;
+        std::string prefix;       // 路径压缩的公共前缀
+        AccTrieLeaf* terminal;    // 恰好在该节点结束的键
+        bool dirty;               // 子树有变化，digest需要重新计算
+        AccTrie::Digest digest;
+
+        explicit Inner(NodeKind k) : kind(k), count(0), terminal(nullptr), dirty(true), digest{} {}
+    };
+
+    // 键有序存放，顺序扫描
+    struct Node4 : Inner {
+        uint8_t keys[4];
+        NodeRef children[4];
+        Node4() : Inner(NodeKind::N4) {}
+    };
+
+    // 键有序存放，SSE2一次比较16个键
+    struct Node16 : Inner {
+        uint8_t keys[16];
+        NodeRef children[16];
+        Node16() : Inner(NodeKind::N16) {}
+    };
+
+    // 256项的字节索引指向48个孩子槽位，索引0表示空
+    struct Node48 : Inner {
+        uint8_t index[256];
+        NodeRef children[48];
+        Node48() : Inner(NodeKind::N48) {
+            std::memset(index, 0, sizeof(index));
+            std::memset(children, 0, sizeof(children));
+        }
+    };
+
+    struct Node256 : Inner {
+        NodeRef children[256];
+        Node256() : Inner(NodeKind::N256) {
+            std::memset(children, 0, sizeof(children));
+        }
+    };
+
+    bool is_leaf(NodeRef ref) { return (ref & 1) != 0; }
+    AccTrieLeaf* as_leaf(NodeRef ref) { return reinterpret_cast<AccTrieLeaf*>(ref & ~static_cast<uintptr_t>(1)); }
+    Inner* as_inner(NodeRef ref) { return reinterpret_cast<Inner*>(ref); }
+    NodeRef leaf_ref(AccTrieLeaf* leaf) { return reinterpret_cast<uintptr_t>(leaf) | 1; }
+    NodeRef inner_ref(Inner* node) { return reinterpret_cast<uintptr_t>(node); }
+
+    size_t node_bytes(const Inner* node) {
+        switch (node->kind) {
+            case NodeKind::N4: return sizeof(Node4) + node->prefix.capacity();
+            case NodeKind::N16: return sizeof(Node16) + node->prefix.capacity();
+            case NodeKind::N48: return sizeof(Node48) + node->prefix.capacity();
+            case NodeKind::N256: return sizeof(Node256) + node->prefix.capacity();
+        }
+        return 0;
+    }
+
+    void delete_node(Inner* node) {
+        switch (node->kind) {
+            case NodeKind::N4: delete static_cast<Node4*>(node); break;
+            case NodeKind::N16: delete static_cast<Node16*>(node); break;
+            case NodeKind::N48: delete static_cast<Node48*>(node); break;
+            case NodeKind::N256: delete static_cast<Node256*>(node); break;
+        }
+    }
+
+    NodeRef* find_child(Inner* node, uint8_t byte) {
+        switch (node->kind) {
+            case NodeKind::N4: {
+                Node4* n = static_cast<Node4*>(node);
+                for (uint16_t i = 0; i < n->count; i++) {
+                    if (n->keys[i] == byte) {
+                        return &n->children[i];
+                    }
+                }
+                return nullptr;
+            }
+            case NodeKind::N16: {
+                Node16* n = static_cast<Node16*>(node);
+#if defined(__SSE2__)
+                __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << n->count) - 1);
+                return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+                for (uint16_t i = 0; i < n->count; i++) {
+                    if (n->keys[i] == byte) {
+                        return &n->children[i];
+                    }
+                }
+                return nullptr;
+#endif
+            }
+            case NodeKind::N48: {
+                Node48* n = static_cast<Node48*>(node);
+                return n->index[byte] ? &n->children[n->index[byte] - 1] : nullptr;
+            }
+            case NodeKind::N256: {
+                Node256* n = static_cast<Node256*>(node);
+                return n->children[byte] ? &n->children[byte] : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    // 查找键字节 >= from 的第一个孩子
+    bool next_child(Inner* node, int from, uint8_t& byte, NodeRef& child) {
+        switch (node->kind) {
+            case NodeKind::N4:
+            case NodeKind::N16: {
+                const uint8_t* keys = node->kind == NodeKind::N4 ? static_cast<Node4*>(node)->keys
+                                                                 : static_cast<Node16*>(node)->keys;
+                const NodeRef* children = node->kind == NodeKind::N4 ? static_cast<Node4*>(node)->children
+                                                                     : static_cast<Node16*>(node)->children;
+                for (uint16_t i = 0; i < node->count; i++) {
+                    if (keys[i] >= from) {
+                        byte = keys[i];
+                        child = children[i];
+                        return true;
+                    }
+                }
+                return false;
+            }
+            case NodeKind::N48: {
+                Node48* n = static_cast<Node48*>(node);
+                for (int b = from; b < 256; b++) {
+                    if (n->index[b]) {
+                        byte = static_cast<uint8_t>(b);
+                        child = n->children[n->index[b] - 1];
+                        return true;
+                    }
+                }
+                return false;
+            }
+            case NodeKind::N256: {
+                Node256* n = static_cast<Node256*>(node);
+                for (int b = from; b < 256; b++) {
+                    if (n->children[b]) {
+                        byte = static_cast<uint8_t>(b);
+                        child = n->children[b];
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // 按键字节顺序收集全部孩子
+    std::vector<std::pair<uint8_t, NodeRef>> collect_children(Inner* node) {
+        std::vector<std::pair<uint8_t, NodeRef>> out;
+        uint8_t byte;
+        NodeRef child;
+        int from = 0;
+        while (from < 256 && next_child(node, from, byte, child)) {
+            out.emplace_back(byte, child);
+            from = byte + 1;
+        }
+        return out;
+    }
+
+    // 向未满的节点插入孩子
+    void put_child(Inner* node, uint8_t byte, NodeRef child) {
+        switch (node->kind) {
+            case NodeKind::N4:
+            case NodeKind::N16: {
+                uint8_t* keys = node->kind == NodeKind::N4 ? static_cast<Node4*>(node)->keys
+                                                           : static_cast<Node16*>(node)->keys;
+                NodeRef* children = node->kind == NodeKind::N4 ? static_cast<Node4*>(node)->children
+                                                               : static_cast<Node16*>(node)->children;
+                uint16_t pos = 0;
+                while (pos < node->count && keys[pos] < byte) {
+                    pos++;
+                }
+                std::memmove(keys + pos + 1, keys + pos, node->count - pos);
+                std::memmove(children + pos + 1, children + pos, (node->count - pos) * sizeof(NodeRef));
+                keys[pos] = byte;
+                children[pos] = child;
+                break;
+            }
+            case NodeKind::N48: {
+                Node48* n = static_cast<Node48*>(node);
+                uint8_t slot = 0;
+                while (n->children[slot]) {
+                    slot++;
+                }
+                n->children[slot] = child;
+                n->index[byte] = slot + 1;
+                break;
+            }
+            case NodeKind::N256:
+                static_cast<Node256*>(node)->children[byte] = child;
+                break;
+        }
+        node->count++;
+    }
+
+    size_t capacity(NodeKind kind) {
+        switch (kind) {
+            case NodeKind::N4: return 4;
+            case NodeKind::N16: return 16;
+            case NodeKind::N48: return 48;
+            case NodeKind::N256: return 256;
+        }
+        return 0;
+    }
+
+    Inner* make_node(NodeKind kind) {
+        switch (kind) {
+            case NodeKind::N4: return new Node4();
+            case NodeKind::N16: return new Node16();
+            case NodeKind::N48: return new Node48();
+            case NodeKind::N256: return new Node256();
+        }
+        return nullptr;
+    }
+
+    // 把节点转换为另一种容量的节点（增长或收缩），返回新节点并释放旧节点
+    Inner* convert_node(Inner* node, NodeKind kind) {
+        Inner* converted = make_node(kind);
+        converted->prefix = std::move(node->prefix);
+        converted->terminal = node->terminal;
+        for (const auto& entry : collect_children(node)) {
+            put_child(converted, entry.first, entry.second);
+        }
+        delete_node(node);
+        return converted;
+    }
+
+    void add_child(NodeRef& slot, uint8_t byte, NodeRef child) {
+        Inner* node = as_inner(slot);
+        if (node->count == capacity(node->kind)) {
+            NodeKind grown = node->kind == NodeKind::N4 ? NodeKind::N16
+                           : node->kind == NodeKind::N16 ? NodeKind::N48 : NodeKind::N256;
+            node = convert_node(node, grown);
+            slot = inner_ref(node);
+        }
+        put_child(node, byte, child);
+    }
+
+    void remove_child(NodeRef& slot, uint8_t byte) {
+        Inner* node = as_inner(slot);
+        switch (node->kind) {
+            case NodeKind::N4:
+            case NodeKind::N16: {
+                uint8_t* keys = node->kind == NodeKind::N4 ? static_cast<Node4*>(node)->keys
+                                                           : static_cast<Node16*>(node)->keys;
+                NodeRef* children = node->kind == NodeKind::N4 ? static_cast<Node4*>(node)->children
+                                                               : static_cast<Node16*>(node)->children;
+                uint16_t pos = 0;
+                while (keys[pos] != byte) {
+                    pos++;
+                }
+                std::memmove(keys + pos, keys + pos + 1, node->count - pos - 1);
+                std::memmove(children + pos, children + pos + 1, (node->count - pos - 1) * sizeof(NodeRef));
+                break;
+            }
+            case NodeKind::N48: {
+                Node48* n = static_cast<Node48*>(node);
+                n->children[n->index[byte] - 1] = 0;
+                n->index[byte] = 0;
+                break;
+            }
+            case NodeKind::N256:
+                static_cast<Node256*>(node)->children[byte] = 0;
+                break;
+        }
+        node->count--;
+
+        // 留出滞后区间，避免在边界上反复增长/收缩
+        if (node->kind == NodeKind::N256 && node->count <= 37) {
+            slot = inner_ref(convert_node(node, NodeKind::N48));
+        } else if (node->kind == NodeKind::N48 && node->count <= 12) {
+            slot = inner_ref(convert_node(node, NodeKind::N16));
+        } else if (node->kind == NodeKind::N16 && node->count <= 3) {
+            slot = inner_ref(convert_node(node, NodeKind::N4));
+        }
+    }
+
+    // 删除后整理节点：空节点删除，只剩一个分支的节点与其孩子合并
+    void collapse(NodeRef& slot) {
+        Inner* node = as_inner(slot);
+        if (node->count == 0) {
+            slot = node->terminal ? leaf_ref(node->terminal) : 0;
+            delete_node(node);
+        } else if (node->count == 1 && !node->terminal) {
+            uint8_t byte = 0;
+            NodeRef child = 0;
+            if (!next_child(node, 0, byte, child)) {
+                return;  // count与孩子表不一致，保持原样
+            }
+            if (!is_leaf(child)) {
+                Inner* merged = as_inner(child);
+                merged->prefix = node->prefix + static_cast<char>(byte) + merged->prefix;
+                merged->dirty = true;
+            }
+            slot = child;
+            delete_node(node);
+        }
+    }
+
+    AccTrieLeaf* min_leaf(NodeRef ref) {
+        while (ref && !is_leaf(ref)) {
+            Inner* node = as_inner(ref);
+            if (node->terminal) {
+                return node->terminal;
+            }
+            uint8_t byte;
+            if (!next_child(node, 0, byte, ref)) {
+                return nullptr;
+            }
+        }
+        return ref ? as_leaf(ref) : nullptr;
+    }
+
+    // 把叶子放到新建的Node4中：键恰好结束则作为终止叶子，否则作为孩子
+    void place_leaf(Inner* node, AccTrieLeaf* leaf, size_t depth) {
+        if (leaf->key.size() == depth) {
+            node->terminal = leaf;
+        } else {
+            put_child(node, static_cast<uint8_t>(leaf->key[depth]), leaf_ref(leaf));
+        }
+    }
+
+    void insert_leaf(NodeRef& slot, AccTrieLeaf* leaf, size_t depth) {
+        const std::string& key = leaf->key;
+        if (slot == 0) {
+            slot = leaf_ref(leaf);
+            return;
+        }
+
+        if (is_leaf(slot)) {
+            // 惰性展开的叶子与新键分裂出一个Node4
+            AccTrieLeaf* other = as_leaf(slot);
+            size_t i = depth;
+            while (i < key.size() && i < other->key.size() && key[i] == other->key[i]) {
+                i++;
+            }
+            Node4* node = new Node4();
+            node->prefix = key.substr(depth, i - depth);
+            place_leaf(node, other, i);
+            place_leaf(node, leaf, i);
+            slot = inner_ref(node);
+            return;
+        }
+
+        Inner* node = as_inner(slot);
+        node->dirty = true;
+        size_t prefix_len = node->prefix.size();
+        size_t matched = 0;
+        while (matched < prefix_len && depth + matched < key.size() &&
+               node->prefix[matched] == key[depth + matched]) {
+            matched++;
+        }
+        if (matched < prefix_len) {
+            // 前缀不匹配，在分歧处拆分
+            Node4* parent = new Node4();
+            parent->prefix = node->prefix.substr(0, matched);
+            uint8_t branch = static_cast<uint8_t>(node->prefix[matched]);
+            node->prefix.erase(0, matched + 1);
+            put_child(parent, branch, slot);
+            place_leaf(parent, leaf, depth + matched);
+            slot = inner_ref(parent);
+            return;
+        }
+
+        depth += prefix_len;
+        if (depth == key.size()) {
+            node->terminal = leaf;
+            return;
+        }
+        uint8_t byte = static_cast<uint8_t>(key[depth]);
+        NodeRef* child = find_child(node, byte);
+        if (child) {
+            insert_leaf(*child, leaf, depth + 1);
+        } else {
+            add_child(slot, byte, leaf_ref(leaf));
+        }
+    }
+
+    bool remove_leaf(NodeRef& slot, const std::string& key, size_t depth) {
+        if (slot == 0) {
+            return false;
+        }
+        if (is_leaf(slot)) {
+            if (as_leaf(slot)->key != key) {
+                return false;
+            }
+            slot = 0;
+            return true;
+        }
+
+        Inner* node = as_inner(slot);
+        if (key.compare(depth, node->prefix.size(), node->prefix) != 0) {
+            return false;
+        }
+        node->dirty = true;
+        depth += node->prefix.size();
+        if (depth == key.size()) {
+            if (!node->terminal) {
+                return false;
+            }
+            node->terminal = nullptr;
+            collapse(slot);
+            return true;
+        }
+
+        uint8_t byte = static_cast<uint8_t>(key[depth]);
+        NodeRef* child = find_child(node, byte);
+        if (!child || !remove_leaf(*child, key, depth + 1)) {
+            return false;
+        }
+        if (*child == 0) {
+            remove_child(slot, byte);
+        }
+        collapse(slot);
+        return true;
+    }
+
+    AccTrieLeaf* lower_bound_in(NodeRef ref, const std::string& key, size_t depth) {
+        if (ref == 0) {
+            return nullptr;
+        }
+        if (is_leaf(ref)) {
+            AccTrieLeaf* leaf = as_leaf(ref);
+            return leaf->key >= key ? leaf : nullptr;
+        }
+
+        Inner* node = as_inner(ref);
+        int cmp = key.compare(depth, node->prefix.size(), node->prefix);
+        if (cmp < 0) {
+            // 子树中所有键都大于key
+            return min_leaf(ref);
+        }
+        if (cmp > 0) {
+            return nullptr;
+        }
+        depth += node->prefix.size();
+        if (depth == key.size()) {
+            return min_leaf(ref);
+        }
+
+        uint8_t byte = static_cast<uint8_t>(key[depth]);
+        NodeRef* child = find_child(node, byte);
+        if (child) {
+            AccTrieLeaf* found = lower_bound_in(*child, key, depth + 1);
+            if (found) {
+                return found;
+            }
+        }
+        uint8_t next_byte;
+        NodeRef next;
+        if (byte < 255 && next_child(node, byte + 1, next_byte, next)) {
+            return min_leaf(next);
+        }
+        return nullptr;
+    }
+
+    void free_nodes(NodeRef ref) {
+        if (ref == 0 || is_leaf(ref)) {
+            return;
+        }
+        Inner* node = as_inner(ref);
+        for (const auto& entry : collect_children(node)) {
+            free_nodes(entry.second);
+        }
+        delete_node(node);
+    }
+
+    void count_nodes(NodeRef ref, AccTrie::Stats& stats) {
+        if (ref == 0 || is_leaf(ref)) {
+            return;
+        }
+        Inner* node = as_inner(ref);
+        switch (node->kind) {
+            case NodeKind::N4: stats.node4++; break;
+            case NodeKind::N16: stats.node16++; break;
+            case NodeKind::N48: stats.node48++; break;
+            case NodeKind::N256: stats.node256++; break;
+        }
+        stats.inner_bytes += node_bytes(node);
+        for (const auto& entry : collect_children(node)) {
+            count_nodes(entry.second, stats);
+        }
+    }
+
+    // 取完整的256位摘要，值元素之间、值与链接元素之间的碰撞需要约2^128次哈希
+    BigInt hash_element(const char* domain, const std::string& data) {
+        std::string input = std::string(domain) + data;
+        uint8_t hash[SHA256_DIGEST_LENGTH];
+        SHA256(reinterpret_cast<const uint8_t*>(input.data()), input.size(), hash);
+        return BigInt::from_bytes(std::vector<uint8_t>(hash, hash + SHA256_DIGEST_LENGTH));
+    }
+
+    void append_string(Transcript& transcript, const char* label, const std::string& data) {
+        transcript.append_message(label, reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+
+    // 叶子摘要同时承诺两个累加器值：值元素之和的 g^Σ 与未知阶群中的 U = h^∏prime，
+    // 后者对值和链接元素是绑定的
+    AccTrie::Digest leaf_digest(const std::string& key, const GroupElement& acc, const GroupElement& universal) {
+        Transcript transcript("acctrie-leaf");
+        append_string(transcript, "key", key);
+        transcript.append_group_element("acc", acc);
+        transcript.append_group_element("universal", universal);
+        AccTrie::Digest digest;
+        transcript.challenge_bytes("digest", digest.data());
+        return digest;
+    }
+
+    // 内部节点摘要 = H(前缀, 终止叶子摘要, 按字节排序的(字节, 孩子摘要))
+    AccTrie::Digest node_digest(const std::string& prefix, const AccTrie::Digest* terminal,
+                                const std::vector<std::pair<uint8_t, AccTrie::Digest>>& children) {
+        Transcript transcript("acctrie-node");
+        append_string(transcript, "prefix", prefix);
+        if (terminal) {
+            transcript.append_message("terminal", terminal->data(), terminal->size());
+        }
+        for (const auto& child : children) {
+            transcript.append_u64("byte", child.first);
+            transcript.append_message("child", child.second.data(), child.second.size());
+        }
+        AccTrie::Digest digest;
+        transcript.challenge_bytes("digest", digest.data());
+        return digest;
+    }
+
+    AccTrie::Digest root_of(const AccTrie::Digest& trie, const GroupElement& end_acc,
+                            const GroupElement& end_universal) {
+        Transcript transcript("acctrie-root");
+        transcript.append_message("trie", trie.data(), trie.size());
+        transcript.append_group_element("end", end_acc);
+        transcript.append_group_element("end-universal", end_universal);
+        AccTrie::Digest digest;
+        transcript.challenge_bytes("digest", digest.data());
+        return digest;
+    }
+
+    // 见证 W 满足 W^prime(link(prev_key)) = U，即prev_key是U所属叶子的前序；
+    // U 由路径证明取自可信根，群的阶未知，伪造见证需要开素数次根
+    bool verify_link(const GroupElement& witness, const std::string& prev_key, const GroupElement& universal) {
+        const RSAGroup& group = RSAGroup::rsa2048();
+        if (!group.contains(witness) || !group.contains(universal)) {
+            return false;
+        }
+        return group.canonical(witness ^ CryptoUtils::hash_to_prime(AccTrie::link_element(prev_key))) == universal;
+    }
+
+    AccTrie::Digest rehash(NodeRef ref) {
+        if (ref == 0) {
+            return AccTrie::Digest{};
+        }
+        if (is_leaf(ref)) {
+            AccTrieLeaf* leaf = as_leaf(ref);
+            return leaf_digest(leaf->key, leaf->acc.get_accumulator_value(), leaf->acc.get_universal_value());
+        }
+
+        // 干净的子树直接复用缓存的摘要
+        Inner* node = as_inner(ref);
+        if (!node->dirty) {
+            return node->digest;
+        }
+        std::vector<std::pair<uint8_t, AccTrie::Digest>> children;
+        for (const auto& entry : collect_children(node)) {
+            children.emplace_back(entry.first, rehash(entry.second));
+        }
+        AccTrie::Digest terminal;
+        if (node->terminal) {
+            terminal = leaf_digest(node->terminal->key, node->terminal->acc.get_accumulator_value(),
+                                   node->terminal->acc.get_universal_value());
+        }
+        node->digest = node_digest(node->prefix, node->terminal ? &terminal : nullptr, children);
+        node->dirty = false;
+        return node->digest;
+    }
+}
+
+// AccTrie 实现
+AccTrie::AccTrie()
+    : root(0), head(nullptr), tail(nullptr), leaf_count(0), end_acc(false) {
+    // 由尾部哨兵生成整棵树共享的群参数
+    group_order = end_acc.get_group_order();
+    generator = end_acc.get_generator();
+    end_acc.add_element(link_element(""));
+}
+
+AccTrie::AccTrie(const BigInt& group_order, const GroupElement& generator)
+    : group_order(group_order), generator(generator), root(0), head(nullptr), tail(nullptr),
+      leaf_count(0), end_acc(group_order, generator, false) {
+    end_acc.add_element(link_element(""));
+}
+
+AccTrie::~AccTrie() {
+    free_nodes(root);
+    AccTrieLeaf* leaf = head;
+    while (leaf) {
+        AccTrieLeaf* next = leaf->next;
+        delete leaf;
+        leaf = next;
+    }
+}
+
+BigInt AccTrie::value_element(const std::string& value) {
+    return hash_element("acctrie-value:", value);
+}
+
+BigInt AccTrie::link_element(const std::string& prev_key) {
+    return hash_element("acctrie-link:", prev_key);
+}
+
+AccTrieLeaf* AccTrie::find_leaf(const std::string& key) const {
+    NodeRef ref = root;
+    size_t depth = 0;
+    while (ref) {
+        if (is_leaf(ref)) {
+            AccTrieLeaf* leaf = as_leaf(ref);
+            return leaf->key == key ? leaf : nullptr;
+        }
+        Inner* node = as_inner(ref);
+        if (key.compare(depth, node->prefix.size(), node->prefix) != 0) {
+            return nullptr;
+        }
+        depth += node->prefix.size();
+        if (depth == key.size()) {
+            return node->terminal;
+        }
+        NodeRef* child = find_child(node, static_cast<uint8_t>(key[depth]));
+        if (!child) {
+            return nullptr;
+        }
+        ref = *child;
+        depth++;
+    }
+    return nullptr;
+}
+
+AccTrieLeaf* AccTrie::lower_bound_leaf(const std::string& key) const {
+    return lower_bound_in(root, key, 0);
+}
+
+const AccTrieLeaf* AccTrie::find(const std::string& key) const {
+    return find_leaf(key);
+}
+
+const AccTrieLeaf* AccTrie::lower_bound(const std::string& key) const {
+    return lower_bound_leaf(key);
+}
+
+void AccTrie::link_leaf(AccTrieLeaf* leaf, AccTrieLeaf* successor, UpdateResult& result) {
+    AccTrieLeaf* prev = successor ? successor->prev : tail;
+    leaf->prev = prev;
+    leaf->next = successor;
+    (prev ? prev->next : head) = leaf;
+    (successor ? successor->prev : tail) = leaf;
+
+    // 新叶子承诺它的前序，后序叶子的链接从前序改为新叶子
+    std::string prev_key = prev ? prev->key : "";
+    leaf->acc.add_element(link_element(prev_key));
+
+    ESAAccumulator& next_acc = successor_acc(successor);
+    result.old_lnn_acc = next_acc.get_accumulator_value();
+    next_acc.update_element(link_element(prev_key), link_element(leaf->key));
+    result.new_lnn_acc = next_acc.get_accumulator_value();
+    result.keyp = prev_key;
+    result.keyn = successor ? successor->key : "";
+}
+
+void AccTrie::unlink_leaf(AccTrieLeaf* leaf, UpdateResult& result) {
+    AccTrieLeaf* prev = leaf->prev;
+    AccTrieLeaf* successor = leaf->next;
+    (prev ? prev->next : head) = successor;
+    (successor ? successor->prev : tail) = prev;
+
+    std::string prev_key = prev ? prev->key : "";
+    ESAAccumulator& next_acc = successor_acc(successor);
+    result.old_lnn_acc = next_acc.get_accumulator_value();
+    next_acc.update_element(link_element(leaf->key), link_element(prev_key));
+    result.new_lnn_acc = next_acc.get_accumulator_value();
+    result.keyp = prev_key;
+    result.keyn = successor ? successor->key : "";
+}
+
+AccTrie::UpdateResult AccTrie::insert_unhashed(const std::string& key, const std::string& value) {
+    UpdateResult result;
+    result.key = key;
+    if (key.empty()) {
+        return result;
+    }
+
+    AccTrieLeaf* leaf = find_leaf(key);
+    if (!leaf) {
+        // 插入前先定位后序叶子，新叶子挂到链表中后再放入树
+        AccTrieLeaf* successor = lower_bound_leaf(key);
+        leaf = new AccTrieLeaf(key, group_order, generator);
+        link_leaf(leaf, successor, result);
+        insert_leaf(root, leaf, 0);
+        leaf_count++;
+        if (successor) {
+            mark_path(successor->key);
+        }
+    } else {
+        ESAAccumulator& next_acc = successor_acc(leaf->next);
+        result.keyp = leaf->prev ? leaf->prev->key : "";
+        result.keyn = leaf->next ? leaf->next->key : "";
+        result.old_lnn_acc = next_acc.get_accumulator_value();
+        result.new_lnn_acc = result.old_lnn_acc;
+    }
+
+    if (!leaf->acc.add_element(value_element(value))) {
+        result.ln_acc = leaf->acc.get_accumulator_value();
+        return result;
+    }
+    leaf->values.push_back(value);
+    mark_path(key);
+    result.ln_acc = leaf->acc.get_accumulator_value();
+    result.success = true;
+    return result;
+}
+
+AccTrie::UpdateResult AccTrie::insert(const std::string& key, const std::string& value) {
+    UpdateResult result = insert_unhashed(key, value);
+    result.root = root_digest();
+    return result;
+}
+
+std::vector<AccTrie::UpdateResult> AccTrie::insert_batch(const std::vector<std::pair<std::string, std::string>>& entries) {
+    std::vector<UpdateResult> results;
+    results.reserve(entries.size());
+    for (const auto& entry : entries) {
+        results.push_back(insert_unhashed(entry.first, entry.second));
+    }
+
+    // 整批只重新哈希一次
+    Digest root = root_digest();
+    for (auto& result : results) {
+        result.root = root;
+    }
+    return results;
+}
+
+AccTrie::UpdateResult AccTrie::remove(const std::string& key, const std::string& value) {
+    UpdateResult result;
+    result.key = key;
+
+    AccTrieLeaf* leaf = find_leaf(key);
+    if (!leaf) {
+        return result;
+    }
+    auto it = std::find(leaf->values.begin(), leaf->values.end(), value);
+    if (it == leaf->values.end()) {
+        return result;
+    }
+    leaf->values.erase(it);
+    leaf->acc.remove_element(value_element(value));
+    result.ln_acc = leaf->acc.get_accumulator_value();
+
+    if (leaf->values.empty()) {
+        // 最后一个值被删除，叶子从链表和树中移除
+        AccTrieLeaf* successor = leaf->next;
+        unlink_leaf(leaf, result);
+        remove_leaf(root, key, 0);
+        delete leaf;
+        leaf_count--;
+        if (successor) {
+            mark_path(successor->key);
+        }
+    } else {
+        mark_path(key);
+        ESAAccumulator& next_acc = successor_acc(leaf->next);
+        result.keyp = leaf->prev ? leaf->prev->key : "";
+        result.keyn = leaf->next ? leaf->next->key : "";
+        result.old_lnn_acc = next_acc.get_accumulator_value();
+        result.new_lnn_acc = result.old_lnn_acc;
+    }
+    result.root = root_digest();
+    result.success = true;
+    return result;
+}
+
+AccTrie::QueryResult AccTrie::query(const std::string& key) {
+    QueryResult result;
+    result.keyword = key;
+
+    AccTrieLeaf* leaf = find_leaf(key);
+    if (leaf) {
+        result.exists = true;
+        result.values = leaf->values;
+        result.ln_acc = leaf->acc.get_accumulator_value();
+        return result;
+    }
+
+    // 不存在证明：相邻的两个叶子以及后序叶子中前序链接元素的见证
+    AccTrieLeaf* successor = lower_bound_leaf(key);
+    AccTrieLeaf* prev = successor ? successor->prev : tail;
+    result.keyp = prev ? prev->key : "";
+    result.keyn = successor ? successor->key : "";
+    ESAAccumulator& next_acc = successor_acc(successor);
+    result.lnn_acc = next_acc.get_accumulator_value();
+    result.link_witness = next_acc.generate_aggregate_witness({link_element(result.keyp)});
+    if (prev) {
+        result.keyp_path = prove_path(prev->key);
+    }
+    result.keyn_path = successor ? prove_path(successor->key) : prove_end();
+    return result;
+}
+
+bool AccTrie::verify_absence(const QueryResult& result, const Digest& root) {
+    if (result.exists || !result.lnn_acc.valid()) {
+        return false;
+    }
+    if (!result.keyp.empty() && !(result.keyp < result.keyword)) {
+        return false;
+    }
+    if (!result.keyn.empty() && !(result.keyword < result.keyn)) {
+        return false;
+    }
+
+    // 两个邻居都必须在可信根之下，lnn_acc取自后序叶子（或尾部哨兵）的路径证明
+    if (!result.keyp.empty() && (result.keyp_path.key != result.keyp || !verify_path(result.keyp_path, root))) {
+        return false;
+    }
+    const PathProof& next = result.keyn_path;
+    if (!verify_path(next, root)) {
+        return false;
+    }
+    if (result.keyn.empty()) {
+        if (next.end_acc != result.lnn_acc) {
+            return false;
+        }
+        return verify_link(result.link_witness, result.keyp, next.end_universal);
+    }
+    if (next.key != result.keyn || next.ln_acc != result.lnn_acc) {
+        return false;
+    }
+    return verify_link(result.link_witness, result.keyp, next.ln_universal);
+}
+
+AccTrie::Stats AccTrie::stats() const {
+    Stats stats;
+    stats.leaves = leaf_count;
+    count_nodes(root, stats);
+    return stats;
+}
+
+template<typename InRange>
+AccTrie::RangeResult AccTrie::scan_from(AccTrieLeaf* leaf, InRange in_range) {
+    RangeResult result;
+    AccTrieLeaf* prev = leaf ? leaf->prev : tail;
+    result.keyp = prev ? prev->key : "";
+
+    // 沿叶子链表顺序扫描，直到第一个落在范围之外的叶子
+    if (prev) {
+        result.keyp_path = prove_path(prev->key);
+    }
+    std::string last_key = result.keyp;
+    while (leaf && in_range(leaf->key)) {
+        result.entries.push_back({leaf->key, leaf->values, leaf->acc.get_accumulator_value(), prove_path(leaf->key)});
+        last_key = leaf->key;
+        leaf = leaf->next;
+    }
+
+    result.keyn = leaf ? leaf->key : "";
+    ESAAccumulator& next_acc = successor_acc(leaf);
+    result.lnn_acc = next_acc.get_accumulator_value();
+    result.link_witness = next_acc.generate_aggregate_witness({link_element(last_key)});
+    result.keyn_path = leaf ? prove_path(leaf->key) : prove_end();
+    return result;
+}
+
+AccTrie::RangeResult AccTrie::range_query(const std::string& lo, const std::string& hi) {
+    if (hi < lo) {
+        return RangeResult();
+    }
+    return scan_from(lower_bound_leaf(lo), [&hi](const std::string& key) { return key <= hi; });
+}
+
+AccTrie::RangeResult AccTrie::prefix_query(const std::string& prefix) {
+    return scan_from(lower_bound_leaf(prefix), [&prefix](const std::string& key) {
+        return key.compare(0, prefix.size(), prefix) == 0;
+    });
+}
+
+bool AccTrie::verify_chain(const RangeResult& result, const Digest& root) {
+    if (!result.lnn_acc.valid()) {
+        return false;
+    }
+    if (!result.keyp.empty() && (result.keyp_path.key != result.keyp || !verify_path(result.keyp_path, root))) {
+        return false;
+    }
+
+    // 每个叶子在根之下，且其通用累加器 = h^(∏prime(值元素) · prime(前一个key的链接元素))
+    const RSAGroup& group = RSAGroup::rsa2048();
+    std::string prev_key = result.keyp;
+    for (const auto& entry : result.entries) {
+        if (entry.values.empty() || !(prev_key < entry.key)) {
+            return false;
+        }
+        if (entry.path.key != entry.key || entry.path.ln_acc != entry.ln_acc || !verify_path(entry.path, root)) {
+            return false;
+        }
+        std::vector<BigInt> primes;
+        primes.push_back(CryptoUtils::hash_to_prime(link_element(prev_key)));
+        for (const auto& value : entry.values) {
+            primes.push_back(CryptoUtils::hash_to_prime(value_element(value)));
+        }
+        if (group.canonical(group.get_base() ^ CryptoUtils::balanced_product(primes)) != entry.path.ln_universal) {
+            return false;
+        }
+        prev_key = entry.key;
+    }
+    if (!result.keyn.empty() && !(prev_key < result.keyn)) {
+        return false;
+    }
+
+    // 右邻居承诺最后一个叶子
+    const PathProof& next = result.keyn_path;
+    if (!verify_path(next, root)) {
+        return false;
+    }
+    if (result.keyn.empty()) {
+        return next.end_acc == result.lnn_acc && verify_link(result.link_witness, prev_key, next.end_universal);
+    }
+    return next.key == result.keyn && next.ln_acc == result.lnn_acc &&
+           verify_link(result.link_witness, prev_key, next.ln_universal);
+}
+
+bool AccTrie::verify_range(const RangeResult& result, const std::string& lo, const std::string& hi,
+                           const Digest& root) {
+    if (!result.keyp.empty() && !(result.keyp < lo)) {
+        return false;
+    }
+    if (!result.keyn.empty() && !(hi < result.keyn)) {
+        return false;
+    }
+    for (const auto& entry : result.entries) {
+        if (entry.key < lo || hi < entry.key) {
+            return false;
+        }
+    }
+    return verify_chain(result, root);
+}
+
+bool AccTrie::verify_prefix(const RangeResult& result, const std::string& prefix, const Digest& root) {
+    // 小于prefix的key不可能以prefix开头，右邻居必须大于prefix且不以prefix开头
+    if (!result.keyp.empty() && !(result.keyp < prefix)) {
+        return false;
+    }
+    if (!result.keyn.empty() &&
+        (result.keyn < prefix || result.keyn.compare(0, prefix.size(), prefix) == 0)) {
+        return false;
+    }
+    for (const auto& entry : result.entries) {
+        if (entry.key.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+    }
+    return verify_chain(result, root);
+}
+
+void AccTrie::mark_path(const std::string& key) {
+    NodeRef ref = root;
+    size_t depth = 0;
+    while (ref && !is_leaf(ref)) {
+        Inner* node = as_inner(ref);
+        node->dirty = true;
+        depth += node->prefix.size();
+        if (depth >= key.size()) {
+            return;
+        }
+        NodeRef* child = find_child(node, static_cast<uint8_t>(key[depth]));
+        if (!child) {
+            return;
+        }
+        ref = *child;
+        depth++;
+    }
+}
+
+AccTrie::Digest AccTrie::root_digest() {
+    return root_of(rehash(root), end_acc.get_accumulator_value(), end_acc.get_universal_value());
+}
+
+AccTrie::PathProof AccTrie::prove_path(const std::string& key) {
+    PathProof proof;
+    AccTrieLeaf* leaf = find_leaf(key);
+    if (!leaf) {
+        return proof;
+    }
+    rehash(root);
+
+    // 自根向下记录每层节点的兄弟摘要
+    NodeRef ref = root;
+    size_t depth = 0;
+    while (!is_leaf(ref)) {
+        Inner* node = as_inner(ref);
+        PathStep step;
+        step.prefix = node->prefix;
+        if (node->terminal) {
+            step.has_terminal = true;
+            step.terminal = leaf_digest(node->terminal->key, node->terminal->acc.get_accumulator_value(),
+                                        node->terminal->acc.get_universal_value());
+        }
+        depth += node->prefix.size();
+        uint8_t byte = depth < key.size() ? static_cast<uint8_t>(key[depth]) : 0;
+        NodeRef next = 0;
+        for (const auto& entry : collect_children(node)) {
+            if (depth < key.size() && entry.first == byte) {
+                step.position = static_cast<int>(step.children.size());
+                next = entry.second;
+            }
+            step.children.emplace_back(entry.first, rehash(entry.second));
+        }
+        proof.steps.push_back(std::move(step));
+        if (depth == key.size()) {
+            break;
+        }
+        ref = next;
+        depth++;
+    }
+
+    proof.valid = true;
+    proof.key = key;
+    proof.ln_acc = leaf->acc.get_accumulator_value();
+    proof.ln_universal = leaf->acc.get_universal_value();
+    proof.end_acc = end_acc.get_accumulator_value();
+    proof.end_universal = end_acc.get_universal_value();
+    return proof;
+}
+
+AccTrie::PathProof AccTrie::prove_end() {
+    if (tail) {
+        return prove_path(tail->key);
+    }
+    PathProof proof;
+    proof.valid = true;
+    proof.end_acc = end_acc.get_accumulator_value();
+    proof.end_universal = end_acc.get_universal_value();
+    return proof;
+}
+
+bool AccTrie::verify_path(const PathProof& proof, const Digest& root) {
+    if (!proof.valid || !proof.end_acc.valid() || !proof.end_universal.valid()) {
+        return false;
+    }
+    // 键不能为空，空key的证明表示整棵树为空
+    if (proof.key.empty()) {
+        return proof.steps.empty() && root_of(Digest{}, proof.end_acc, proof.end_universal) == root;
+    }
+    if (!proof.ln_acc.valid() || !proof.ln_universal.valid()) {
+        return false;
+    }
+
+    // 路径上的前缀和分支字节必须拼出key
+    std::string path;
+    for (size_t i = 0; i < proof.steps.size(); i++) {
+        const PathStep& step = proof.steps[i];
+        path += step.prefix;
+        if (step.position < 0) {
+            if (i + 1 != proof.steps.size() || !step.has_terminal || path != proof.key) {
+                return false;
+            }
+        } else {
+            if (static_cast<size_t>(step.position) >= step.children.size()) {
+                return false;
+            }
+            path += static_cast<char>(step.children[step.position].first);
+        }
+    }
+    if (proof.key.compare(0, path.size(), path) != 0) {
+        return false;
+    }
+
+    // 自叶子向上逐层重新计算摘要
+    Digest digest = leaf_digest(proof.key, proof.ln_acc, proof.ln_universal);
+    for (size_t i = proof.steps.size(); i-- > 0;) {
+        const PathStep& step = proof.steps[i];
+        Digest terminal = step.terminal;
+        std::vector<std::pair<uint8_t, Digest>> children = step.children;
+        if (step.position < 0) {
+            terminal = digest;
+        } else {
+            children[step.position].second = digest;
+        }
+        digest = node_digest(step.prefix, step.has_terminal ? &terminal : nullptr, children);
+    }
+    return root_of(digest, proof.end_acc, proof.end_universal) == root;
+}
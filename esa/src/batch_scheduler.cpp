@@ -0,0 +1,172 @@
+#include "batch_scheduler.h"
+#include <unordered_map>
+
+// BatchScheduler 实现
+BatchScheduler::BatchScheduler(ESAAccumulator& accumulator)
+    : BatchScheduler(accumulator, Config()) {}
+
+BatchScheduler::BatchScheduler(ESAAccumulator& accumulator, const Config& config)
+    : accumulator(accumulator), config(config), stopping(false), epoch(0) {
+    if (this->config.max_batch_size == 0) {
+        this->config.max_batch_size = 1;
+    }
+    dispatcher = std::thread(&BatchScheduler::dispatch_loop, this);
+}
+
+BatchScheduler::~BatchScheduler() {
+    stop();
+}
+
+void BatchScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+    queue_ready.notify_all();
+    dispatcher.join();
+}
+
+BatchScheduler::Stats BatchScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return counters;
+}
+
+void BatchScheduler::enqueue(Request request) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    if (stopping) {
+        lock.unlock();
+        if (request.kind == Kind::QUERY) {
+            request.query_result.set_value(QueryResult());
+        } else {
+            request.update_result.set_value(false);
+        }
+        return;
+    }
+    bool first = queue.empty();
+    request.arrival = std::chrono::steady_clock::now();
+    queue.push_back(std::move(request));
+    bool full = queue.size() >= config.max_batch_size;
+    lock.unlock();
+
+    // 第一个请求唤醒调度线程开始计时，批次满时让它立即处理
+    if (first || full) {
+        queue_ready.notify_one();
+    }
+}
+
+std::future<bool> BatchScheduler::submit_insert(const BigInt& element) {
+    Request request{Kind::INSERT, element, std::promise<bool>(), std::promise<QueryResult>(), {}};
+    std::future<bool> result = request.update_result.get_future();
+    enqueue(std::move(request));
+    return result;
+}
+
+std::future<bool> BatchScheduler::submit_remove(const BigInt& element) {
+    Request request{Kind::REMOVE, element, std::promise<bool>(), std::promise<QueryResult>(), {}};
+    std::future<bool> result = request.update_result.get_future();
+    enqueue(std::move(request));
+    return result;
+}
+
+std::future<BatchScheduler::QueryResult> BatchScheduler::submit_query(const BigInt& element) {
+    Request request{Kind::QUERY, element, std::promise<bool>(), std::promise<QueryResult>(), {}};
+    std::future<QueryResult> result = request.query_result.get_future();
+    enqueue(std::move(request));
+    return result;
+}
+
+void BatchScheduler::dispatch_loop() {
+    while (true) {
+        std::vector<Request> batch;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_ready.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;  // 已停止且没有剩余请求
+            }
+
+            // 从队首（最早到达的）请求开始计时，窗口结束或批次已满时处理；
+            // 上一批取走部分请求后，剩下的请求仍按各自的到达时间计时
+            auto deadline = queue.front().arrival + config.max_delay;
+            queue_ready.wait_until(lock, deadline, [this]() {
+                return stopping || queue.size() >= config.max_batch_size;
+            });
+
+            size_t take = std::min(queue.size(), config.max_batch_size);
+            batch.reserve(take);
+            for (size_t i = 0; i < take; i++) {
+                batch.push_back(std::move(queue[i]));
+            }
+            queue.erase(queue.begin(), queue.begin() + take);
+        }
+        apply_batch(batch);
+    }
+}
+
+void BatchScheduler::apply_batch(std::vector<Request>& batch) {
+    BigIntArena::Scope scope;
+
+    // 按提交顺序在成员关系上模拟每个更新，得到各自的结果和整个批次的净变化
+    std::unordered_map<BigInt, std::pair<bool, bool>, BigInt::Hash> membership;  // (初始, 当前)
+    std::vector<bool> outcomes(batch.size(), false);
+    size_t updates = 0;
+    for (size_t i = 0; i < batch.size(); i++) {
+        const Request& request = batch[i];
+        if (request.kind == Kind::QUERY) {
+            continue;
+        }
+        updates++;
+        auto it = membership.find(request.element);
+        if (it == membership.end()) {
+            bool present = accumulator.contains(request.element);
+            it = membership.emplace(request.element, std::make_pair(present, present)).first;
+        }
+        bool& current = it->second.second;
+        bool success = request.kind == Kind::INSERT ? !current : current;
+        if (success) {
+            current = request.kind == Kind::INSERT;
+        }
+        outcomes[i] = success;
+    }
+
+    // 一次合并更新
+    std::vector<BigInt> additions;
+    std::vector<BigInt> removals;
+    for (const auto& entry : membership) {
+        if (entry.second.first != entry.second.second) {
+            (entry.second.second ? additions : removals).push_back(entry.first);
+        }
+    }
+    accumulator.add_elements(additions);
+    accumulator.remove_elements(removals);
+
+    // 批次中的查询都在更新后的同一个快照上回答
+    uint64_t batch_epoch;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        batch_epoch = ++epoch;
+        counters.batches++;
+        counters.requests += batch.size();
+        counters.max_batch = std::max<uint64_t>(counters.max_batch, batch.size());
+        counters.coalesced += updates - additions.size() - removals.size();
+    }
+    // 更新生效之后再通知提交更新的调用者
+    GroupElement snapshot = accumulator.get_accumulator_value();
+    for (size_t i = 0; i < batch.size(); i++) {
+        Request& request = batch[i];
+        if (request.kind != Kind::QUERY) {
+            request.update_result.set_value(outcomes[i]);
+            continue;
+        }
+        QueryResult result;
+        result.epoch = batch_epoch;
+        result.accumulator = snapshot;
+        result.member = accumulator.contains(request.element);
+        result.proof = result.member ? accumulator.generate_membership_proof(request.element)
+                                     : accumulator.generate_non_membership_proof(request.element);
+        request.query_result.set_value(std::move(result));
+    }
+}
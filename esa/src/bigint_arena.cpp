@@ -0,0 +1,105 @@
+#include "esa_accumulator.h"
+#include <openssl/bn.h>
+
+namespace {
+    thread_local BigIntArena* current_arena = nullptr;
+
+    BigIntArena& thread_default_arena() {
+        thread_local BigIntArena arena;
+        return arena;
+    }
+}
+
+// BigIntArena 实现
+BigIntArena::BigIntArena(size_t retain_limit)
+    : bn_ctx(nullptr), retain_limit(retain_limit) {
+    free_list.reserve(retain_limit);
+}
+
+BigIntArena::~BigIntArena() {
+    reset();
+    if (bn_ctx) {
+        BN_CTX_free(bn_ctx);
+    }
+}
+
+BIGNUM* BigIntArena::acquire() {
+    if (!free_list.empty()) {
+        BIGNUM* bn = free_list.back();
+        free_list.pop_back();
+        counters.bn_reused++;
+        return bn;
+    }
+    counters.bn_allocated++;
+    return BN_new();
+}
+
+void BigIntArena::release(BIGNUM* bn) {
+    // 清零后放回池中，临时值里可能有证明用的随机数
+    BN_clear(bn);
+    free_list.push_back(bn);
+}
+
+BN_CTX* BigIntArena::ctx() {
+    if (!bn_ctx) {
+        bn_ctx = BN_CTX_new();
+    }
+    return bn_ctx;
+}
+
+void BigIntArena::trim() {
+    while (free_list.size() > retain_limit) {
+        BN_free(free_list.back());
+        free_list.pop_back();
+        counters.bn_freed++;
+    }
+}
+
+void BigIntArena::reset() {
+    for (BIGNUM* bn : free_list) {
+        BN_free(bn);
+    }
+    counters.bn_freed += free_list.size();
+    free_list.clear();
+}
+
+BigIntArena* BigIntArena::current() {
+    return current_arena;
+}
+
+// Scope 实现
+BigIntArena::Scope::Scope()
+    : previous(current_arena),
+      active(current_arena ? current_arena : &thread_default_arena()),
+      outermost(current_arena == nullptr) {
+    current_arena = active;
+}
+
+BigIntArena::Scope::Scope(BigIntArena& arena)
+    : previous(current_arena), active(&arena), outermost(current_arena != &arena) {
+    current_arena = active;
+}
+
+BigIntArena::Scope::~Scope() {
+    current_arena = previous;
+    if (outermost) {
+        active->trim();
+    }
+}
+
+// CtxGuard 实现
+BigIntArena::CtxGuard::CtxGuard() {
+    if (current_arena) {
+        ctx = current_arena->ctx();
+        owned = false;
+    } else {
+        ctx = BN_CTX_new();
+        owned = true;
+    }
+}
+
+BigIntArena::CtxGuard::~CtxGuard() {
+    if (owned) {
+        BN_CTX_free(ctx);
+    }
+}
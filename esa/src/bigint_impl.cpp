@@ -1,17 +1,25 @@
 #include "esa_accumulator.h"
+#include "hash_to_prime.h"
+#include "secure_random.h"
 #include <openssl/bn.h>
 #include <openssl/rand.h>
 #include <sstream>
 #include <iomanip>
 
 // BigInt 实现
+// 有活动的BigIntArena时从池中取BIGNUM，否则直接分配
+static BIGNUM* allocate_bn() {
+    BigIntArena* arena = BigIntArena::current();
+    return arena ? arena->acquire() : BN_new();
+}
+
 BigInt::BigInt() {
-    value = BN_new();
+    value = allocate_bn();
     BN_zero(value);
 }
 
 BigInt::BigInt(const std::string& str, int base) {
-    value = BN_new();
+    value = allocate_bn();
     if (base == 16) {
         BN_hex2bn(&value, str.c_str());
     } else {
@@ -20,7 +28,7 @@ BigInt::BigInt(const std::string& str, int base) {
 }
 
 BigInt::BigInt(const BigInt& other) {
-    value = BN_new();
+    value = allocate_bn();
     BN_copy(value, other.value);
 }
 
@@ -30,7 +38,12 @@ BigInt::BigInt(BigInt&& other) noexcept : value(other.value) {
 
 BigInt::~BigInt() {
     if (value) {
-        BN_free(value);
+        BigIntArena* arena = BigIntArena::current();
+        if (arena) {
+            arena->release(value);
+        } else {
+            BN_free(value);
+        }
     }
 }
 
@@ -44,7 +57,12 @@ BigInt& BigInt::operator=(const BigInt& other) {
 BigInt& BigInt::operator=(BigInt&& other) noexcept {
     if (this != &other) {
         if (value) {
-            BN_free(value);
+            BigIntArena* arena = BigIntArena::current();
+            if (arena) {
+                arena->release(value);
+            } else {
+                BN_free(value);
+            }
         }
         value = other.value;
         other.value = nullptr;
@@ -67,33 +85,29 @@ BigInt BigInt::operator-(const BigInt& other) const {
 
 BigInt BigInt::operator*(const BigInt& other) const {
     BigInt result;
-    BN_CTX* ctx = BN_CTX_new();
+    BigIntArena::CtxGuard ctx;
     BN_mul(result.value, value, other.value, ctx);
-    BN_CTX_free(ctx);
     return result;
 }
 
 BigInt BigInt::operator/(const BigInt& other) const {
     BigInt result;
-    BN_CTX* ctx = BN_CTX_new();
+    BigIntArena::CtxGuard ctx;
     BN_div(result.value, nullptr, value, other.value, ctx);
-    BN_CTX_free(ctx);
     return result;
 }
 
 BigInt BigInt::operator%(const BigInt& other) const {
     BigInt result;
-    BN_CTX* ctx = BN_CTX_new();
+    BigIntArena::CtxGuard ctx;
     BN_mod(result.value, value, other.value, ctx);
-    BN_CTX_free(ctx);
     return result;
 }
 
 BigInt BigInt::operator^(const BigInt& other) const {
     BigInt result;
-    BN_CTX* ctx = BN_CTX_new();
+    BigIntArena::CtxGuard ctx;
     BN_mod_exp(result.value, value, other.value, other.value, ctx);
-    BN_CTX_free(ctx);
     return result;
 }
 
@@ -134,16 +148,14 @@ BigInt& BigInt::operator-=(const BigInt& other) {
 }
 
 BigInt& BigInt::operator*=(const BigInt& other) {
-    BN_CTX* ctx = BN_CTX_new();
+    BigIntArena::CtxGuard ctx;
     BN_mul(value, value, other.value, ctx);
-    BN_CTX_free(ctx);
     return *this;
 }
 
 BigInt& BigInt::operator%=(const BigInt& other) {
-    BN_CTX* ctx = BN_CTX_new();
+    BigIntArena::CtxGuard ctx;
     BN_mod(value, value, other.value, ctx);
-    BN_CTX_free(ctx);
     return *this;
 }
 
@@ -173,17 +185,28 @@ bool BigInt::is_one() const {
     return BN_is_one(value);
 }
 
+bool BigInt::fits_u64() const {
+    return !BN_is_negative(value) && BN_num_bits(value) <= 64;
+}
+
+uint64_t BigInt::to_u64() const {
+    uint8_t bytes[8] = {0};
+    BN_bn2binpad(value, bytes, sizeof(bytes));
+    uint64_t word = 0;
+    for (uint8_t b : bytes) {
+        word = (word << 8) | b;
+    }
+    return word;
+}
+
 // 静态函数
+// 随机数取自线程私有的SecureRandom，不再每次经过OpenSSL全局DRBG
 BigInt BigInt::random(size_t bits) {
-    BigInt result;
-    BN_rand(result.value, bits, BN_RAND_TOP_ANY, BN_RAND_BOTTOM_ANY);
-    return result;
+    return SecureRandom::local().random_bits(bits);
 }
 
 BigInt BigInt::random_range(const BigInt& min, const BigInt& max) {
-    BigInt range = max - min;
-    BigInt random_val = random(range.bit_length());
-    return min + (random_val % range);
+    return SecureRandom::local().uniform(min, max);
 }
 
 BigInt BigInt::from_hex(const std::string& hex) {
@@ -196,6 +219,17 @@ BigInt BigInt::from_bytes(const std::vector<uint8_t>& bytes) {
     return result;
 }
 
+BigInt BigInt::from_u64(uint64_t word) {
+    uint8_t bytes[8];
+    for (int i = 7; i >= 0; i--) {
+        bytes[i] = static_cast<uint8_t>(word & 0xff);
+        word >>= 8;
+    }
+    BigInt result;
+    BN_bin2bn(bytes, sizeof(bytes), result.value);
+    return result;
+}
+
 std::vector<uint8_t> BigInt::to_bytes() const {
     std::vector<uint8_t> result(BN_num_bytes(value));
     BN_bn2bin(value, result.data());
@@ -232,6 +266,24 @@ namespace CryptoUtils {
         return hash_result % modulus;
     }
     
+    BigInt hash_to_prime(const BigInt& input) {
+        return HashToPrimeEngine::shared().prime_for(input);
+    }
+    
+    BigInt balanced_product(std::vector<BigInt> factors) {
+        if (factors.empty()) {
+            return BigInt("1");
+        }
+        while (factors.size() > 1) {
+            size_t half = 0;
+            for (size_t i = 0; i < factors.size(); i += 2) {
+                factors[half++] = i + 1 < factors.size() ? factors[i] * factors[i + 1] : std::move(factors[i]);
+            }
+            factors.resize(half);
+        }
+        return std::move(factors[0]);
+    }
+    
     bool miller_rabin(const BigInt& n, int rounds) {
         if (n.is_zero() || n.is_one()) return false;
         if (n == BigInt("2")) return true;
@@ -270,11 +322,17 @@ namespace CryptoUtils {
     }
     
     bool is_prime(const BigInt& n, int rounds) {
-        if (n < BigInt("2")) return false;
-        if (n == BigInt("2")) return true;
-        if (n % BigInt("2") == BigInt("0")) return false;
-        
-        return miller_rabin(n, rounds);
+        // 64位以内用确定性的Baillie-PSW，更大的数交给OpenSSL
+        if (n.fits_u64()) {
+            return HashToPrimeEngine::baillie_psw(n.to_u64());
+        }
+        BigIntArena::CtxGuard ctx;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        (void)rounds;
+        return BN_check_prime(n.get_const_bn(), ctx, nullptr) == 1;
+#else
+        return BN_is_prime_ex(n.get_const_bn(), rounds, ctx, nullptr) == 1;
+#endif
     }
     
     BigInt generate_prime(size_t bits) {
@@ -302,17 +360,32 @@ namespace CryptoUtils {
     
     BigInt mod_inverse(const BigInt& a, const BigInt& m) {
         BigInt result;
-        BN_CTX* ctx = BN_CTX_new();
+        BigIntArena::CtxGuard ctx;
         BN_mod_inverse(result.get_bn(), a.get_bn(), m.get_bn(), ctx);
-        BN_CTX_free(ctx);
         return result;
     }
     
     BigInt mod_pow(const BigInt& base, const BigInt& exp, const BigInt& mod) {
         BigInt result;
-        BN_CTX* ctx = BN_CTX_new();
+        BigIntArena::CtxGuard ctx;
         BN_mod_exp(result.get_bn(), base.get_bn(), exp.get_bn(), mod.get_bn(), ctx);
-        BN_CTX_free(ctx);
+        return result;
+    }
+    
+    BigInt mod_pow_secret(const BigInt& base, const BigInt& exp, const BigInt& mod) {
+        if (!BN_is_odd(mod.get_const_bn())) {
+            return mod_pow(base, exp, mod);
+        }
+        BigInt result;
+        BigInt reduced;
+        BigIntArena::CtxGuard ctx;
+        // 常数时间实现要求底数小于模数
+        BN_nnmod(reduced.get_bn(), base.get_bn(), mod.get_bn(), ctx);
+        // BN_FLG_CONSTTIME 无法清除，带标记的副本不能回到BigIntArena的池中，单独分配并清零释放
+        BIGNUM* secret_exp = BN_dup(exp.get_const_bn());
+        BN_set_flags(secret_exp, BN_FLG_CONSTTIME);
+        BN_mod_exp_mont_consttime(result.get_bn(), reduced.get_bn(), secret_exp, mod.get_bn(), ctx, nullptr);
+        BN_clear_free(secret_exp);
         return result;
     }
     
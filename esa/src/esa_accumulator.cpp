@@ -1,27 +1,65 @@
 #include "esa_accumulator.h"
+#include "fixed_base_table.h"
+#include "nonce_pool.h"
+#include "parallel.h"
+#include "secure_random.h"
 #include <iostream>
 #include <sstream>
+#include <iterator>
+#include <algorithm>
 
 // ESAAccumulator 实现
-ESAAccumulator::ESAAccumulator() 
-    : rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
+ESAAccumulator::ESAAccumulator(bool verbose) 
+    : wide_elements(0), sorted_dirty(false),
+      verbose(verbose), constant_time(true) {
     
     // 生成安全素数作为群阶
-    std::cout << "正在生成安全素数..." << std::endl;
+    if (verbose) {
+        std::cout << "正在生成安全素数..." << std::endl;
+    }
     group_order = CryptoUtils::generate_safe_prime(64);
-    std::cout << "安全素数生成完成: " << group_order.to_string() << std::endl;
+    if (verbose) {
+        std::cout << "安全素数生成完成: " << group_order.to_string() << std::endl;
+    }
     
     // 生成生成元
-    std::cout << "正在生成群生成元..." << std::endl;
+    if (verbose) {
+        std::cout << "正在生成群生成元..." << std::endl;
+    }
     generator = GroupElement::generator(group_order);
-    std::cout << "群生成元生成完成: " << generator.to_string() << std::endl;
+    if (verbose) {
+        std::cout << "群生成元生成完成: " << generator.to_string() << std::endl;
+    }
     
-    // 初始化累加器为单位元
-    accumulator_value = GroupElement::identity(group_order);
+    // Z_p^* 的阶为 p-1，所有指数运算都在这个阶下约简
+    exponent_order = group_order - BigInt("1");
     
-    std::cout << "ESA累加器初始化完成" << std::endl;
-    std::cout << "群阶: " << group_order.to_string() << std::endl;
-    std::cout << "生成元: " << generator.to_string() << std::endl;
+    // 初始化累加器为单位元（指数和为0），通用累加器为 h^1
+    accumulator_value = GroupElement::identity(group_order);
+    accumulator_stale = false;
+    universal_group = RSAGroup::rsa2048();
+    universal_value = universal_group.get_base();
+    universal_dirty = false;
+    reset_prime_tree();
+    
+    if (verbose) {
+        std::cout << "ESA累加器初始化完成" << std::endl;
+        std::cout << "群阶: " << group_order.to_string() << std::endl;
+        std::cout << "生成元: " << generator.to_string() << std::endl;
+    }
+}
+
+ESAAccumulator::ESAAccumulator(const BigInt& group_order, const GroupElement& generator, bool verbose)
+    : ESAAccumulator(group_order, generator, RSAGroup::rsa2048(), verbose) {}
+
+ESAAccumulator::ESAAccumulator(const BigInt& group_order, const GroupElement& generator,
+                               const RSAGroup& universal_group, bool verbose)
+    : generator(generator), group_order(group_order), exponent_order(group_order - BigInt("1")),
+      accumulator_stale(false), wide_elements(0), sorted_dirty(false),
+      universal_group(universal_group), universal_value(universal_group.get_base()), universal_dirty(false),
+      verbose(verbose), constant_time(true) {
+    accumulator_value = GroupElement::identity(group_order);
+    reset_prime_tree();
 }
 
 GroupElement ESAAccumulator::hash_to_group(const BigInt& input) {
@@ -35,7 +73,52 @@ BigInt ESAAccumulator::generate_random() {
 
 GroupElement ESAAccumulator::compute_commitment(const BigInt& element) {
     // 计算元素承诺: g^element mod group_order
-    return generator ^ element;
+    return generator_pow(element);
+}
+
+const FixedBaseTable& ESAAccumulator::generator_pow_table() const {
+    if (!generator_table) {
+        generator_table = FixedBaseTable::shared(generator, exponent_order.bit_length());
+    }
+    return *generator_table;
+}
+
+GroupElement ESAAccumulator::generator_pow(const BigInt& exponent) const {
+    return generator_pow_table().pow(exponent < exponent_order ? exponent : exponent % exponent_order);
+}
+
+GroupElement ESAAccumulator::generator_pow_secret(const BigInt& exponent) const {
+    return constant_time ? generator.pow_secret(exponent) : generator_pow(exponent);
+}
+
+void ESAAccumulator::next_nonce(BigInt& r, GroupElement& commitment) {
+    if (nonce_pool) {
+        NoncePool::Nonce nonce = nonce_pool->take();
+        r = std::move(nonce.r);
+        commitment = std::move(nonce.commitment);
+        return;
+    }
+    r = generate_random();
+    commitment = generator_pow_secret(r);
+}
+
+bool ESAAccumulator::set_nonce_pool(std::shared_ptr<NoncePool> pool) {
+    if (pool && (pool->get_generator() != generator || pool->get_exponent_order() != exponent_order)) {
+        if (verbose) {
+            std::cout << "随机数池的群参数与累加器不一致" << std::endl;
+        }
+        return false;
+    }
+    nonce_pool = std::move(pool);
+    return true;
+}
+
+const GroupElement& ESAAccumulator::get_accumulator_value() const {
+    if (accumulator_stale) {
+        accumulator_value = generator_pow(accumulator_exponent);
+        accumulator_stale = false;
+    }
+    return accumulator_value;
 }
 
 bool ESAAccumulator::verify_commitment(const GroupElement& commitment, const BigInt& element) {
@@ -43,85 +126,462 @@ bool ESAAccumulator::verify_commitment(const GroupElement& commitment, const Big
     return commitment == expected;
 }
 
+BigInt ESAAccumulator::prime_representative(const BigInt& element) const {
+    auto it = prime_slots.find(element);
+    return it != prime_slots.end() ? prime_tree[0][it->second] : CryptoUtils::hash_to_prime(element);
+}
+
+void ESAAccumulator::reset_prime_tree() {
+    // 空集时只有一个值为1的空闲叶子，根始终存在
+    prime_slots.clear();
+    pending_inserts.clear();
+    prime_tree.assign(1, std::vector<BigInt>(1, BigInt("1")));
+    free_slots.assign(1, 0);
+    dirty_slots.clear();
+}
+
+void ESAAccumulator::universal_insert(const BigInt& element) {
+    pending_inserts.insert(element);
+}
+
+void ESAAccumulator::flush_universal() const {
+    if (pending_inserts.empty()) {
+        return;
+    }
+    // 积压的新增元素在第一次读取U或u时统一求素数代表并放入叶子，先加后删的元素不产生任何开销
+    for (const auto& element : pending_inserts) {
+        place_prime(element, CryptoUtils::hash_to_prime(element));
+    }
+    pending_inserts.clear();
+}
+
+void ESAAccumulator::place_prime(const BigInt& element, const BigInt& prime) const {
+    size_t slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        prime_tree[0][slot] = prime;
+    } else {
+        slot = prime_tree[0].size();
+        prime_tree[0].push_back(prime);
+    }
+    prime_slots[element] = slot;
+    dirty_slots.push_back(slot);
+    
+    // 添加可以在使用时 U = U^(∏x) 一次补上，删除则要由 u 重新计算
+    if (!universal_dirty) {
+        pending_primes.push_back(prime);
+    }
+}
+
+void ESAAccumulator::universal_erase(const BigInt& element) {
+    // 还在积压中的元素尚未进入乘积树，直接撤销
+    if (pending_inserts.erase(element) > 0) {
+        return;
+    }
+    auto it = prime_slots.find(element);
+    if (it == prime_slots.end()) {
+        return;
+    }
+    prime_tree[0][it->second] = BigInt("1");
+    free_slots.push_back(it->second);
+    dirty_slots.push_back(it->second);
+    prime_slots.erase(it);
+    universal_dirty = true;
+}
+
+const BigInt& ESAAccumulator::universal_exponent() const {
+    flush_universal();
+    if (!dirty_slots.empty()) {
+        // 自底向上只重算变化叶子的祖先，新增的层和节点都在这些路径上
+        std::vector<size_t> dirty = std::move(dirty_slots);
+        dirty_slots.clear();
+        size_t level = 0;
+        while (prime_tree[level].size() > 1) {
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+            if (level + 1 == prime_tree.size()) {
+                prime_tree.emplace_back();
+            }
+            const std::vector<BigInt>& below = prime_tree[level];
+            std::vector<BigInt>& above = prime_tree[level + 1];
+            above.resize((below.size() + 1) / 2);
+            std::vector<size_t> parents;
+            parents.reserve(dirty.size());
+            for (size_t slot : dirty) {
+                size_t parent = slot / 2;
+                if (!parents.empty() && parents.back() == parent) {
+                    continue;
+                }
+                parents.push_back(parent);
+                size_t left = parent * 2;
+                above[parent] = left + 1 < below.size() ? below[left] * below[left + 1] : below[left];
+            }
+            dirty = std::move(parents);
+            level++;
+        }
+    }
+    if (universal_dirty) {
+        universal_value = universal_group.canonical(universal_group.get_base() ^ prime_tree.back()[0]);
+        universal_dirty = false;
+        pending_primes.clear();
+    } else if (!pending_primes.empty()) {
+        BigInt product = CryptoUtils::balanced_product(std::move(pending_primes));
+        universal_value = universal_group.canonical(universal_value ^ product);
+        pending_primes.clear();
+    }
+    return prime_tree.back()[0];
+}
+
+BigInt ESAAccumulator::prime_product(const std::vector<BigInt>& elements) const {
+    std::vector<BigInt> factors;
+    factors.reserve(elements.size());
+    for (const auto& element : elements) {
+        factors.push_back(prime_representative(element));
+    }
+    return CryptoUtils::balanced_product(std::move(factors));
+}
+
+const GroupElement& ESAAccumulator::current_universal() const {
+    universal_exponent();
+    return universal_value;
+}
+
+void ESAAccumulator::set_universal_group(const RSAGroup& group) {
+    universal_group = group;
+    universal_value = group.get_base();
+    universal_dirty = true;
+    pending_primes.clear();
+}
+
+const GroupElement& ESAAccumulator::get_universal_value() const {
+    return current_universal();
+}
+
+void ESAAccumulator::flush() const {
+    get_accumulator_value();
+    get_universal_value();
+    get_sorted_set();
+}
+
+BigInt ESAAccumulator::element_challenge(const char* domain, const GroupElement& commitment, const BigInt& element) const {
+    Transcript transcript(domain);
+    transcript.append_group_element("commitment", commitment);
+    transcript.append_group_element("accumulator", get_accumulator_value());
+    transcript.append_bigint("element", element);
+    return transcript.challenge("challenge", group_order);
+}
+
+BigInt ESAAccumulator::membership_exponent(const ZeroKnowledgeProof& proof, const BigInt& element) const {
+    return membership_exponent(proof.get_challenge(), proof.get_response(), element);
+}
+
+BigInt ESAAccumulator::membership_exponent(const BigInt& challenge, const BigInt& response,
+                                           const BigInt& element) const {
+    BigInt claimed = (challenge % exponent_order) * (element % exponent_order) % exponent_order;
+    return (response % exponent_order + exponent_order - claimed) % exponent_order;
+}
+
+Transcript ESAAccumulator::bundle_transcript(const GroupElement& accumulator) const {
+    Transcript transcript("esa-membership-bundle");
+    transcript.append_group_element("accumulator", accumulator);
+    return transcript;
+}
+
+std::vector<BigInt> ESAAccumulator::sorted_primes(const std::unordered_set<BigInt, BigInt::Hash>& set) const {
+    std::vector<BigInt> elements(set.begin(), set.end());
+    std::sort(elements.begin(), elements.end());
+    for (auto& element : elements) {
+        element = prime_representative(element);
+    }
+    return elements;
+}
+
+GroupElement ESAAccumulator::compute_set_digest(const std::unordered_set<BigInt, BigInt::Hash>& set) const {
+    // D(X) = h^(∏ prime(x))，空集的摘要为h
+    BigInt product = prime_product(std::vector<BigInt>(set.begin(), set.end()));
+    return universal_group.canonical(universal_group.get_base() ^ product);
+}
+
+GroupElement ESAAccumulator::compute_set_digest(const SortedElementSet& set) const {
+    std::vector<BigInt> elements;
+    elements.reserve(set.size());
+    for (uint64_t id : set) {
+        elements.push_back(BigInt::from_u64(id));
+    }
+    return universal_group.canonical(universal_group.get_base() ^ prime_product(elements));
+}
+
+void ESAAccumulator::prove_intersection(SetOperationResult& result,
+                                        const std::vector<std::vector<BigInt>>& remainders) {
+    result.proof = SetOperationProof(ProofType::INTERSECTION);
+    SetOperationProof& proof = result.proof;
+    BigIntArena::Scope scope;
+    const GroupElement& base = universal_group.get_base();
+    std::vector<BigInt> factors = sorted_primes(result.result_set);
+    BigInt r = CryptoUtils::balanced_product(factors);
+    
+    // 1. W_i = D(O_i \ R)，W_i^r = D(O_i) 说明结果是每个操作数的子集
+    for (const auto& remainder : remainders) {
+        GroupElement witness = universal_group.canonical(base ^ prime_product(remainder));
+        proof.subproofs.push_back(
+            ExponentiationProof::prove(universal_group, witness, factors, universal_group.canonical(witness ^ r)));
+        proof.witnesses.push_back(std::move(witness));
+    }
+    
+    // 2. 逐个合并Bezout系数，保持 Σ_{j<i} c_j·w_j = g，g 为前i个剩余部分公共元素的素数之积。
+    //    g = g'·x、w_i = g'·y 且 gcd(x, y) = 1，由 u·x + v·y = 1 得 u·g + v·w_i = g'
+    std::unordered_set<BigInt, BigInt::Hash> common(remainders[0].begin(), remainders[0].end());
+    std::vector<BigInt> coefficients(remainders.size());
+    coefficients[0] = BigInt("1");
+    for (size_t i = 1; i < remainders.size() && !common.empty(); i++) {
+        std::unordered_set<BigInt, BigInt::Hash> shared;
+        std::vector<BigInt> others;
+        for (const auto& element : remainders[i]) {
+            if (common.find(element) != common.end()) {
+                shared.insert(element);
+            } else {
+                others.push_back(element);
+            }
+        }
+        std::vector<BigInt> dropped;
+        for (const auto& element : common) {
+            if (shared.find(element) == shared.end()) {
+                dropped.push_back(element);
+            }
+        }
+        BigInt x = prime_product(dropped);
+        BigInt y = prime_product(others);
+        BigInt u = y.is_one() ? BigInt() : CryptoUtils::mod_inverse(x % y, y);
+        BigInt v = (BigInt("1") - u * x) / y;
+        for (size_t j = 0; j < i; j++) {
+            coefficients[j] = coefficients[j] * u;
+        }
+        coefficients[i] = v;
+        common = std::move(shared);
+    }
+    if (!common.empty()) {
+        if (verbose) {
+            std::cout << "剩余部分仍有公共元素，无法生成交集证明" << std::endl;
+        }
+        return;
+    }
+    
+    // 3. E_i = W_i^|c_i|，∏_{c_i>0} E_i = h·∏_{c_i<0} E_i
+    for (size_t i = 0; i < remainders.size(); i++) {
+        BigInt& coefficient = coefficients[i];
+        if (coefficient.is_zero()) {
+            proof.signs.push_back(0);
+            proof.terms.push_back(GroupElement());
+            continue;
+        }
+        proof.signs.push_back(BN_is_negative(coefficient.get_const_bn()) ? -1 : 1);
+        BN_set_negative(coefficient.get_bn(), 0);
+        GroupElement term = universal_group.canonical(proof.witnesses[i] ^ coefficient);
+        proof.subproofs.push_back(
+            ExponentiationProof::prove_knowledge(universal_group, proof.witnesses[i], coefficient, term));
+        proof.terms.push_back(std::move(term));
+    }
+    
+    proof.is_valid = true;
+    result.is_valid = true;
+}
+
 bool ESAAccumulator::add_element(const BigInt& element) {
     if (current_set.find(element) != current_set.end()) {
-        std::cout << "元素 " << element.to_string() << " 已存在于集合中" << std::endl;
+        if (verbose) {
+            std::cout << "元素 " << element.to_string() << " 已存在于集合中" << std::endl;
+        }
         return false;
     }
     
     // 添加元素到集合
     current_set.insert(element);
+    sorted_dirty = true;
     
-    // 计算新的累加器值: A = A^element mod group_order
-    GroupElement element_commitment = compute_commitment(element);
-    element_commitments[element] = element_commitment;
+    universal_insert(element);
     
-    // 更新累加器值: A = A * g^element mod group_order
-    GroupElement element_power = generator ^ element;
-    BigInt new_value = (accumulator_value.get_value() * element_power.get_value()) % group_order;
-    accumulator_value = GroupElement(new_value, group_order);
+    // 更新累加器指数: A·g^element 对应 Σx + element
+    accumulator_exponent = (accumulator_exponent + element) % exponent_order;
+    accumulator_stale = true;
     
-    std::cout << "成功添加元素: " << element.to_string() << std::endl;
-    std::cout << "新累加器值: " << accumulator_value.to_string() << std::endl;
+    if (verbose) {
+        std::cout << "成功添加元素: " << element.to_string() << std::endl;
+    }
     return true;
 }
 
 bool ESAAccumulator::remove_element(const BigInt& element) {
     auto it = current_set.find(element);
     if (it == current_set.end()) {
-        std::cout << "元素 " << element.to_string() << " 不存在于集合中" << std::endl;
+        if (verbose) {
+            std::cout << "元素 " << element.to_string() << " 不存在于集合中" << std::endl;
+        }
         return false;
     }
     
     // 从集合中移除元素
     current_set.erase(it);
-    element_commitments.erase(element);
+    sorted_dirty = true;
+    universal_erase(element);
     
-    // 重新计算累加器值
-    accumulator_value = GroupElement::identity(group_order);
-    for (const auto& elem : current_set) {
-        GroupElement element_power = generator ^ elem;
-        BigInt new_value = (accumulator_value.get_value() * element_power.get_value()) % group_order;
-        accumulator_value = GroupElement(new_value, group_order);
-    }
+    // 更新累加器指数: Σx - element
+    accumulator_exponent = (accumulator_exponent + exponent_order - element % exponent_order) % exponent_order;
+    accumulator_stale = true;
     
-    std::cout << "成功移除元素: " << element.to_string() << std::endl;
-    std::cout << "新累加器值: " << accumulator_value.to_string() << std::endl;
+    if (verbose) {
+        std::cout << "成功移除元素: " << element.to_string() << std::endl;
+    }
     return true;
 }
 
+size_t ESAAccumulator::add_elements(const std::vector<BigInt>& elements) {
+    // 累加器乘上 ∏g^x，在指数域中就是先求和、最后约简一次
+    BigInt sum;
+    size_t added = 0;
+    for (const auto& element : elements) {
+        if (!current_set.insert(element).second) {
+            continue;
+        }
+        sum += element;
+        universal_insert(element);
+        added++;
+    }
+    if (added == 0) {
+        return 0;
+    }
+    sorted_dirty = true;
+    
+    accumulator_exponent = (accumulator_exponent + sum) % exponent_order;
+    accumulator_stale = true;
+    
+    if (verbose) {
+        std::cout << "批量添加 " << added << " 个元素" << std::endl;
+    }
+    return added;
+}
+
+size_t ESAAccumulator::add_elements(const std::vector<BigInt>& elements, std::vector<BigInt>& applied,
+                                    ExponentiationProof& proof) {
+    applied.clear();
+    std::unordered_set<BigInt, BigInt::Hash> seen;
+    for (const auto& element : elements) {
+        if (!contains(element) && seen.insert(element).second) {
+            applied.push_back(element);
+        }
+    }
+    GroupElement previous = get_universal_value();
+    size_t added = add_elements(applied);
+    
+    BigIntArena::Scope scope;
+    std::vector<BigInt> primes;
+    primes.reserve(applied.size());
+    for (const auto& element : applied) {
+        primes.push_back(prime_representative(element));
+    }
+    proof = ExponentiationProof::prove(universal_group, previous, primes, get_universal_value());
+    return added;
+}
+
+size_t ESAAccumulator::remove_elements(const std::vector<BigInt>& elements, std::vector<BigInt>& applied,
+                                       ExponentiationProof& proof) {
+    applied.clear();
+    std::unordered_set<BigInt, BigInt::Hash> seen;
+    for (const auto& element : elements) {
+        if (contains(element) && seen.insert(element).second) {
+            applied.push_back(element);
+        }
+    }
+    GroupElement previous = get_universal_value();
+    
+    BigIntArena::Scope scope;
+    std::vector<BigInt> primes;
+    primes.reserve(applied.size());
+    for (const auto& element : applied) {
+        primes.push_back(prime_representative(element));
+    }
+    size_t removed = remove_elements(applied);
+    
+    // 删除时证明方向相反：新值的 ∏x 次幂回到旧值
+    proof = ExponentiationProof::prove(universal_group, get_universal_value(), primes, previous);
+    return removed;
+}
+
+bool ESAAccumulator::verify_batch_update(const RSAGroup& group, const GroupElement& previous,
+                                         const GroupElement& current, const std::vector<BigInt>& applied,
+                                         bool is_addition, const ExponentiationProof& proof) {
+    BigIntArena::Scope scope;
+    std::vector<BigInt> primes;
+    primes.reserve(applied.size());
+    for (const auto& element : applied) {
+        primes.push_back(CryptoUtils::hash_to_prime(element));
+    }
+    return is_addition ? ExponentiationProof::verify(group, previous, primes, current, proof)
+                       : ExponentiationProof::verify(group, current, primes, previous, proof);
+}
+
+size_t ESAAccumulator::remove_elements(const std::vector<BigInt>& elements) {
+    // 被移除元素之和从指数中减去，不需要模逆
+    BigInt sum;
+    size_t removed = 0;
+    for (const auto& element : elements) {
+        auto it = current_set.find(element);
+        if (it == current_set.end()) {
+            continue;
+        }
+        sum += element;
+        current_set.erase(it);
+        universal_erase(element);
+        removed++;
+    }
+    if (removed == 0) {
+        return 0;
+    }
+    sorted_dirty = true;
+    
+    accumulator_exponent = (accumulator_exponent + exponent_order - sum % exponent_order) % exponent_order;
+    accumulator_stale = true;
+    
+    if (verbose) {
+        std::cout << "批量移除 " << removed << " 个元素" << std::endl;
+    }
+    return removed;
+}
+
 bool ESAAccumulator::update_element(const BigInt& old_element, const BigInt& new_element) {
     // 检查旧元素是否存在
     if (current_set.find(old_element) == current_set.end()) {
-        std::cout << "元素 " << old_element.to_string() << " 不存在于集合中，无法修改" << std::endl;
+        if (verbose) {
+            std::cout << "元素 " << old_element.to_string() << " 不存在于集合中，无法修改" << std::endl;
+        }
         return false;
     }
     
     // 检查新元素是否已存在
     if (current_set.find(new_element) != current_set.end()) {
-        std::cout << "元素 " << new_element.to_string() << " 已存在于集合中，无法修改" << std::endl;
+        if (verbose) {
+            std::cout << "元素 " << new_element.to_string() << " 已存在于集合中，无法修改" << std::endl;
+        }
         return false;
     }
     
     // 删除旧元素
     current_set.erase(old_element);
-    element_commitments.erase(old_element);
+    universal_erase(old_element);
     
     // 添加新元素
     current_set.insert(new_element);
-    GroupElement element_commitment = compute_commitment(new_element);
-    element_commitments[new_element] = element_commitment;
+    sorted_dirty = true;
+    universal_insert(new_element);
     
-    // 重新计算累加器值
-    accumulator_value = GroupElement::identity(group_order);
-    for (const auto& elem : current_set) {
-        GroupElement element_power = generator ^ elem;
-        BigInt new_value = (accumulator_value.get_value() * element_power.get_value()) % group_order;
-        accumulator_value = GroupElement(new_value, group_order);
-    }
+    // 更新累加器指数: Σx - old + new
+    accumulator_exponent = (accumulator_exponent + exponent_order - old_element % exponent_order + new_element) %
+                           exponent_order;
+    accumulator_stale = true;
     
-    std::cout << "成功修改元素: " << old_element.to_string() << " -> " << new_element.to_string() << std::endl;
-    std::cout << "新累加器值: " << accumulator_value.to_string() << std::endl;
+    if (verbose) {
+        std::cout << "成功修改元素: " << old_element.to_string() << " -> " << new_element.to_string() << std::endl;
+    }
     return true;
 }
 
@@ -129,196 +589,342 @@ bool ESAAccumulator::contains(const BigInt& element) const {
     return current_set.find(element) != current_set.end();
 }
 
+const SortedElementSet& ESAAccumulator::get_sorted_set() const {
+    // 集合修改后只标记脏位，读取时一次性排序重建，避免每次插入移动整列
+    if (sorted_dirty) {
+        SortedElementSet::from_set(current_set, sorted_set);
+        wide_elements = current_set.size() - sorted_set.size();
+        sorted_dirty = false;
+    }
+    return sorted_set;
+}
+
 ZeroKnowledgeProof ESAAccumulator::generate_membership_proof(const BigInt& element) {
     ZeroKnowledgeProof proof(ProofType::MEMBERSHIP);
     
     if (!contains(element)) {
-        std::cout << "元素 " << element.to_string() << " 不在集合中，无法生成成员关系证明" << std::endl;
+        if (verbose) {
+            std::cout << "元素 " << element.to_string() << " 不在集合中，无法生成成员关系证明" << std::endl;
+        }
         return proof;
     }
     
     // 生成零知识成员关系证明
     // 使用Fiat-Shamir变换的非交互式证明
     
-    // 1. 生成随机数
-    BigInt r = generate_random();
+    // 1-2. 随机数 r 和承诺 C = g^r mod n（有预计算池时直接取出）
+    BigInt r;
+    GroupElement commitment;
+    next_nonce(r, commitment);
     proof.set_randomness(r);
-    
-    // 2. 计算承诺 C = g^r mod n
-    GroupElement commitment = generator ^ r;
     proof.set_commitment(commitment);
     
     // 3. 计算挑战 c = H(C || A || element)
-    BigInt challenge_input = CryptoUtils::sha256(
-        commitment.get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        element.to_string()
-    );
-    BigInt challenge = challenge_input % group_order;
+    BigInt challenge = element_challenge("esa-membership", commitment, element);
     proof.set_challenge(challenge);
     
-    // 4. 计算响应 s = r + c * element mod group_order
-    BigInt response = (r + challenge * element) % group_order;
+    // 4. 计算响应 s = r + c * element mod ord
+    BigInt response = (r + challenge * element) % exponent_order;
     proof.set_response(response);
     
     proof.set_valid(true);
     
-    std::cout << "生成成员关系证明: " << element.to_string() << std::endl;
+    if (verbose) {
+        std::cout << "生成成员关系证明: " << element.to_string() << std::endl;
+    }
     return proof;
 }
 
-ZeroKnowledgeProof ESAAccumulator::generate_non_membership_proof(const BigInt& element) {
-    ZeroKnowledgeProof proof(ProofType::NON_MEMBERSHIP);
-    
-    if (contains(element)) {
-        std::cout << "元素 " << element.to_string() << " 在集合中，无法生成非成员关系证明" << std::endl;
-        return proof;
+MembershipProofBundle ESAAccumulator::generate_membership_proofs(const std::vector<BigInt>& elements, size_t threads) {
+    MembershipProofBundle bundle;
+    for (const auto& element : elements) {
+        if (!contains(element)) {
+            if (verbose) {
+                std::cout << "元素 " << element.to_string() << " 不在集合中，无法生成成员关系证明包" << std::endl;
+            }
+            return bundle;
+        }
+    }
+    BigIntArena::Scope scope;
+    size_t n = elements.size();
+    bundle.accumulator = get_accumulator_value();
+    
+    // 1. 整批取随机数；有预计算池时承诺也一并取出
+    std::vector<BigInt> nonces;
+    bundle.commitments.resize(n);
+    if (nonce_pool) {
+        nonces.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            next_nonce(nonces[i], bundle.commitments[i]);
+        }
+    } else {
+        nonces = SecureRandom::local().uniform_batch(BigInt("1"), exponent_order, n);
     }
     
-    // 生成零知识非成员关系证明
-    // 证明元素不在集合中，即不存在见证使得 g^witness = A
+    // 2. 共同前缀只吸收一次，之后每个证明复制中间状态
+    const Transcript prefix = bundle_transcript(bundle.accumulator);
+    const FixedBaseTable* table = constant_time ? nullptr : &generator_pow_table();
+    bundle.responses.resize(n);
+    // 3. 分段并行，调用线程处理第一段
+    Parallel::ranges(n, threads, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (!nonce_pool) {
+                bundle.commitments[i] = table ? table->pow(nonces[i]) : generator.pow_secret(nonces[i]);
+            }
+            Transcript transcript(prefix);
+            transcript.append_group_element("commitment", bundle.commitments[i]);
+            transcript.append_bigint("element", elements[i]);
+            BigInt challenge = transcript.challenge("challenge", group_order);
+            bundle.responses[i] = (nonces[i] + challenge * elements[i]) % exponent_order;
+        }
+    });
     
-    // 1. 生成随机数
-    BigInt r = generate_random();
-    proof.set_randomness(r);
+    bundle.is_valid = true;
+    if (verbose) {
+        std::cout << "生成成员关系证明包: " << n << " 个元素" << std::endl;
+    }
+    return bundle;
+}
+
+ZeroKnowledgeProof ESAAccumulator::generate_non_membership_proof(const BigInt& element) {
+    if (contains(element)) {
+        if (verbose) {
+            std::cout << "元素 " << element.to_string() << " 在集合中，无法生成非成员关系证明" << std::endl;
+        }
+        return ZeroKnowledgeProof(ProofType::NON_MEMBERSHIP);
+    }
     
-    // 2. 计算承诺 C = g^r mod n
-    GroupElement commitment = generator ^ r;
-    proof.set_commitment(commitment);
+    ZeroKnowledgeProof proof = generate_non_membership_proofs({element}).front();
     
-    // 3. 计算挑战 c = H(C || A || element)
-    BigInt challenge_input = CryptoUtils::sha256(
-        commitment.get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        element.to_string()
-    );
-    BigInt challenge = challenge_input % group_order;
-    proof.set_challenge(challenge);
+    if (verbose) {
+        std::cout << "生成非成员关系证明: " << element.to_string() << std::endl;
+    }
+    return proof;
+}
+
+std::vector<ZeroKnowledgeProof> ESAAccumulator::generate_non_membership_proofs(const std::vector<BigInt>& elements) {
+    std::vector<ZeroKnowledgeProof> proofs(elements.size(), ZeroKnowledgeProof(ProofType::NON_MEMBERSHIP));
+    if (elements.empty()) {
+        return proofs;
+    }
+    BigIntArena::Scope scope;
     
-    // 4. 计算响应 s = r + c * (group_order - element) mod group_order
-    BigInt response = (r + challenge * (group_order - element)) % group_order;
-    proof.set_response(response);
+    // 乘积树：levels[0]为各元素的素数代表，levels.back()[0]为 X = ∏x_i
+    std::vector<std::vector<BigInt>> levels(1);
+    levels[0].reserve(elements.size());
+    for (const auto& element : elements) {
+        levels[0].push_back(prime_representative(element));
+    }
+    while (levels.back().size() > 1) {
+        const std::vector<BigInt>& below = levels.back();
+        std::vector<BigInt> above;
+        above.reserve((below.size() + 1) / 2);
+        for (size_t i = 0; i + 1 < below.size(); i += 2) {
+            above.push_back(below[i] * below[i + 1]);
+        }
+        if (below.size() % 2 == 1) {
+            above.push_back(below.back());
+        }
+        levels.push_back(std::move(above));
+    }
     
-    proof.set_valid(true);
+    // 自顶向下的余数树：每个节点 N 保存 h_N = h^(u div N) 和 R_N = u mod N，
+    // 子节点 L（兄弟 S）由 u div L = (u div N)·S + (R_N div L) 得到 h_L = h_N^S · h^(R_N div L)
+    const GroupElement& base = universal_group.get_base();
+    const BigInt& u = universal_exponent();
+    std::vector<GroupElement> powers{base ^ (u / levels.back()[0])};
+    std::vector<BigInt> remainders{u % levels.back()[0]};
+    for (size_t level = levels.size() - 1; level > 0; level--) {
+        const std::vector<BigInt>& children = levels[level - 1];
+        std::vector<GroupElement> child_powers(children.size());
+        std::vector<BigInt> child_remainders(children.size());
+        for (size_t parent = 0; parent < powers.size(); parent++) {
+            size_t left = parent * 2;
+            if (left + 1 >= children.size()) {
+                // 落单的节点直接继承
+                child_powers[left] = powers[parent];
+                child_remainders[left] = remainders[parent];
+                continue;
+            }
+            for (size_t side = 0; side < 2; side++) {
+                const BigInt& node = children[left + side];
+                const BigInt& sibling = children[left + 1 - side];
+                child_powers[left + side] = CryptoUtils::multi_exp({powers[parent], base},
+                                                                   {sibling, remainders[parent] / node});
+                child_remainders[left + side] = remainders[parent] % node;
+            }
+        }
+        powers = std::move(child_powers);
+        remainders = std::move(child_remainders);
+    }
     
-    std::cout << "生成非成员关系证明: " << element.to_string() << std::endl;
-    return proof;
+    // 叶子：h_x = h^(u div x)，r = u mod x，Bezout系数 a = r^-1 mod x，
+    // a·u - 1 = a·x·(u div x) + (a·r - 1)，故 d = h_x^a · h^((a·r-1)/x)
+    for (size_t i = 0; i < elements.size(); i++) {
+        const BigInt& x = levels[0][i];
+        const BigInt& r = remainders[i];
+        if (r.is_zero() || contains(elements[i])) {
+            continue;
+        }
+        BigInt a = CryptoUtils::mod_inverse(r, x);
+        BigInt t = (a * r - BigInt("1")) / x;
+        GroupElement d = universal_group.canonical(CryptoUtils::multi_exp({powers[i], base}, {a, t}));
+        
+        ZeroKnowledgeProof& proof = proofs[i];
+        proof.set_commitment(d);
+        proof.set_response(a);
+        proof.add_auxiliary_data(get_universal_value());
+        proof.set_valid(true);
+    }
+    return proofs;
 }
 
 
 BigInt ESAAccumulator::generate_witness(const BigInt& element) {
     if (!contains(element)) {
-        std::cout << "元素不在集合中，无法生成见证" << std::endl;
+        if (verbose) {
+            std::cout << "元素不在集合中，无法生成见证" << std::endl;
+        }
         return BigInt("0");
     }
     
-    // 生成见证：计算除当前元素外所有元素的乘积
-    BigInt witness = BigInt("1");
-    for (const auto& elem : current_set) {
-        if (elem != element) {
-            GroupElement elem_power = generator ^ elem;
-            witness = (witness * elem_power.get_value()) % group_order;
-        }
-    }
+    // 生成见证：除当前元素外所有元素的乘积 g^(Σx - element)
+    BigInt exponent = (accumulator_exponent + exponent_order - element % exponent_order) % exponent_order;
+    BigInt witness = generator_pow(exponent).get_value();
     
-    std::cout << "生成见证: " << element.to_string() << std::endl;
+    if (verbose) {
+        std::cout << "生成见证: " << element.to_string() << std::endl;
+    }
     return witness;
 }
 
 bool ESAAccumulator::update_witness(BigInt& witness, const BigInt& element, bool is_addition) {
     if (is_addition) {
         // 添加元素时更新见证
-        GroupElement elem_power = generator ^ element;
+        GroupElement elem_power = generator_pow(element);
         witness = (witness * elem_power.get_value()) % group_order;
     } else {
         // 删除元素时更新见证
-        GroupElement elem_power = generator ^ element;
+        GroupElement elem_power = generator_pow(element);
         BigInt elem_inv = CryptoUtils::mod_inverse(elem_power.get_value(), group_order);
         witness = (witness * elem_inv) % group_order;
     }
     
-    std::cout << "更新见证: " << element.to_string() << " (" << (is_addition ? "添加" : "删除") << ")" << std::endl;
+    if (verbose) {
+        std::cout << "更新见证: " << element.to_string() << " (" << (is_addition ? "添加" : "删除") << ")" << std::endl;
+    }
     return true;
 }
 
+GroupElement ESAAccumulator::generate_aggregate_witness(const std::vector<BigInt>& elements) {
+    for (const auto& element : elements) {
+        if (!contains(element)) {
+            if (verbose) {
+                std::cout << "元素 " << element.to_string() << " 不在集合中，无法生成聚合见证" << std::endl;
+            }
+            return GroupElement();
+        }
+    }
+    BigIntArena::Scope scope;
+    
+    // 一次除法和一次模幂，代替|K|次逐个生成
+    BigInt quotient = universal_exponent() / prime_product(elements);
+    GroupElement witness = universal_group.canonical(universal_group.get_base() ^ quotient);
+    
+    if (verbose) {
+        std::cout << "生成聚合见证: " << elements.size() << " 个元素" << std::endl;
+    }
+    return witness;
+}
+
+GroupElement ESAAccumulator::combine_aggregate_witnesses(const GroupElement& witness1, const std::vector<BigInt>& elements1,
+                                                         const GroupElement& witness2, const std::vector<BigInt>& elements2) const {
+    if (!universal_group.contains(witness1) || !universal_group.contains(witness2)) {
+        return GroupElement();
+    }
+    if (elements1.empty() || elements2.empty()) {
+        return elements1.empty() ? witness2 : witness1;
+    }
+    BigIntArena::Scope scope;
+    BigInt x1 = prime_product(elements1);
+    BigInt x2 = prime_product(elements2);
+    
+    // a·x1 + b·x2 = 1，W = W1^b · W2^a 满足 W^(x1·x2) = U^(b·x2) · U^(a·x1) = U
+    BigInt a = CryptoUtils::mod_inverse(x1 % x2, x2);
+    if (a.is_zero()) {
+        return GroupElement();  // gcd(x1, x2) != 1
+    }
+    // b = (1 - a·x1)/x2 <= 0，用 W1 的逆元和 -b 做指数
+    BigInt minus_b = (a * x1 - BigInt("1")) / x2;
+    return universal_group.canonical(CryptoUtils::multi_exp({witness1.inverse(), witness2}, {minus_b, a}));
+}
+
 SetOperationResult ESAAccumulator::compute_union(const std::unordered_set<BigInt, BigInt::Hash>& other_set) {
     SetOperationResult result;
     
     // 计算并集
     result.result_set = current_set;
-    for (const auto& elem : other_set) {
-        result.result_set.insert(elem);
+    result.result_set.insert(other_set.begin(), other_set.end());
+    
+    // 生成并集证明：按升序标注每个结果元素所属的操作数，两侧各自的素数之积对上操作数摘要
+    result.proof = SetOperationProof(ProofType::UNION);
+    std::vector<BigInt> sorted(result.result_set.begin(), result.result_set.end());
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<BigInt> current_factors;
+    std::vector<BigInt> other_factors;
+    for (const auto& elem : sorted) {
+        uint8_t label = (current_set.count(elem) ? 1 : 0) | (other_set.count(elem) ? 2 : 0);
+        result.proof.labels.push_back(label);
+        BigInt prime = prime_representative(elem);
+        if (label & 1) {
+            current_factors.push_back(prime);
+        }
+        if (label & 2) {
+            other_factors.push_back(prime);
+        }
     }
-    
-    // 生成并集证明
-    result.proof = ZeroKnowledgeProof(ProofType::UNION);
-    
-    // 1. 生成随机数
-    BigInt r = generate_random();
-    result.proof.set_randomness(r);
-    
-    // 2. 计算承诺
-    GroupElement commitment = generator ^ r;
-    result.proof.set_commitment(commitment);
-    
-    // 3. 计算挑战
-    BigInt challenge_input = CryptoUtils::sha256(
-        commitment.get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        "union"
-    );
-    BigInt challenge = challenge_input % group_order;
-    result.proof.set_challenge(challenge);
-    
-    // 4. 计算响应
-    BigInt response = (r + challenge * BigInt(std::to_string(result.result_set.size()))) % group_order;
-    result.proof.set_response(response);
-    
-    result.proof.set_valid(true);
+    const GroupElement& base = universal_group.get_base();
+    GroupElement other_digest = universal_group.canonical(base ^ CryptoUtils::balanced_product(other_factors));
+    result.proof.subproofs.push_back(
+        ExponentiationProof::prove(universal_group, base, current_factors, get_universal_value()));
+    result.proof.subproofs.push_back(ExponentiationProof::prove(universal_group, base, other_factors, other_digest));
+    result.proof.is_valid = true;
     result.is_valid = true;
     
-    std::cout << "计算并集完成，结果大小: " << result.result_set.size() << std::endl;
+    if (verbose) {
+        std::cout << "计算并集完成，结果大小: " << result.result_set.size() << std::endl;
+    }
     return result;
 }
 
 SetOperationResult ESAAccumulator::compute_intersection(const std::unordered_set<BigInt, BigInt::Hash>& other_set) {
     SetOperationResult result;
     
-    // 计算交集
+    // 计算交集，同时收集两侧的剩余部分作为子集见证
+    std::unordered_set<BigInt, BigInt::Hash> current_only;
     for (const auto& elem : current_set) {
         if (other_set.find(elem) != other_set.end()) {
             result.result_set.insert(elem);
+        } else {
+            current_only.insert(elem);
+        }
+    }
+    std::unordered_set<BigInt, BigInt::Hash> other_only;
+    for (const auto& elem : other_set) {
+        if (result.result_set.find(elem) == result.result_set.end()) {
+            other_only.insert(elem);
         }
     }
     
-    // 生成交集证明
-    result.proof = ZeroKnowledgeProof(ProofType::INTERSECTION);
-    
-    // 1. 生成随机数
-    BigInt r = generate_random();
-    result.proof.set_randomness(r);
-    
-    // 2. 计算承诺
-    GroupElement commitment = generator ^ r;
-    result.proof.set_commitment(commitment);
-    
-    // 3. 计算挑战
-    BigInt challenge_input = CryptoUtils::sha256(
-        commitment.get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        "intersection"
-    );
-    BigInt challenge = challenge_input % group_order;
-    result.proof.set_challenge(challenge);
-    
-    // 4. 计算响应
-    BigInt response = (r + challenge * BigInt(std::to_string(result.result_set.size()))) % group_order;
-    result.proof.set_response(response);
-    
-    result.proof.set_valid(true);
-    result.is_valid = true;
+    // 生成交集证明：两侧去掉结果后的剩余部分
+    prove_intersection(result, {
+        std::vector<BigInt>(current_only.begin(), current_only.end()),
+        std::vector<BigInt>(other_only.begin(), other_only.end())
+    });
     
-    std::cout << "计算交集完成，结果大小: " << result.result_set.size() << std::endl;
+    if (verbose) {
+        std::cout << "计算交集完成，结果大小: " << result.result_set.size() << std::endl;
+    }
     return result;
 }
 
@@ -326,40 +932,21 @@ SetOperationResult ESAAccumulator::compute_difference(const std::unordered_set<B
     SetOperationResult result;
     
     // 计算差集
+    std::unordered_set<BigInt, BigInt::Hash> common;
     for (const auto& elem : current_set) {
         if (other_set.find(elem) == other_set.end()) {
             result.result_set.insert(elem);
+        } else {
+            common.insert(elem);
         }
     }
     
     // 生成差集证明
-    result.proof = ZeroKnowledgeProof(ProofType::DIFFERENCE);
-    
-    // 1. 生成随机数
-    BigInt r = generate_random();
-    result.proof.set_randomness(r);
-    
-    // 2. 计算承诺
-    GroupElement commitment = generator ^ r;
-    result.proof.set_commitment(commitment);
-    
-    // 3. 计算挑战
-    BigInt challenge_input = CryptoUtils::sha256(
-        commitment.get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        "difference"
-    );
-    BigInt challenge = challenge_input % group_order;
-    result.proof.set_challenge(challenge);
-    
-    // 4. 计算响应
-    BigInt response = (r + challenge * BigInt(std::to_string(result.result_set.size()))) % group_order;
-    result.proof.set_response(response);
-    
-    result.proof.set_valid(true);
-    result.is_valid = true;
+    prove_difference(result, ProofType::DIFFERENCE, other_set, common);
     
-    std::cout << "计算差集完成，结果大小: " << result.result_set.size() << std::endl;
+    if (verbose) {
+        std::cout << "计算差集完成，结果大小: " << result.result_set.size() << std::endl;
+    }
     return result;
 }
 
@@ -367,40 +954,103 @@ SetOperationResult ESAAccumulator::compute_complement(const std::unordered_set<B
     SetOperationResult result;
     
     // 计算补集: current_set - other_set (当前集合中不在other_set中的元素)
+    std::unordered_set<BigInt, BigInt::Hash> common;
     for (const auto& elem : current_set) {
         if (other_set.find(elem) == other_set.end()) {
             result.result_set.insert(elem);
+        } else {
+            common.insert(elem);
         }
     }
     
     // 生成补集证明
-    result.proof = ZeroKnowledgeProof(ProofType::COMPLEMENT);
-    
-    // 1. 生成随机数
-    BigInt r = generate_random();
-    result.proof.set_randomness(r);
-    
-    // 2. 计算承诺
-    GroupElement commitment = generator ^ r;
-    result.proof.set_commitment(commitment);
-    
-    // 3. 计算挑战
-    BigInt challenge_input = CryptoUtils::sha256(
-        commitment.get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        "complement"
-    );
-    BigInt challenge = challenge_input % group_order;
-    result.proof.set_challenge(challenge);
-    
-    // 4. 计算响应
-    BigInt response = (r + challenge * BigInt(std::to_string(result.result_set.size()))) % group_order;
-    result.proof.set_response(response);
-    
-    result.proof.set_valid(true);
+    prove_difference(result, ProofType::COMPLEMENT, other_set, common);
+    
+    if (verbose) {
+        std::cout << "计算补集完成，结果大小: " << result.result_set.size() << std::endl;
+    }
+    return result;
+}
+
+void ESAAccumulator::prove_difference(SetOperationResult& result, ProofType type,
+                                      const std::unordered_set<BigInt, BigInt::Hash>& other_set,
+                                      const std::unordered_set<BigInt, BigInt::Hash>& common) {
+    result.proof = SetOperationProof(type);
+    SetOperationProof& proof = result.proof;
+    BigIntArena::Scope scope;
+    const GroupElement& base = universal_group.get_base();
+    std::vector<BigInt> factors = sorted_primes(result.result_set);
+    BigInt r = CryptoUtils::balanced_product(factors);
+    
+    std::vector<BigInt> other_only;
+    for (const auto& elem : other_set) {
+        if (common.find(elem) == common.end()) {
+            other_only.push_back(elem);
+        }
+    }
+    BigInt w = prime_product(std::vector<BigInt>(common.begin(), common.end()));
+    BigInt f = prime_product(other_only);
+    BigInt t = w * f;
+    GroupElement other_digest = universal_group.canonical(base ^ t);
+    
+    // 1. W = D(S∩T)：W^r = D(S) 说明结果在S中，W^f = D(T) 说明S的其余部分都在T中
+    GroupElement witness = universal_group.canonical(base ^ w);
+    proof.subproofs.push_back(ExponentiationProof::prove(universal_group, witness, factors, get_universal_value()));
+    proof.subproofs.push_back(ExponentiationProof::prove_knowledge(universal_group, witness, f, other_digest));
+    proof.witnesses.push_back(std::move(witness));
+    
+    // 2. 结果与T不相交：α = r^-1 mod t，β = (α·r - 1)/t，E = D(T)^β，A = h^α 满足 A^r = h·E
+    BigInt alpha = t.is_one() ? BigInt("1") : CryptoUtils::mod_inverse(r % t, t);
+    BigInt beta = (alpha * r - BigInt("1")) / t;
+    GroupElement term = universal_group.canonical(other_digest ^ beta);
+    GroupElement root = universal_group.canonical(base ^ alpha);
+    proof.subproofs.push_back(ExponentiationProof::prove_knowledge(universal_group, other_digest, beta, term));
+    proof.subproofs.push_back(
+        ExponentiationProof::prove(universal_group, root, factors, universal_group.canonical(base * term)));
+    proof.terms = {std::move(term), std::move(root)};
+    
+    proof.is_valid = true;
     result.is_valid = true;
+}
+
+SetOperationResult ESAAccumulator::compute_multi_intersection(const std::vector<const SortedElementSet*>& other_sets) {
+    SetOperationResult result;
     
-    std::cout << "计算补集完成，结果大小: " << result.result_set.size() << std::endl;
+    if (!sorted_set_complete()) {
+        if (verbose) {
+            std::cout << "集合中存在超过64位的元素，无法进行多路交集" << std::endl;
+        }
+        return result;
+    }
+    
+    // 计算多路交集（当前集合作为其中一个操作数）
+    std::vector<const SortedElementSet*> operands;
+    operands.push_back(&get_sorted_set());
+    operands.insert(operands.end(), other_sets.begin(), other_sets.end());
+    std::vector<uint64_t> ids;
+    SortedSetOps::intersect_k(operands, ids);
+    for (uint64_t id : ids) {
+        result.result_set.insert(BigInt::from_u64(id));
+    }
+    
+    // 生成整个查询的聚合交集证明：各操作数去掉结果后的剩余部分
+    SortedElementSet intersection(std::move(ids));
+    std::vector<std::vector<BigInt>> remainders;
+    for (const SortedElementSet* operand : operands) {
+        std::vector<uint64_t> remainder;
+        SortedSetOps::merge_difference(*operand, intersection, std::back_inserter(remainder));
+        std::vector<BigInt> elements;
+        elements.reserve(remainder.size());
+        for (uint64_t id : remainder) {
+            elements.push_back(BigInt::from_u64(id));
+        }
+        remainders.push_back(std::move(elements));
+    }
+    prove_intersection(result, remainders);
+    
+    if (verbose) {
+        std::cout << "计算" << operands.size() << "路交集完成，结果大小: " << result.result_set.size() << std::endl;
+    }
     return result;
 }
 
@@ -410,109 +1060,255 @@ bool ESAAccumulator::verify_membership_proof(const ZeroKnowledgeProof& proof, co
     }
     
     // 重新计算挑战并验证
-    BigInt challenge_input = CryptoUtils::sha256(
-        proof.get_commitment().get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        element.to_string()
-    );
-    BigInt expected_challenge = challenge_input % group_order;
+    BigInt expected_challenge = element_challenge("esa-membership", proof.get_commitment(), element);
     
     if (expected_challenge != proof.get_challenge()) {
         return false;
     }
     
     // 验证零知识成员关系证明
-    // 检查 g^s = C * g^(c * element) mod n
-    
-    GroupElement left_side = generator ^ proof.get_response();
-    GroupElement right_side = proof.get_commitment() * (generator ^ (proof.get_challenge() * element));
-    
-    return left_side == right_side;
+    // 检查 g^s = C * g^(c * element)，两侧底数相同，移项为 g^(s - c·element) = C
+    return generator_pow(membership_exponent(proof, element)) == proof.get_commitment();
+}
+
+bool ESAAccumulator::verify_membership_proofs(const std::vector<ZeroKnowledgeProof>& proofs,
+                                              const std::vector<BigInt>& elements, size_t threads) {
+    if (proofs.size() != elements.size()) {
+        return false;
+    }
+    if (proofs.empty()) {
+        return true;
+    }
+    BigIntArena::Scope scope;
+    
+    std::vector<GroupElement> commitments;
+    std::vector<BigInt> exponents;
+    commitments.reserve(proofs.size());
+    exponents.reserve(proofs.size());
+    for (size_t i = 0; i < proofs.size(); i++) {
+        const ZeroKnowledgeProof& proof = proofs[i];
+        if (proof.get_type() != ProofType::MEMBERSHIP || !proof.valid() ||
+            proof.get_commitment().get_modulus() != group_order) {
+            return false;
+        }
+        if (element_challenge("esa-membership", proof.get_commitment(), elements[i]) != proof.get_challenge()) {
+            return false;
+        }
+        commitments.push_back(proof.get_commitment());
+        exponents.push_back(membership_exponent(proof, elements[i]));
+    }
+    return verify_commitment_exponents(commitments, exponents, threads);
+}
+
+bool ESAAccumulator::verify_commitment_exponents(const std::vector<GroupElement>& commitments,
+                                                 const std::vector<BigInt>& exponents, size_t threads) const {
+    BigIntArena::CtxGuard ctx;
+    
+    // 随机权重w_i下检查 g^(Σ w_i·e_i) = ∏ C_i^(w_i)。权重只能覆盖奇数阶部分，
+    // 阶为2的分量用Jacobi符号逐项检查：有效证明满足 (C_i/p) = (g/p)^(e_i)
+    int generator_symbol = BN_kronecker(generator.get_value().get_const_bn(), group_order.get_const_bn(), ctx);
+    std::vector<BigInt> weights = SecureRandom::local().uniform_batch(BigInt("1"), BigInt::from_u64(UINT64_MAX),
+                                                                      commitments.size());
+    BigInt combined;
+    for (size_t i = 0; i < commitments.size(); i++) {
+        int expected_symbol = (generator_symbol == -1 && BN_is_odd(exponents[i].get_const_bn())) ? -1 : 1;
+        if (BN_kronecker(commitments[i].get_value().get_const_bn(), group_order.get_const_bn(), ctx) !=
+            expected_symbol) {
+            return false;
+        }
+        combined = (combined + weights[i] * exponents[i]) % exponent_order;
+    }
+    return generator_pow(combined) == CryptoUtils::multi_exp(commitments, weights, threads);
+}
+
+bool ESAAccumulator::verify_membership_bundle(const MembershipProofBundle& bundle, const std::vector<BigInt>& elements,
+                                              size_t threads) {
+    if (!bundle.valid() || bundle.size() != elements.size() || bundle.get_responses().size() != elements.size() ||
+        bundle.get_accumulator() != get_accumulator_value()) {
+        return false;
+    }
+    if (elements.empty()) {
+        return true;
+    }
+    BigIntArena::Scope scope;
+    
+    const Transcript prefix = bundle_transcript(bundle.get_accumulator());
+    std::vector<BigInt> exponents;
+    exponents.reserve(elements.size());
+    for (size_t i = 0; i < elements.size(); i++) {
+        const GroupElement& commitment = bundle.get_commitments()[i];
+        if (commitment.get_modulus() != group_order) {
+            return false;
+        }
+        Transcript transcript(prefix);
+        transcript.append_group_element("commitment", commitment);
+        transcript.append_bigint("element", elements[i]);
+        BigInt challenge = transcript.challenge("challenge", group_order);
+        exponents.push_back(membership_exponent(challenge, bundle.get_responses()[i], elements[i]));
+    }
+    return verify_commitment_exponents(bundle.get_commitments(), exponents, threads);
 }
 
 bool ESAAccumulator::verify_non_membership_proof(const ZeroKnowledgeProof& proof, const BigInt& element) {
     if (proof.get_type() != ProofType::NON_MEMBERSHIP || !proof.valid()) {
         return false;
     }
-    
-    // 重新计算挑战并验证
-    BigInt challenge_input = CryptoUtils::sha256(
-        proof.get_commitment().get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        element.to_string()
-    );
-    BigInt expected_challenge = challenge_input % group_order;
-    
-    if (expected_challenge != proof.get_challenge()) {
+    const std::vector<GroupElement>& aux = proof.get_auxiliary_data();
+    if (aux.size() != 1 || aux[0] != get_universal_value() || !universal_group.contains(proof.get_commitment())) {
         return false;
     }
     
-    // 验证零知识非成员关系证明
-    // 检查 g^s = C * g^(c * (group_order - element)) mod n
-    
-    GroupElement left_side = generator ^ proof.get_response();
-    GroupElement right_side = proof.get_commitment() * 
-                             (generator ^ (proof.get_challenge() * (group_order - element)));
-    
-    return left_side == right_side;
+    // 检查 0 < a < x 且 U^a = d^x · h
+    BigInt x = CryptoUtils::hash_to_prime(element);
+    const BigInt& a = proof.get_response();
+    if (a.is_zero() || a >= x) {
+        return false;
+    }
+    return universal_group.canonical(aux[0] ^ a) ==
+           universal_group.canonical((proof.get_commitment() ^ x) * universal_group.get_base());
 }
 
 
 bool ESAAccumulator::verify_witness(const BigInt& witness, const BigInt& element) {
     // 验证见证：检查 witness * g^element = A
-    GroupElement elem_power = generator ^ element;
+    GroupElement elem_power = generator_pow(element);
     BigInt expected_accumulator = (witness * elem_power.get_value()) % group_order;
     
-    return expected_accumulator == accumulator_value.get_value();
+    return expected_accumulator == get_accumulator_value().get_value();
 }
 
-bool ESAAccumulator::verify_set_operation_proof(const SetOperationResult& result) {
-    if (!result.is_valid || !result.proof.valid()) {
+bool ESAAccumulator::verify_aggregate_witness(const GroupElement& witness, const std::vector<BigInt>& elements) const {
+    if (!universal_group.contains(witness) || elements.empty()) {
         return false;
     }
-    
-    // 验证集合操作证明
-    // 检查 g^s = C * g^(c * |result_set|) mod n
-    
-    GroupElement left_side = generator ^ result.proof.get_response();
-    GroupElement right_side = result.proof.get_commitment() * 
-                             (generator ^ (result.proof.get_challenge() * BigInt(std::to_string(result.result_set.size()))));
-    
-    return left_side == right_side;
+    // 群的阶未知，不知道陷门时对U开 ∏x 次根等价于强RSA问题；
+    // 素数代表两两不同，重复元素会使指数中出现平方因子而无法通过检查
+    return universal_group.canonical(witness ^ prime_product(elements)) == get_universal_value();
 }
 
-bool ESAAccumulator::verify_complement_proof(const ZeroKnowledgeProof& proof, const std::unordered_set<BigInt, BigInt::Hash>& /* other_set */) {
-    if (proof.get_type() != ProofType::COMPLEMENT || !proof.valid()) {
+bool ESAAccumulator::verify_intersection(const SetOperationProof& proof, const std::vector<BigInt>& result_primes,
+                                         const std::vector<GroupElement>& other_digests) const {
+    size_t k = other_digests.size() + 1;
+    if (proof.witnesses.size() != k || proof.terms.size() != k || proof.signs.size() != k) {
         return false;
     }
-    
-    // 验证补集证明
-    // 重新计算挑战并验证
-    BigInt challenge_input = CryptoUtils::sha256(
-        proof.get_commitment().get_value().to_string() + 
-        accumulator_value.get_value().to_string() + 
-        "complement"
-    );
-    BigInt expected_challenge = challenge_input % group_order;
-    
-    if (expected_challenge != proof.get_challenge()) {
+    size_t nonzero = k - std::count(proof.signs.begin(), proof.signs.end(), 0);
+    if (proof.subproofs.size() != k + nonzero) {
         return false;
     }
     
-    // 验证零知识补集证明
-    // 检查 g^s = C * g^(c * |complement_set|) mod n
-    
-    GroupElement left_side = generator ^ proof.get_response();
-    GroupElement right_side = proof.get_commitment() * 
-                             (generator ^ (proof.get_challenge() * BigInt(std::to_string(proof.get_response().to_string().length()))));
+    // W_i^r = D(O_i)：结果是每个操作数的子集
+    for (size_t i = 0; i < k; i++) {
+        const GroupElement& digest = i == 0 ? get_universal_value() : other_digests[i - 1];
+        if (!ExponentiationProof::verify(universal_group, proof.witnesses[i], result_primes, digest,
+                                         proof.subproofs[i])) {
+            return false;
+        }
+    }
     
-    return left_side == right_side;
+    // ∏_{c_i>0} E_i = h·∏_{c_i<0} E_i：各剩余部分的素数之积互素，结果之外没有公共元素
+    GroupElement positive = GroupElement::identity(universal_group.get_modulus());
+    GroupElement negative = universal_group.get_base();
+    size_t next = k;
+    for (size_t i = 0; i < k; i++) {
+        if (proof.signs[i] == 0) {
+            continue;
+        }
+        if ((proof.signs[i] != 1 && proof.signs[i] != -1) ||
+            !ExponentiationProof::verify_knowledge(universal_group, proof.witnesses[i], proof.terms[i],
+                                                   proof.subproofs[next++])) {
+            return false;
+        }
+        GroupElement& side = proof.signs[i] > 0 ? positive : negative;
+        side = side * proof.terms[i];
+    }
+    return universal_group.canonical(positive) == universal_group.canonical(negative);
+}
+
+bool ESAAccumulator::verify_difference(const SetOperationProof& proof, const std::vector<BigInt>& result_primes,
+                                       const GroupElement& other_digest) const {
+    if (proof.witnesses.size() != 1 || proof.terms.size() != 2 || proof.subproofs.size() != 4) {
+        return false;
+    }
+    const GroupElement& witness = proof.witnesses[0];
+    const GroupElement& term = proof.terms[0];
+    const GroupElement& root = proof.terms[1];
+    // W^r = D(S)、W^f = D(T)：结果在S中，S的其余部分在T中；E = D(T)^β、A^r = h·E：结果与T不相交
+    return ExponentiationProof::verify(universal_group, witness, result_primes, get_universal_value(),
+                                       proof.subproofs[0]) &&
+           ExponentiationProof::verify_knowledge(universal_group, witness, other_digest, proof.subproofs[1]) &&
+           ExponentiationProof::verify_knowledge(universal_group, other_digest, term, proof.subproofs[2]) &&
+           ExponentiationProof::verify(universal_group, root, result_primes,
+                                       universal_group.canonical(universal_group.get_base() * term),
+                                       proof.subproofs[3]);
+}
+
+bool ESAAccumulator::verify_set_operation_proof(const SetOperationResult& result,
+                                                const std::vector<GroupElement>& other_digests) {
+    const SetOperationProof& proof = result.proof;
+    if (!result.is_valid || !proof.valid()) {
+        return false;
+    }
+    for (const auto& digest : other_digests) {
+        if (!universal_group.contains(digest)) {
+            return false;
+        }
+    }
+    BigIntArena::Scope scope;
+    
+    switch (proof.get_type()) {
+        case ProofType::UNION: {
+            if (other_digests.size() != 1 || proof.labels.size() != result.result_set.size() ||
+                proof.subproofs.size() != 2) {
+                return false;
+            }
+            // 按标注把结果分回两个操作数，各自的素数之积必须对上可信摘要
+            std::vector<BigInt> sorted(result.result_set.begin(), result.result_set.end());
+            std::sort(sorted.begin(), sorted.end());
+            std::vector<BigInt> current_factors;
+            std::vector<BigInt> other_factors;
+            for (size_t i = 0; i < sorted.size(); i++) {
+                uint8_t label = proof.labels[i];
+                if (label == 0 || label > 3) {
+                    return false;
+                }
+                BigInt prime = prime_representative(sorted[i]);
+                if (label & 1) {
+                    current_factors.push_back(prime);
+                }
+                if (label & 2) {
+                    other_factors.push_back(prime);
+                }
+            }
+            const GroupElement& base = universal_group.get_base();
+            return ExponentiationProof::verify(universal_group, base, current_factors, get_universal_value(),
+                                               proof.subproofs[0]) &&
+                   ExponentiationProof::verify(universal_group, base, other_factors, other_digests[0],
+                                               proof.subproofs[1]);
+        }
+        case ProofType::INTERSECTION:
+            return verify_intersection(proof, sorted_primes(result.result_set), other_digests);
+        case ProofType::DIFFERENCE:
+        case ProofType::COMPLEMENT:
+            return other_digests.size() == 1 &&
+                   verify_difference(proof, sorted_primes(result.result_set), other_digests[0]);
+        default:
+            return false;
+    }
+}
+
+bool ESAAccumulator::verify_complement_proof(const SetOperationResult& result,
+                                             const std::unordered_set<BigInt, BigInt::Hash>& other_set) {
+    if (result.proof.get_type() != ProofType::COMPLEMENT) {
+        return false;
+    }
+    return verify_set_operation_proof(result, {compute_set_digest(other_set)});
 }
 
 void ESAAccumulator::print_state() const {
     std::cout << "\n=== ESA累加器状态 ===" << std::endl;
     std::cout << "当前集合大小: " << current_set.size() << std::endl;
-    std::cout << "累加器值: " << accumulator_value.to_string() << std::endl;
+    std::cout << "累加器值: " << get_accumulator_value().to_string() << std::endl;
     std::cout << "群阶: " << group_order.to_string() << std::endl;
     std::cout << "生成元: " << generator.to_string() << std::endl;
     
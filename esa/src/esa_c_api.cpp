@@ -0,0 +1,282 @@
+#include "esa_c_api.h"
+#include "esa_accumulator.h"
+#include <openssl/bn.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+struct esa_accumulator {
+    ESAAccumulator acc;
+    // 累加器本身不是线程安全的（包括惰性计算的累加器值和下面的重试状态），每个入口持锁串行化
+    mutable std::mutex mutex;
+
+    // 上一次因缓冲区不足没有交付的批量证明，以请求字节和累加器值为键
+    std::vector<uint8_t> pending_request;
+    GroupElement pending_accumulator;
+    std::vector<uint8_t> pending_proofs;
+
+    esa_accumulator() : acc(false) {}
+    esa_accumulator(const BigInt& group_order, const GroupElement& generator)
+        : acc(group_order, generator, false) {}
+};
+
+namespace {
+    BigInt bigint_from(const uint8_t* data, size_t length) {
+        BigInt value;
+        BN_bin2bn(data, static_cast<int>(length), value.get_bn());
+        return value;
+    }
+
+    // 遍历长度前缀的扁平缓冲区，格式错误时返回false
+    template<typename Visit>
+    bool for_each_item(const uint8_t* data, size_t length, Visit visit) {
+        if (!data && length > 0) {
+            return false;
+        }
+        size_t pos = 0;
+        while (pos < length) {
+            if (length - pos < 4) {
+                return false;
+            }
+            size_t size = (static_cast<size_t>(data[pos]) << 24) | (static_cast<size_t>(data[pos + 1]) << 16) |
+                          (static_cast<size_t>(data[pos + 2]) << 8) | data[pos + 3];
+            pos += 4;
+            if (length - pos < size) {
+                return false;
+            }
+            visit(data + pos, size);
+            pos += size;
+        }
+        return true;
+    }
+
+    bool parse_elements(const uint8_t* data, size_t length, std::vector<BigInt>& elements) {
+        return for_each_item(data, length, [&elements](const uint8_t* item, size_t size) {
+            elements.push_back(bigint_from(item, size));
+        });
+    }
+
+    void put_item(std::vector<uint8_t>& out, const uint8_t* data, size_t length) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>((length >> shift) & 0xff));
+        }
+        out.insert(out.end(), data, data + length);
+    }
+
+    void put_bigint_item(std::vector<uint8_t>& out, const BigInt& value) {
+        std::vector<uint8_t> bytes(BN_num_bytes(value.get_const_bn()));
+        BN_bn2bin(value.get_const_bn(), bytes.data());
+        put_item(out, bytes.data(), bytes.size());
+    }
+
+    int copy_out(const std::vector<uint8_t>& data, uint8_t* out, size_t out_cap, size_t* out_len) {
+        if (!out_len) {
+            return ESA_ERR_ARGUMENT;
+        }
+        *out_len = data.size();
+        if (out_cap < data.size() || (!out && !data.empty())) {
+            return ESA_ERR_BUFFER_TOO_SMALL;
+        }
+        if (!data.empty()) {
+            std::memcpy(out, data.data(), data.size());
+        }
+        return ESA_OK;
+    }
+
+    // C接口的每个入口都经过这里，异常在C边界之内转换为错误码
+    template<typename Body>
+    int guarded(Body body) {
+        try {
+            return body();
+        } catch (...) {
+            return ESA_ERR_INTERNAL;
+        }
+    }
+
+    template<typename Create>
+    esa_accumulator* guarded_new(Create create) {
+        try {
+            return create();
+        } catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+extern "C" {
+
+esa_accumulator* esa_accumulator_new(void) {
+    return guarded_new([]() { return new esa_accumulator(); });
+}
+
+esa_accumulator* esa_accumulator_new_with_params(const uint8_t* group_order, size_t group_order_len,
+                                                 const uint8_t* generator, size_t generator_len) {
+    if (!group_order || !generator || group_order_len == 0 || generator_len == 0) {
+        return nullptr;
+    }
+    return guarded_new([&]() -> esa_accumulator* {
+        BigIntArena::Scope scope;
+        BigInt order = bigint_from(group_order, group_order_len);
+        BigInt base = bigint_from(generator, generator_len);
+        // 模数为0或1时后续的模运算没有定义
+        if (order < BigInt("3") || base.is_zero() || !(base < order)) {
+            return nullptr;
+        }
+        return new esa_accumulator(order, GroupElement(base, order));
+    });
+}
+
+void esa_accumulator_free(esa_accumulator* acc) {
+    delete acc;
+}
+
+size_t esa_accumulator_size(const esa_accumulator* acc) {
+    if (!acc) {
+        return 0;
+    }
+    try {
+        std::lock_guard<std::mutex> lock(acc->mutex);
+        return acc->acc.size();
+    } catch (...) {
+        return 0;
+    }
+}
+
+int esa_accumulator_params(const esa_accumulator* acc, uint8_t* out, size_t out_cap, size_t* out_len) {
+    return guarded([&]() -> int {
+        if (!acc) {
+            return ESA_ERR_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(acc->mutex);
+        std::vector<uint8_t> data;
+        put_bigint_item(data, acc->acc.get_group_order());
+        put_bigint_item(data, acc->acc.get_generator().get_value());
+        return copy_out(data, out, out_cap, out_len);
+    });
+}
+
+int esa_accumulator_value(const esa_accumulator* acc, uint8_t* out, size_t out_cap, size_t* out_len) {
+    return guarded([&]() -> int {
+        if (!acc) {
+            return ESA_ERR_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(acc->mutex);
+        GroupElement value = acc->acc.get_accumulator_value();
+        std::vector<uint8_t> data(BN_num_bytes(value.get_value().get_const_bn()));
+        BN_bn2bin(value.get_value().get_const_bn(), data.data());
+        return copy_out(data, out, out_cap, out_len);
+    });
+}
+
+int esa_add_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len, size_t* count) {
+    return guarded([&]() -> int {
+        if (!acc || !count) {
+            return ESA_ERR_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(acc->mutex);
+        BigIntArena::Scope scope;
+        std::vector<BigInt> parsed;
+        if (!parse_elements(elements, elements_len, parsed)) {
+            return ESA_ERR_FORMAT;
+        }
+        *count = acc->acc.add_elements(parsed);
+        return ESA_OK;
+    });
+}
+
+int esa_remove_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len, size_t* count) {
+    return guarded([&]() -> int {
+        if (!acc || !count) {
+            return ESA_ERR_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(acc->mutex);
+        BigIntArena::Scope scope;
+        std::vector<BigInt> parsed;
+        if (!parse_elements(elements, elements_len, parsed)) {
+            return ESA_ERR_FORMAT;
+        }
+        *count = acc->acc.remove_elements(parsed);
+        return ESA_OK;
+    });
+}
+
+int esa_prove_membership_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len,
+                               uint8_t* out, size_t out_cap, size_t* out_len) {
+    return guarded([&]() -> int {
+        if (!acc || !out_len) {
+            return ESA_ERR_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(acc->mutex);
+        BigIntArena::Scope scope;
+        std::vector<BigInt> parsed;
+        if (!parse_elements(elements, elements_len, parsed)) {
+            return ESA_ERR_FORMAT;
+        }
+
+        // 上次缓冲区不足时留下的证明仍对应当前的请求和累加器值时直接交付
+        const GroupElement& accumulator = acc->acc.get_accumulator_value();
+        bool cached = !acc->pending_proofs.empty() && acc->pending_accumulator == accumulator &&
+                      acc->pending_request.size() == elements_len &&
+                      (elements_len == 0 || std::memcmp(acc->pending_request.data(), elements, elements_len) == 0);
+        std::vector<uint8_t> data;
+        if (cached) {
+            data.swap(acc->pending_proofs);
+        } else {
+            std::vector<uint8_t> encoded;
+            for (const auto& element : parsed) {
+                encoded.clear();
+                acc->acc.generate_membership_proof(element).serialize_binary(encoded);
+                put_item(data, encoded.data(), encoded.size());
+            }
+        }
+        acc->pending_proofs.clear();
+        acc->pending_request.clear();
+
+        int status = copy_out(data, out, out_cap, out_len);
+        if (status == ESA_ERR_BUFFER_TOO_SMALL) {
+            acc->pending_request.assign(elements, elements + elements_len);
+            acc->pending_accumulator = accumulator;
+            acc->pending_proofs.swap(data);
+        }
+        return status;
+    });
+}
+
+int esa_verify_membership_batch(esa_accumulator* acc, const uint8_t* elements, size_t elements_len,
+                                const uint8_t* proofs, size_t proofs_len,
+                                uint8_t* results, size_t results_cap, size_t* count) {
+    return guarded([&]() -> int {
+        if (!acc || !count) {
+            return ESA_ERR_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(acc->mutex);
+        BigIntArena::Scope scope;
+        std::vector<BigInt> parsed;
+        std::vector<ZeroKnowledgeProof> parsed_proofs;
+        bool well_formed = parse_elements(elements, elements_len, parsed) &&
+            for_each_item(proofs, proofs_len, [&parsed_proofs](const uint8_t* item, size_t size) {
+                parsed_proofs.push_back(ZeroKnowledgeProof::deserialize_binary(item, size));
+            });
+        if (!well_formed || parsed.size() != parsed_proofs.size()) {
+            return ESA_ERR_FORMAT;
+        }
+
+        *count = parsed.size();
+        if (results_cap < parsed.size() || (!results && !parsed.empty())) {
+            return ESA_ERR_BUFFER_TOO_SMALL;
+        }
+        // 先整体批量验证，只有失败时才逐个验证以定位无效的证明
+        if (acc->acc.verify_membership_proofs(parsed_proofs, parsed)) {
+            std::fill(results, results + parsed.size(), uint8_t(1));
+            return ESA_OK;
+        }
+        for (size_t i = 0; i < parsed.size(); i++) {
+            results[i] = acc->acc.verify_membership_proof(parsed_proofs[i], parsed[i]) ? 1 : 0;
+        }
+        return ESA_OK;
+    });
+}
+
+}
@@ -0,0 +1,173 @@
+#include "esa_manager.h"
+#include <iostream>
+
+// ESAAccumulatorManager 实现
+ESAAccumulatorManager::ESAAccumulatorManager(bool verbose)
+    : ESAAccumulator(verbose), trapdoor_exponent("1"), trapdoor_stale(true) {
+    BigInt phi;
+    set_universal_group(RSAGroup::generate(kModulusBits, &phi));
+    install_trapdoor(phi);
+}
+
+ESAAccumulatorManager::ESAAccumulatorManager(const BigInt& group_order, const GroupElement& generator, bool verbose)
+    : ESAAccumulator(group_order, generator, verbose), trapdoor_exponent("1"), trapdoor_stale(true) {
+    BigInt phi;
+    set_universal_group(RSAGroup::generate(kModulusBits, &phi));
+    install_trapdoor(phi);
+}
+
+ESAAccumulatorManager::ESAAccumulatorManager(const BigInt& group_order, const GroupElement& generator,
+                                             const RSAGroup& universal_group, const BigInt& trapdoor, bool verbose)
+    : ESAAccumulator(group_order, generator, universal_group, verbose), trapdoor_exponent("1"), trapdoor_stale(true) {
+    install_trapdoor(trapdoor);
+}
+
+void ESAAccumulatorManager::install_trapdoor(const BigInt& candidate) {
+    const RSAGroup& group = get_universal_group();
+    // φ(N) 是群阶的倍数，基的 φ(N) 次幂必为1
+    if (candidate.is_zero() || !group.valid() ||
+        group.get_base().pow_secret(candidate) != GroupElement::identity(group.get_modulus())) {
+        if (verbose_enabled()) {
+            std::cout << "陷门与通用累加器的群不匹配，使用公开路径" << std::endl;
+        }
+        return;
+    }
+    trapdoor = candidate;
+}
+
+BigInt ESAAccumulatorManager::exponent_inverse(const BigInt& prime) const {
+    return CryptoUtils::mod_inverse(prime % trapdoor, trapdoor);
+}
+
+GroupElement ESAAccumulatorManager::base_pow(const BigInt& exponent) const {
+    const RSAGroup& group = get_universal_group();
+    const GroupElement& base = group.get_base();
+    return group.canonical(constant_time_enabled() ? base.pow_secret(exponent) : base ^ exponent);
+}
+
+void ESAAccumulatorManager::rebuild_trapdoor_exponent() {
+    // 由当前集合重算 u mod φ(N)，只在素数代表不可逆时使用
+    trapdoor_exponent = BigInt("1");
+    for (const auto& element : get_current_set()) {
+        trapdoor_exponent = trapdoor_exponent * CryptoUtils::hash_to_prime(element) % trapdoor;
+    }
+    pending_inserts.clear();
+    trapdoor_stale = true;
+}
+
+void ESAAccumulatorManager::universal_insert(const BigInt& element) {
+    if (!has_trapdoor()) {
+        ESAAccumulator::universal_insert(element);
+        return;
+    }
+    // 与基类一样积压到读取U时再求素数代表
+    pending_inserts.insert(element);
+}
+
+void ESAAccumulatorManager::universal_erase(const BigInt& element) {
+    if (!has_trapdoor()) {
+        ESAAccumulator::universal_erase(element);
+        return;
+    }
+    if (pending_inserts.erase(element) > 0) {
+        return;
+    }
+    BigIntArena::Scope scope;
+    BigInt inverse = exponent_inverse(CryptoUtils::hash_to_prime(element));
+    if (inverse.is_zero()) {
+        rebuild_trapdoor_exponent();
+        return;
+    }
+    trapdoor_exponent = trapdoor_exponent * inverse % trapdoor;
+    trapdoor_stale = true;
+}
+
+void ESAAccumulatorManager::flush_pending() const {
+    if (pending_inserts.empty()) {
+        return;
+    }
+    BigIntArena::Scope scope;
+    for (const auto& element : pending_inserts) {
+        trapdoor_exponent = trapdoor_exponent * CryptoUtils::hash_to_prime(element) % trapdoor;
+    }
+    pending_inserts.clear();
+    trapdoor_stale = true;
+}
+
+const GroupElement& ESAAccumulatorManager::current_universal() const {
+    if (!has_trapdoor()) {
+        return ESAAccumulator::current_universal();
+    }
+    flush_pending();
+    if (trapdoor_stale) {
+        trapdoor_value = base_pow(trapdoor_exponent);
+        trapdoor_stale = false;
+    }
+    return trapdoor_value;
+}
+
+GroupElement ESAAccumulatorManager::generate_universal_witness(const BigInt& element) {
+    return generate_aggregate_witness({element});
+}
+
+GroupElement ESAAccumulatorManager::generate_aggregate_witness(const std::vector<BigInt>& elements) {
+    if (!has_trapdoor()) {
+        return ESAAccumulator::generate_aggregate_witness(elements);
+    }
+    for (const auto& element : elements) {
+        if (!contains(element)) {
+            if (verbose_enabled()) {
+                std::cout << "元素 " << element.to_string() << " 不在集合中，无法生成聚合见证" << std::endl;
+            }
+            return GroupElement();
+        }
+    }
+    flush_pending();
+    BigIntArena::Scope scope;
+
+    // W = h^(u·∏x^-1 mod φ(N))：各素数代表先在 Z_φ(N) 中相乘，只求一次逆元
+    BigInt product = BigInt("1");
+    for (const auto& element : elements) {
+        product = product * CryptoUtils::hash_to_prime(element) % trapdoor;
+    }
+    BigInt inverse = exponent_inverse(product);
+    if (inverse.is_zero()) {
+        return GroupElement();
+    }
+    GroupElement witness = base_pow(trapdoor_exponent * inverse % trapdoor);
+
+    if (verbose_enabled()) {
+        std::cout << "陷门生成聚合见证: " << elements.size() << " 个元素" << std::endl;
+    }
+    return witness;
+}
+
+std::vector<ZeroKnowledgeProof> ESAAccumulatorManager::generate_non_membership_proofs(const std::vector<BigInt>& elements) {
+    if (!has_trapdoor()) {
+        return ESAAccumulator::generate_non_membership_proofs(elements);
+    }
+    std::vector<ZeroKnowledgeProof> proofs(elements.size(), ZeroKnowledgeProof(ProofType::NON_MEMBERSHIP));
+    if (elements.empty()) {
+        return proofs;
+    }
+    const GroupElement& universal = current_universal();
+    BigIntArena::Scope scope;
+
+    // 取 a = 1，需要 d^x = U·h^-1，即 d = h^((u-1)·x^-1 mod φ(N))
+    BigInt shifted = (trapdoor_exponent + trapdoor - BigInt("1")) % trapdoor;
+    for (size_t i = 0; i < elements.size(); i++) {
+        if (contains(elements[i])) {
+            continue;
+        }
+        BigInt inverse = exponent_inverse(CryptoUtils::hash_to_prime(elements[i]));
+        if (inverse.is_zero()) {
+            continue;
+        }
+        ZeroKnowledgeProof& proof = proofs[i];
+        proof.set_commitment(base_pow(shifted * inverse % trapdoor));
+        proof.set_response(BigInt("1"));
+        proof.add_auxiliary_data(universal);
+        proof.set_valid(true);
+    }
+    return proofs;
+}
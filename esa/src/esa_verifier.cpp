@@ -0,0 +1,197 @@
+#include "esa_verifier.h"
+#include "fixed_base_table.h"
+#include "parallel.h"
+#include <algorithm>
+
+// ESAVerifier 实现
+ESAVerifier::ESAVerifier(const BigInt& group_order, const GroupElement& generator, size_t cache_capacity)
+    : ESAVerifier(group_order, generator, RSAGroup::rsa2048(), cache_capacity) {}
+
+ESAVerifier::ESAVerifier(const BigInt& group_order, const GroupElement& generator, const RSAGroup& universal_group,
+                         size_t cache_capacity)
+    : group_order(group_order), exponent_order(group_order - BigInt("1")), generator(generator),
+      universal_group(universal_group), capacity(std::max<size_t>(1, cache_capacity)) {
+    generator_table = FixedBaseTable::shared(generator, exponent_order.bit_length());
+}
+
+void ESAVerifier::trust(uint64_t epoch, const GroupElement& accumulator, const GroupElement& universal_value) {
+    GroupElement universal = universal_group.contains(universal_value) ? universal_value : GroupElement();
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = std::lower_bound(epochs.begin(), epochs.end(), epoch,
+                               [](const Epoch& entry, uint64_t value) { return entry.epoch < value; });
+    if (it != epochs.end() && it->epoch == epoch) {
+        it->accumulator = accumulator;
+        it->universal = universal;
+        return;
+    }
+    epochs.insert(it, Epoch{epoch, accumulator, universal});
+    if (epochs.size() > capacity) {
+        epochs.erase(epochs.begin());
+    }
+}
+
+void ESAVerifier::trust(uint64_t epoch, const ESAAccumulator& accumulator) {
+    trust(epoch, accumulator.get_accumulator_value(), accumulator.get_universal_value());
+}
+
+bool ESAVerifier::lookup(uint64_t epoch, Epoch& out) const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    for (const auto& entry : epochs) {
+        if (entry.epoch == epoch) {
+            out = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ESAVerifier::latest(Epoch& out) const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (epochs.empty()) {
+        return false;
+    }
+    out = epochs.back();
+    return true;
+}
+
+size_t ESAVerifier::cached_epochs() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return epochs.size();
+}
+
+bool ESAVerifier::find_accumulator(const GroupElement& accumulator) const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    for (const auto& entry : epochs) {
+        if (entry.accumulator == accumulator) {
+            return true;
+        }
+    }
+    return false;
+}
+
+BigInt ESAVerifier::membership_exponent(const BigInt& challenge, const BigInt& response, const BigInt& element) const {
+    BigInt claimed = (challenge % exponent_order) * (element % exponent_order) % exponent_order;
+    return (response % exponent_order + exponent_order - claimed) % exponent_order;
+}
+
+bool ESAVerifier::verify_membership(const ZeroKnowledgeProof& proof, const BigInt& element, uint64_t epoch) const {
+    Epoch state;
+    if (proof.get_type() != ProofType::MEMBERSHIP || !proof.valid() ||
+        proof.get_commitment().get_modulus() != group_order || !lookup(epoch, state)) {
+        return false;
+    }
+    BigIntArena::Scope scope;
+    Transcript transcript("esa-membership");
+    transcript.append_group_element("commitment", proof.get_commitment());
+    transcript.append_group_element("accumulator", state.accumulator);
+    transcript.append_bigint("element", element);
+    if (transcript.challenge("challenge", group_order) != proof.get_challenge()) {
+        return false;
+    }
+    // g^(s - c·element) = C
+    return generator_table->pow(membership_exponent(proof.get_challenge(), proof.get_response(), element)) ==
+           proof.get_commitment();
+}
+
+bool ESAVerifier::verify_membership_batch(const std::vector<ZeroKnowledgeProof>& proofs,
+                                          const std::vector<BigInt>& elements, uint64_t epoch, size_t threads) const {
+    Epoch state;
+    if (proofs.size() != elements.size() || !lookup(epoch, state)) {
+        return false;
+    }
+    if (proofs.empty()) {
+        return true;
+    }
+    BigIntArena::Scope scope;
+
+    // 挑战 c = H("esa-membership" || C || A || element)，与 ESAAccumulator 生成时相同。
+    // 指数只有群阶的位数，查固定底数表逐个检查 g^e = C 比随机线性组合的多重幂更快，且是确定性的
+    std::vector<char> ok(proofs.size(), 0);
+    Parallel::ranges(proofs.size(), threads, [&](size_t, size_t begin, size_t end) {
+        BigIntArena::Scope worker_scope;
+        for (size_t i = begin; i < end; i++) {
+            const ZeroKnowledgeProof& proof = proofs[i];
+            if (proof.get_type() != ProofType::MEMBERSHIP || !proof.valid() ||
+                proof.get_commitment().get_modulus() != group_order) {
+                return;
+            }
+            Transcript transcript("esa-membership");
+            transcript.append_group_element("commitment", proof.get_commitment());
+            transcript.append_group_element("accumulator", state.accumulator);
+            transcript.append_bigint("element", elements[i]);
+            if (transcript.challenge("challenge", group_order) != proof.get_challenge()) {
+                return;
+            }
+            BigInt exponent = membership_exponent(proof.get_challenge(), proof.get_response(), elements[i]);
+            ok[i] = generator_table->pow(exponent) == proof.get_commitment();
+        }
+    });
+    return std::find(ok.begin(), ok.end(), 0) == ok.end();
+}
+
+bool ESAVerifier::verify_membership_bundle(const MembershipProofBundle& bundle, const std::vector<BigInt>& elements,
+                                           size_t threads) const {
+    if (!bundle.valid() || bundle.size() != elements.size() || bundle.get_responses().size() != elements.size() ||
+        !find_accumulator(bundle.get_accumulator())) {
+        return false;
+    }
+    if (elements.empty()) {
+        return true;
+    }
+    BigIntArena::Scope scope;
+
+    Transcript prefix("esa-membership-bundle");
+    prefix.append_group_element("accumulator", bundle.get_accumulator());
+    const std::vector<GroupElement>& commitments = bundle.get_commitments();
+    std::vector<char> ok(elements.size(), 0);
+    Parallel::ranges(elements.size(), threads, [&](size_t, size_t begin, size_t end) {
+        BigIntArena::Scope worker_scope;
+        for (size_t i = begin; i < end; i++) {
+            if (commitments[i].get_modulus() != group_order) {
+                return;
+            }
+            Transcript transcript(prefix);
+            transcript.append_group_element("commitment", commitments[i]);
+            transcript.append_bigint("element", elements[i]);
+            BigInt challenge = transcript.challenge("challenge", group_order);
+            BigInt exponent = membership_exponent(challenge, bundle.get_responses()[i], elements[i]);
+            ok[i] = generator_table->pow(exponent) == commitments[i];
+        }
+    });
+    return std::find(ok.begin(), ok.end(), 0) == ok.end();
+}
+
+bool ESAVerifier::verify_non_membership(const ZeroKnowledgeProof& proof, const BigInt& element, uint64_t epoch) const {
+    Epoch state;
+    if (proof.get_type() != ProofType::NON_MEMBERSHIP || !proof.valid() || !lookup(epoch, state) ||
+        !state.universal.valid()) {
+        return false;
+    }
+    const std::vector<GroupElement>& aux = proof.get_auxiliary_data();
+    if (aux.size() != 1 || aux[0] != state.universal || !universal_group.contains(proof.get_commitment())) {
+        return false;
+    }
+
+    // 检查 0 < a < x 且 U^a = d^x · h，h 为未知阶群的基
+    BigInt x = CryptoUtils::hash_to_prime(element);
+    const BigInt& a = proof.get_response();
+    if (a.is_zero() || a >= x) {
+        return false;
+    }
+    return universal_group.canonical(state.universal ^ a) ==
+           universal_group.canonical((proof.get_commitment() ^ x) * universal_group.get_base());
+}
+
+bool ESAVerifier::verify_aggregate_witness(const GroupElement& witness, const std::vector<BigInt>& elements,
+                                           uint64_t epoch) const {
+    Epoch state;
+    if (!universal_group.contains(witness) || elements.empty() || !lookup(epoch, state) || !state.universal.valid()) {
+        return false;
+    }
+    std::vector<BigInt> factors;
+    factors.reserve(elements.size());
+    for (const auto& element : elements) {
+        factors.push_back(CryptoUtils::hash_to_prime(element));
+    }
+    return universal_group.canonical(witness ^ CryptoUtils::balanced_product(std::move(factors))) == state.universal;
+}
@@ -0,0 +1,99 @@
+#include "fixed_base_table.h"
+#include <openssl/bn.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t kSharedTableLimit = 64;
+
+std::mutex shared_mutex;
+std::unordered_map<std::string, std::shared_ptr<const FixedBaseTable>> shared_tables;
+
+} // namespace
+
+FixedBaseTable::FixedBaseTable(const GroupElement& base, size_t exponent_bits, int window)
+    : base(base), bits(exponent_bits), window(window), mont(nullptr) {
+    const BIGNUM* modulus = base.get_modulus().get_const_bn();
+    if (!base.valid() || !BN_is_odd(modulus)) {
+        return;
+    }
+    BigIntArena::CtxGuard ctx;
+    mont = BN_MONT_CTX_new();
+    BN_MONT_CTX_set(mont, modulus, ctx);
+
+    size_t width = (size_t(1) << window) - 1;
+    size_t windows = (bits + window - 1) / window;
+    table.resize(windows * width);
+    BigInt power;   // 当前窗口的 g^(2^(w·j))
+    BN_to_montgomery(power.get_bn(), base.get_value().get_const_bn(), mont, ctx);
+    for (size_t j = 0; j < windows; j++) {
+        BigInt* row = &table[j * width];
+        row[0] = power;
+        for (size_t d = 1; d < width; d++) {
+            BN_mod_mul_montgomery(row[d].get_bn(), row[d - 1].get_bn(), power.get_bn(), mont, ctx);
+        }
+        // g^((2^w-1)·2^(w·j)) · g^(2^(w·j)) = g^(2^(w·(j+1)))
+        BN_mod_mul_montgomery(power.get_bn(), row[width - 1].get_bn(), power.get_bn(), mont, ctx);
+    }
+}
+
+FixedBaseTable::~FixedBaseTable() {
+    if (mont) {
+        BN_MONT_CTX_free(mont);
+    }
+}
+
+GroupElement FixedBaseTable::pow(const BigInt& exponent) const {
+    const BIGNUM* e = exponent.get_const_bn();
+    if (!mont || BN_is_negative(e) || size_t(BN_num_bits(e)) > bits) {
+        return base ^ exponent;
+    }
+    if (BN_is_zero(e)) {
+        return GroupElement::identity(base.get_modulus());
+    }
+    BigIntArena::CtxGuard ctx;
+    size_t width = (size_t(1) << window) - 1;
+    size_t windows = (size_t(BN_num_bits(e)) + window - 1) / window;
+    BigInt acc;
+    bool started = false;
+    for (size_t j = 0; j < windows; j++) {
+        unsigned digit = 0;
+        for (int b = window - 1; b >= 0; b--) {
+            digit = (digit << 1) | (BN_is_bit_set(e, int(j * window) + b) ? 1u : 0u);
+        }
+        if (digit == 0) {
+            continue;
+        }
+        const BigInt& entry = table[j * width + digit - 1];
+        if (started) {
+            BN_mod_mul_montgomery(acc.get_bn(), acc.get_bn(), entry.get_bn(), mont, ctx);
+        } else {
+            acc = entry;
+            started = true;
+        }
+    }
+    BigInt value;
+    BN_from_montgomery(value.get_bn(), acc.get_bn(), mont, ctx);
+    return GroupElement(value, base.get_modulus());
+}
+
+std::shared_ptr<const FixedBaseTable> FixedBaseTable::shared(const GroupElement& base, size_t exponent_bits) {
+    std::string key = base.get_modulus().to_string(16) + ":" + base.get_value().to_string(16) + ":" +
+                      std::to_string(exponent_bits);
+    {
+        std::lock_guard<std::mutex> lock(shared_mutex);
+        auto it = shared_tables.find(key);
+        if (it != shared_tables.end()) {
+            return it->second;
+        }
+    }
+    // 建表不持锁，两个线程同时建同一张表时保留先插入的那张
+    auto table = std::make_shared<const FixedBaseTable>(base, exponent_bits);
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    if (shared_tables.size() >= kSharedTableLimit) {
+        shared_tables.clear();   // 已取走的表由持有者的shared_ptr保活
+    }
+    return shared_tables.emplace(key, table).first->second;
+}
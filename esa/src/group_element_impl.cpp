@@ -20,6 +20,15 @@ GroupElement GroupElement::operator^(const BigInt& exponent) const {
     return GroupElement(result_value, modulus);
 }
 
+GroupElement GroupElement::pow_secret(const BigInt& exponent) const {
+    if (!is_valid) {
+        return GroupElement();
+    }
+    
+    BigInt result_value = CryptoUtils::mod_pow_secret(value, exponent, modulus);
+    return GroupElement(result_value, modulus);
+}
+
 GroupElement GroupElement::inverse() const {
     if (!is_valid || value.is_zero()) {
         return GroupElement();
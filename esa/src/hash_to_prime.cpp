@@ -0,0 +1,421 @@
+#include "hash_to_prime.h"
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <cmath>
+
+namespace {
+    const uint64_t kWheel = 2 * 3 * 5 * 7 * 11 * 13;  // 30030
+    const uint64_t kTrialLimit = 1024;
+    const size_t kCandidateBytes = SHA256_DIGEST_LENGTH;  // 256位候选
+
+    // 与轮模数互素的余数表
+    const std::vector<uint8_t>& wheel_table() {
+        static const std::vector<uint8_t> table = []() {
+            std::vector<uint8_t> coprime(kWheel, 1);
+            for (uint64_t p : {2, 3, 5, 7, 11, 13}) {
+                for (uint64_t r = 0; r < kWheel; r += p) {
+                    coprime[r] = 0;
+                }
+            }
+            return coprime;
+        }();
+        return table;
+    }
+
+    // 17 到 kTrialLimit 之间的素数，轮已经覆盖了更小的素数。
+    // 奇素数p整除n当且仅当 n·p^-1 mod 2^64 <= (2^64-1)/p，试除只需一次乘法和比较
+    struct TrialPrime {
+        uint64_t prime;
+        uint64_t inverse;
+        uint64_t limit;
+    };
+
+    const std::vector<TrialPrime>& trial_primes() {
+        static const std::vector<TrialPrime> primes = []() {
+            std::vector<bool> composite(kTrialLimit, false);
+            std::vector<TrialPrime> result;
+            for (uint64_t i = 2; i < kTrialLimit; i++) {
+                if (composite[i]) {
+                    continue;
+                }
+                if (i >= 17) {
+                    uint64_t inverse = i;
+                    for (int k = 0; k < 5; k++) {
+                        inverse *= 2 - i * inverse;
+                    }
+                    result.push_back({i, inverse, UINT64_MAX / i});
+                }
+                for (uint64_t j = i * i; j < kTrialLimit; j += i) {
+                    composite[j] = true;
+                }
+            }
+            return result;
+        }();
+        return primes;
+    }
+
+    // 64位奇模数上的Montgomery乘法，R = 2^64，避免每次乘法都做128位除法
+    struct Montgomery {
+        uint64_t n;
+        uint64_t n_inverse;   // n^-1 mod 2^64
+        uint64_t r2;          // R^2 mod n
+        uint64_t one;         // R mod n
+
+        explicit Montgomery(uint64_t modulus) : n(modulus) {
+            uint64_t x = n;   // 牛顿迭代，每次有效位数翻倍
+            for (int i = 0; i < 5; i++) {
+                x *= 2 - n * x;
+            }
+            n_inverse = x;
+            one = (0 - n) % n;
+            r2 = static_cast<uint64_t>(static_cast<unsigned __int128>(one) * one % n);
+        }
+
+        uint64_t reduce(unsigned __int128 t) const {
+            uint64_t m = static_cast<uint64_t>(t) * n_inverse;
+            uint64_t mn_high = static_cast<uint64_t>((static_cast<unsigned __int128>(m) * n) >> 64);
+            uint64_t t_high = static_cast<uint64_t>(t >> 64);
+            return t_high >= mn_high ? t_high - mn_high : t_high - mn_high + n;
+        }
+
+        uint64_t mul(uint64_t a, uint64_t b) const {
+            return reduce(static_cast<unsigned __int128>(a) * b);
+        }
+
+        uint64_t to(uint64_t a) const {
+            return mul(a % n, r2);
+        }
+
+        uint64_t add(uint64_t a, uint64_t b) const {
+            return a >= n - b ? a - (n - b) : a + b;
+        }
+
+        uint64_t sub(uint64_t a, uint64_t b) const {
+            return a >= b ? a - b : a + (n - b);
+        }
+
+        // a/2，对Montgomery表示同样成立
+        uint64_t half(uint64_t a) const {
+            return (a & 1) ? (a >> 1) + (n >> 1) + 1 : a >> 1;
+        }
+    };
+
+    // 以2为底的强伪素数检验，n为大于2的奇数
+    bool strong_probable_prime_base2(const Montgomery& mont) {
+        uint64_t n = mont.n;
+        uint64_t d = n - 1;
+        int s = 0;
+        while ((d & 1) == 0) {
+            d >>= 1;
+            s++;
+        }
+        uint64_t minus_one = n - mont.one;
+        uint64_t base = mont.to(2);
+        uint64_t x = mont.one;
+        for (int bit = 63 - __builtin_clzll(d); bit >= 0; bit--) {
+            x = mont.mul(x, x);
+            if ((d >> bit) & 1) {
+                x = mont.mul(x, base);
+            }
+        }
+        if (x == mont.one || x == minus_one) {
+            return true;
+        }
+        for (int r = 1; r < s; r++) {
+            x = mont.mul(x, x);
+            if (x == minus_one) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool is_square(uint64_t n) {
+        uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<long double>(n)));
+        while (static_cast<unsigned __int128>(root) * root > n) {
+            root--;
+        }
+        while (static_cast<unsigned __int128>(root + 1) * (root + 1) <= n) {
+            root++;
+        }
+        return root * root == n;
+    }
+
+    // Jacobi符号 (a/n)，n为正奇数
+    int jacobi(uint64_t a, uint64_t n) {
+        int result = 1;
+        a %= n;
+        while (a != 0) {
+            while ((a & 1) == 0) {
+                a >>= 1;
+                uint64_t r = n & 7;
+                if (r == 3 || r == 5) {
+                    result = -result;
+                }
+            }
+            std::swap(a, n);
+            if ((a & 3) == 3 && (n & 3) == 3) {
+                result = -result;
+            }
+            a %= n;
+        }
+        return n == 1 ? result : 0;
+    }
+
+    uint64_t signed_mod(int64_t value, uint64_t n) {
+        return value >= 0 ? static_cast<uint64_t>(value) % n
+                          : (n - static_cast<uint64_t>(-value) % n) % n;
+    }
+
+    // Selfridge方法A选参数的强Lucas检验：D取5,-7,9,-11,...中第一个使(D/n)=-1的值，P=1，Q=(1-D)/4
+    bool strong_lucas_probable_prime(const Montgomery& mont) {
+        uint64_t n = mont.n;
+        int64_t d_signed = 5;
+        while (true) {
+            int j = jacobi(signed_mod(d_signed, n), n);
+            if (j == -1) {
+                break;
+            }
+            if (j == 0 && static_cast<uint64_t>(d_signed > 0 ? d_signed : -d_signed) != n) {
+                return false;  // D与n有公因子
+            }
+            d_signed = d_signed > 0 ? -(d_signed + 2) : -d_signed + 2;
+        }
+        uint64_t d_mont = mont.to(signed_mod(d_signed, n));
+        uint64_t q_mont = mont.to(signed_mod((1 - d_signed) / 4, n));
+
+        // n+1 = k·2^s，k为奇数；n为奇数时 (n+1)/2 不会溢出
+        uint64_t k = (n >> 1) + 1;
+        int s = 1;
+        while ((k & 1) == 0) {
+            k >>= 1;
+            s++;
+        }
+
+        // 从 (U_1, V_1, Q^1) = (1, P, Q) 开始按k的二进制位倍增，P=1
+        uint64_t u = mont.one;
+        uint64_t v = mont.one;
+        uint64_t qk = q_mont;
+        for (int bit = 62 - __builtin_clzll(k); bit >= 0; bit--) {
+            u = mont.mul(u, v);
+            v = mont.sub(mont.mul(v, v), mont.add(qk, qk));
+            qk = mont.mul(qk, qk);
+            if ((k >> bit) & 1) {
+                uint64_t next_u = mont.half(mont.add(u, v));                     // (P·U + V)/2
+                uint64_t next_v = mont.half(mont.add(mont.mul(d_mont, u), v));   // (D·U + P·V)/2
+                u = next_u;
+                v = next_v;
+                qk = mont.mul(qk, q_mont);
+            }
+        }
+        if (u == 0 || v == 0) {
+            return true;
+        }
+        for (int r = 1; r < s; r++) {
+            v = mont.sub(mont.mul(v, v), mont.add(qk, qk));
+            qk = mont.mul(qk, qk);
+            if (v == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const EVP_MD* sha256_md() {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        static EVP_MD* md = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+        return md;
+#else
+        return EVP_sha256();
+#endif
+    }
+
+    // 每个线程复用一对上下文：prefix吸收前缀和元素，每个计数器从它复制出中间状态
+    struct DigestContexts {
+        EVP_MD_CTX* prefix = EVP_MD_CTX_new();
+        EVP_MD_CTX* counter = EVP_MD_CTX_new();
+        ~DigestContexts() {
+            EVP_MD_CTX_free(prefix);
+            EVP_MD_CTX_free(counter);
+        }
+    };
+
+    DigestContexts& digest_contexts() {
+        thread_local DigestContexts contexts;
+        return contexts;
+    }
+
+    // 已经排除小因子之后的Baillie-PSW部分
+    bool bpsw_after_trial_division(uint64_t n) {
+        Montgomery mont(n);
+        return strong_probable_prime_base2(mont) && !is_square(n) && strong_lucas_probable_prime(mont);
+    }
+
+    // 宽候选的试除按组进行：组内小素数之积不超过2^32，候选按32位字做Horner求余，
+    // 每组只需8次64位取模，再由组余数得到组内各个素数的余数
+    struct SieveGroup {
+        uint64_t modulus;
+        std::vector<uint64_t> primes;
+    };
+
+    const std::vector<SieveGroup>& sieve_groups() {
+        static const std::vector<SieveGroup> groups = []() {
+            std::vector<SieveGroup> result;
+            SieveGroup current{1, {}};
+            for (const auto& p : trial_primes()) {
+                if (current.modulus * p.prime > UINT32_MAX) {
+                    result.push_back(std::move(current));
+                    current = SieveGroup{1, {}};
+                }
+                current.modulus *= p.prime;
+                current.primes.push_back(p.prime);
+            }
+            if (!current.primes.empty()) {
+                result.push_back(std::move(current));
+            }
+            return result;
+        }();
+        return groups;
+    }
+
+    // 大端字节串对不超过2^32的模数求余
+    uint64_t residue(const uint8_t* bytes, uint64_t modulus) {
+        uint64_t r = 0;
+        for (size_t i = 0; i < kCandidateBytes; i += 4) {
+            uint64_t word = (static_cast<uint64_t>(bytes[i]) << 24) | (static_cast<uint64_t>(bytes[i + 1]) << 16) |
+                            (static_cast<uint64_t>(bytes[i + 2]) << 8) | bytes[i + 3];
+            r = ((r << 32) | word) % modulus;
+        }
+        return r;
+    }
+
+    // 轮筛和试除，true表示没有找到小因子
+    bool survives_sieve(const uint8_t* candidate) {
+        if (!wheel_table()[residue(candidate, kWheel)]) {
+            return false;
+        }
+        for (const auto& group : sieve_groups()) {
+            uint64_t r = residue(candidate, group.modulus);
+            for (uint64_t p : group.primes) {
+                if (r % p == 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// HashToPrimeEngine 实现
+HashToPrimeEngine::HashToPrimeEngine(size_t cache_capacity) : capacity(cache_capacity) {}
+
+HashToPrimeEngine& HashToPrimeEngine::shared() {
+    static HashToPrimeEngine engine;
+    return engine;
+}
+
+bool HashToPrimeEngine::baillie_psw(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t p : {2, 3, 5, 7, 11, 13}) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+    for (const auto& p : trial_primes()) {
+        if (n * p.inverse <= p.limit) {
+            return n == p.prime;
+        }
+    }
+    if (n < kTrialLimit * kTrialLimit) {
+        return true;  // 没有不超过平方根的因子
+    }
+    return bpsw_after_trial_division(n);
+}
+
+std::string HashToPrimeEngine::search(const std::string& element_bytes, Stats& local) {
+    static const char kDomain[] = "esa-h2p";
+    DigestContexts& contexts = digest_contexts();
+    EVP_DigestInit_ex(contexts.prefix, sha256_md(), nullptr);
+    EVP_DigestUpdate(contexts.prefix, kDomain, sizeof(kDomain) - 1);
+    EVP_DigestUpdate(contexts.prefix, element_bytes.data(), element_bytes.size());
+
+    for (uint64_t i = 0;; i++) {
+        uint8_t counter[8];
+        for (int j = 7; j >= 0; j--) {
+            counter[j] = static_cast<uint8_t>((i >> (8 * (7 - j))) & 0xff);
+        }
+        uint8_t candidate[kCandidateBytes];
+        EVP_MD_CTX_copy_ex(contexts.counter, contexts.prefix);
+        EVP_DigestUpdate(contexts.counter, counter, sizeof(counter));
+        EVP_DigestFinal_ex(contexts.counter, candidate, nullptr);
+
+        // 固定最高位和最低位，候选恰好256位且为奇数
+        candidate[0] |= 0x80;
+        candidate[kCandidateBytes - 1] |= 1;
+        local.candidates++;
+        if (!survives_sieve(candidate)) {
+            local.sieved++;
+            continue;
+        }
+        local.prime_tests++;
+        if (CryptoUtils::is_prime(BigInt::from_bytes(std::vector<uint8_t>(candidate, candidate + kCandidateBytes)))) {
+            return std::string(reinterpret_cast<const char*>(candidate), kCandidateBytes);
+        }
+    }
+}
+
+BigInt HashToPrimeEngine::prime_for(const BigInt& element) {
+    std::vector<uint8_t> bytes = element.to_bytes();
+    std::string key(bytes.begin(), bytes.end());
+    std::string prime;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            lru.splice(lru.begin(), lru, it->second);
+            counters.hits++;
+            prime = it->second->second;
+        }
+    }
+    if (!prime.empty()) {
+        return BigInt::from_bytes(std::vector<uint8_t>(prime.begin(), prime.end()));
+    }
+
+    // 搜索不持锁，并发未命中同一元素时各自算出相同的结果
+    Stats local;
+    prime = search(key, local);
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        counters.misses++;
+        counters.candidates += local.candidates;
+        counters.sieved += local.sieved;
+        counters.prime_tests += local.prime_tests;
+        if (capacity > 0 && !index.count(key)) {
+            lru.emplace_front(key, prime);
+            index.emplace(std::move(key), lru.begin());
+            if (index.size() > capacity) {
+                index.erase(lru.back().first);
+                lru.pop_back();
+            }
+        }
+    }
+    return BigInt::from_bytes(std::vector<uint8_t>(prime.begin(), prime.end()));
+}
+
+HashToPrimeEngine::Stats HashToPrimeEngine::stats() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return counters;
+}
+
+size_t HashToPrimeEngine::cache_size() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return index.size();
+}
+
+void HashToPrimeEngine::clear_cache() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    lru.clear();
+    index.clear();
+}
@@ -0,0 +1,325 @@
+#include "esa_accumulator.h"
+#include "parallel.h"
+#include <openssl/bn.h>
+#include <algorithm>
+
+// 多重幂 ∏ b_i^{e_i} mod m
+// 项数少时用Straus交错窗口：每个底数预计算一张小表，所有项共用同一串平方；
+// 项数多时用Pippenger桶方法：每个窗口按数字把底数归入桶，再用后缀和一次合并所有桶。
+// 乘法都在Montgomery域中进行，各线程共享同一个BN_MONT_CTX（设置后OpenSSL只读取它）。
+// 窗口数字只取指数的绝对值，负指数先换成底数的逆元和 |e|
+
+namespace {
+
+constexpr size_t kStrausMaxTerms = 32;
+constexpr size_t kMinTermsPerThread = 64;
+
+// 指数从第low位起width位构成的数字
+unsigned window_digit(const BIGNUM* e, int low, int width) {
+    unsigned digit = 0;
+    for (int b = width - 1; b >= 0; b--) {
+        digit = (digit << 1) | (BN_is_bit_set(e, low + b) ? 1u : 0u);
+    }
+    return digit;
+}
+
+class MontMultiExp {
+public:
+    MontMultiExp(const BIGNUM* modulus, BN_MONT_CTX* mont, BN_CTX* ctx)
+        : modulus(modulus), mont(mont), ctx(ctx) {}
+
+    // [begin, end) 区间各项的积，结果留在Montgomery域
+    BigInt run(const std::vector<const BIGNUM*>& bases, const std::vector<const BIGNUM*>& exponents,
+               size_t begin, size_t end) {
+        size_t count = end - begin;
+        std::vector<BigInt> mont_bases(count);
+        std::vector<const BIGNUM*> exps(exponents.begin() + begin, exponents.begin() + end);
+        int max_bits = 0;
+        for (size_t i = 0; i < count; i++) {
+            BN_nnmod(mont_bases[i].get_bn(), bases[begin + i], modulus, ctx);
+            BN_to_montgomery(mont_bases[i].get_bn(), mont_bases[i].get_bn(), mont, ctx);
+            max_bits = std::max(max_bits, BN_num_bits(exps[i]));
+        }
+        if (max_bits == 0) {
+            return one();
+        }
+        return count <= kStrausMaxTerms ? straus(mont_bases, exps, max_bits)
+                                        : pippenger(mont_bases, exps, max_bits);
+    }
+
+    BigInt one() {
+        BigInt r;
+        BN_to_montgomery(r.get_bn(), BN_value_one(), mont, ctx);
+        return r;
+    }
+
+    void mul(BigInt& r, const BigInt& a, const BigInt& b) {
+        BN_mod_mul_montgomery(r.get_bn(), a.get_bn(), b.get_bn(), mont, ctx);
+    }
+
+private:
+    const BIGNUM* modulus;
+    BN_MONT_CTX* mont;
+    BN_CTX* ctx;
+
+    BigInt straus(const std::vector<BigInt>& mont_bases, const std::vector<const BIGNUM*>& exps, int max_bits) {
+        // 每项代价约为 建表(2^w-2) + 窗口数，取最小的w
+        int w = 1;
+        int best = max_bits;
+        for (int cand = 2; cand <= 6; cand++) {
+            int cost = ((1 << cand) - 2) + (max_bits + cand - 1) / cand;
+            if (cost < best) {
+                best = cost;
+                w = cand;
+            }
+        }
+        size_t width = (size_t(1) << w) - 1;
+        std::vector<BigInt> table(mont_bases.size() * width);
+        for (size_t i = 0; i < mont_bases.size(); i++) {
+            table[i * width] = mont_bases[i];
+            for (size_t d = 1; d < width; d++) {
+                mul(table[i * width + d], table[i * width + d - 1], mont_bases[i]);
+            }
+        }
+
+        BigInt acc;
+        bool started = false;
+        int windows = (max_bits + w - 1) / w;
+        for (int win = windows - 1; win >= 0; win--) {
+            if (started) {
+                for (int s = 0; s < w; s++) {
+                    mul(acc, acc, acc);
+                }
+            }
+            for (size_t i = 0; i < exps.size(); i++) {
+                unsigned digit = window_digit(exps[i], win * w, w);
+                if (digit == 0) {
+                    continue;
+                }
+                const BigInt& entry = table[i * width + digit - 1];
+                if (started) {
+                    mul(acc, acc, entry);
+                } else {
+                    acc = entry;
+                    started = true;
+                }
+            }
+        }
+        return started ? acc : one();
+    }
+
+    BigInt pippenger(const std::vector<BigInt>& mont_bases, const std::vector<const BIGNUM*>& exps, int max_bits) {
+        // 每个窗口代价约为 n次入桶 + 2·2^c次合并，取总代价最小的c
+        size_t n = mont_bases.size();
+        int c = 1;
+        size_t best = size_t(max_bits) * (n + 4);
+        for (int cand = 2; cand <= 16; cand++) {
+            size_t windows = size_t((max_bits + cand - 1) / cand);
+            size_t cost = windows * (n + (size_t(2) << cand)) + size_t(max_bits);
+            if (cost < best) {
+                best = cost;
+                c = cand;
+            }
+        }
+
+        size_t bucket_count = size_t(1) << c;
+        std::vector<BigInt> buckets(bucket_count);
+        std::vector<char> filled(bucket_count, 0);
+        BigInt result, running, sum;
+        bool started = false;
+        int windows = (max_bits + c - 1) / c;
+        for (int win = windows - 1; win >= 0; win--) {
+            if (started) {
+                for (int s = 0; s < c; s++) {
+                    mul(result, result, result);
+                }
+            }
+            for (size_t i = 0; i < n; i++) {
+                unsigned digit = window_digit(exps[i], win * c, c);
+                if (digit == 0) {
+                    continue;
+                }
+                if (filled[digit]) {
+                    mul(buckets[digit], buckets[digit], mont_bases[i]);
+                } else {
+                    buckets[digit] = mont_bases[i];
+                    filled[digit] = 1;
+                }
+            }
+            // 后缀和：running = ∏_{k>=j} B_k，sum = ∏_j running_j = ∏_k B_k^k
+            bool has_running = false;
+            bool has_sum = false;
+            for (size_t j = bucket_count - 1; j >= 1; j--) {
+                if (filled[j]) {
+                    if (has_running) {
+                        mul(running, running, buckets[j]);
+                    } else {
+                        running = buckets[j];
+                        has_running = true;
+                    }
+                    filled[j] = 0;
+                }
+                if (has_running) {
+                    if (has_sum) {
+                        mul(sum, sum, running);
+                    } else {
+                        sum = running;
+                        has_sum = true;
+                    }
+                }
+            }
+            if (has_sum) {
+                if (started) {
+                    mul(result, result, sum);
+                } else {
+                    result = sum;
+                    started = true;
+                }
+            }
+        }
+        return started ? result : one();
+    }
+};
+
+// 负指数 b^{-e} = (b^{-1})^{e}，逆元和绝对值存入storage，bases/exponents改为指向它们；
+// 底数与模数不互素时没有逆元，返回false
+bool normalize_signs(std::vector<const BIGNUM*>& bases, std::vector<const BIGNUM*>& exponents,
+                     std::vector<BigInt>& storage, const BigInt& modulus, BN_CTX* ctx) {
+    size_t negative = 0;
+    for (const BIGNUM* e : exponents) {
+        negative += BN_is_negative(e) ? 1 : 0;
+    }
+    // 指针指向storage中的元素，预留空间避免扩容后失效
+    storage.reserve(2 * negative);
+    for (size_t i = 0; i < exponents.size(); i++) {
+        if (!BN_is_negative(exponents[i])) {
+            continue;
+        }
+        storage.emplace_back();
+        if (!BN_mod_inverse(storage.back().get_bn(), bases[i], modulus.get_const_bn(), ctx)) {
+            return false;
+        }
+        bases[i] = storage.back().get_const_bn();
+        storage.emplace_back();
+        BN_copy(storage.back().get_bn(), exponents[i]);
+        BN_set_negative(storage.back().get_bn(), 0);
+        exponents[i] = storage.back().get_const_bn();
+    }
+    return true;
+}
+
+// 成功时结果写入result；模数为0、底数不可逆或Montgomery上下文创建失败时返回false
+bool multi_exp_raw(std::vector<const BIGNUM*> bases, std::vector<const BIGNUM*> exponents,
+                   const BigInt& modulus, size_t threads, BigInt& result) {
+    size_t n = std::min(bases.size(), exponents.size());
+    bases.resize(n);
+    exponents.resize(n);
+    BigIntArena::CtxGuard ctx;
+    if (modulus.is_zero()) {
+        return false;
+    }
+    std::vector<BigInt> storage;
+    if (!normalize_signs(bases, exponents, storage, modulus, ctx)) {
+        return false;
+    }
+    // Montgomery乘法要求奇模数，偶模数退回逐项模幂
+    if (!BN_is_odd(modulus.get_const_bn())) {
+        BN_one(result.get_bn());
+        BN_nnmod(result.get_bn(), result.get_bn(), modulus.get_const_bn(), ctx);
+        BigInt term;
+        for (size_t i = 0; i < n; i++) {
+            BN_mod_exp(term.get_bn(), bases[i], exponents[i], modulus.get_const_bn(), ctx);
+            BN_mod_mul(result.get_bn(), result.get_bn(), term.get_bn(), modulus.get_const_bn(), ctx);
+        }
+        return true;
+    }
+
+    BN_MONT_CTX* mont = BN_MONT_CTX_new();
+    if (!mont || !BN_MONT_CTX_set(mont, modulus.get_const_bn(), ctx)) {
+        BN_MONT_CTX_free(mont);
+        return false;
+    }
+    MontMultiExp engine(modulus.get_const_bn(), mont, ctx);
+
+    size_t workers = std::max<size_t>(1, std::min(threads, n / kMinTermsPerThread));
+    BigInt acc;
+    bool ok = true;
+    if (workers == 1) {
+        acc = engine.run(bases, exponents, 0, n);
+    } else {
+        // 每个线程用自己的BN_CTX计算一段，最后在调用线程中相乘
+        std::vector<BigInt> partial(workers);
+        std::vector<char> failed(workers, 0);
+        Parallel::ranges(n, workers, [&](size_t worker, size_t begin, size_t end) {
+            if (worker == 0) {
+                partial[0] = engine.run(bases, exponents, begin, end);
+                return;
+            }
+            BN_CTX* local_ctx = BN_CTX_new();
+            if (!local_ctx) {
+                failed[worker] = 1;
+                return;
+            }
+            {
+                MontMultiExp local(modulus.get_const_bn(), mont, local_ctx);
+                BigInt part = local.run(bases, exponents, begin, end);
+                BN_copy(partial[worker].get_bn(), part.get_const_bn());
+            }
+            BN_CTX_free(local_ctx);
+        });
+        ok = std::find(failed.begin(), failed.end(), 1) == failed.end();
+        acc = partial[0];
+        for (size_t t = 1; t < workers && ok; t++) {
+            engine.mul(acc, acc, partial[t]);
+        }
+    }
+    if (ok) {
+        BN_from_montgomery(result.get_bn(), acc.get_bn(), mont, ctx);
+    }
+    BN_MONT_CTX_free(mont);
+    return ok;
+}
+
+} // namespace
+
+namespace CryptoUtils {
+    BigInt multi_exp(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents,
+                     const BigInt& modulus, size_t threads) {
+        std::vector<const BIGNUM*> base_bns, exp_bns;
+        size_t n = std::min(bases.size(), exponents.size());
+        base_bns.reserve(n);
+        exp_bns.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            base_bns.push_back(bases[i].get_const_bn());
+            exp_bns.push_back(exponents[i].get_const_bn());
+        }
+        BigInt result;
+        if (!multi_exp_raw(std::move(base_bns), std::move(exp_bns), modulus, threads, result)) {
+            return BigInt();
+        }
+        return result;
+    }
+
+    GroupElement multi_exp(const std::vector<GroupElement>& bases, const std::vector<BigInt>& exponents,
+                           size_t threads) {
+        if (bases.empty() || bases.size() != exponents.size()) {
+            return GroupElement();
+        }
+        const BigInt& modulus = bases[0].get_modulus();
+        std::vector<const BIGNUM*> base_bns, exp_bns;
+        base_bns.reserve(bases.size());
+        exp_bns.reserve(bases.size());
+        for (size_t i = 0; i < bases.size(); i++) {
+            if (!bases[i].valid() || bases[i].get_modulus() != modulus) {
+                return GroupElement();
+            }
+            base_bns.push_back(bases[i].get_value().get_const_bn());
+            exp_bns.push_back(exponents[i].get_const_bn());
+        }
+        BigInt result;
+        if (!multi_exp_raw(std::move(base_bns), std::move(exp_bns), modulus, threads, result)) {
+            return GroupElement();
+        }
+        return GroupElement(result, modulus);
+    }
+}
@@ -0,0 +1,143 @@
+#include "nonce_pool.h"
+#include "fixed_base_table.h"
+#include "secure_random.h"
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// 后台补充线程只使用空闲CPU，不与请求路径争抢
+void lower_thread_priority() {
+#ifdef __linux__
+    sched_param param{};
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+}
+
+} // namespace
+
+// NoncePool 实现
+NoncePool::NoncePool(const GroupElement& generator, const BigInt& exponent_order)
+    : NoncePool(generator, exponent_order, Config()) {}
+
+NoncePool::NoncePool(const GroupElement& generator, const BigInt& exponent_order, const Config& config)
+    : generator(generator), exponent_order(exponent_order), config(config), stopping(false) {
+    if (this->config.capacity == 0) {
+        this->config.capacity = 1;
+    }
+    if (this->config.batch_size == 0) {
+        this->config.batch_size = 1;
+    }
+    this->config.low_watermark = std::min(this->config.low_watermark, this->config.capacity - 1);
+    if (!this->config.constant_time) {
+        table = FixedBaseTable::shared(generator, exponent_order.bit_length());
+    }
+    counters.capacity = this->config.capacity;
+    worker = std::thread(&NoncePool::refill_loop, this);
+}
+
+NoncePool::~NoncePool() {
+    stop();
+}
+
+void NoncePool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+    refill_needed.notify_all();
+    worker.join();
+}
+
+NoncePool::Stats NoncePool::stats() const {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    Stats snapshot = counters;
+    snapshot.depth = queue.size();
+    return snapshot;
+}
+
+std::vector<NoncePool::Nonce> NoncePool::compute(size_t count) const {
+    std::vector<BigInt> exponents = SecureRandom::local().uniform_batch(BigInt("1"), exponent_order, count);
+    std::vector<Nonce> nonces;
+    nonces.reserve(count);
+    for (auto& r : exponents) {
+        GroupElement commitment = table ? table->pow(r) : generator.pow_secret(r);
+        nonces.push_back(Nonce{std::move(r), std::move(commitment)});
+    }
+    return nonces;
+}
+
+NoncePool::Nonce NoncePool::take() {
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (!queue.empty()) {
+            Nonce nonce = std::move(queue.front());
+            queue.pop_front();
+            counters.served++;
+            bool low = queue.size() == config.low_watermark;
+            lock.unlock();
+            if (low) {
+                refill_needed.notify_one();
+            }
+            return nonce;
+        }
+        counters.exhausted++;
+    }
+    refill_needed.notify_one();
+    return std::move(compute(1).front());
+}
+
+void NoncePool::prefill() {
+    while (true) {
+        size_t missing;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            missing = config.capacity - std::min(queue.size(), config.capacity);
+        }
+        if (missing == 0) {
+            return;
+        }
+        std::vector<Nonce> nonces = compute(std::min(missing, config.batch_size));
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        for (auto& nonce : nonces) {
+            if (queue.size() >= config.capacity) {
+                break;
+            }
+            queue.push_back(std::move(nonce));
+            counters.produced++;
+        }
+    }
+}
+
+void NoncePool::refill_loop() {
+    lower_thread_priority();
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (true) {
+        refill_needed.wait(lock, [this]() { return stopping || queue.size() <= config.low_watermark; });
+        if (stopping) {
+            return;
+        }
+        counters.refills++;
+        // 补到容量上限，计算时不持锁，每批入队一次
+        while (!stopping && queue.size() < config.capacity) {
+            size_t count = std::min(config.capacity - queue.size(), config.batch_size);
+            lock.unlock();
+            std::vector<Nonce> nonces = compute(count);
+            lock.lock();
+            for (auto& nonce : nonces) {
+                if (queue.size() >= config.capacity) {
+                    break;
+                }
+                queue.push_back(std::move(nonce));
+                counters.produced++;
+            }
+        }
+    }
+}
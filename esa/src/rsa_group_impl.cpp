@@ -0,0 +1,60 @@
+#include "esa_accumulator.h"
+#include <openssl/bn.h>
+
+namespace {
+
+// RSA Factoring Challenge 的 RSA-2048（617位十进制）
+const char* const kRSA2048 =
+    "25195908475657893494027183240048398571429282126204032027777137836043662020707595556264018525880784406918290641249515082189"
+    "29855914917618450280848912007284499268739280728777673597141834727026189637501497182469116507761337985909570009733045974880"
+    "84284017974291006424586918171951187461215151726546322822168699875491824224336372590851418654620435767984233871847744479207"
+    "39934236584823824281198163815010674810451660377306056201619676256133844143603833904414952634432190114657544454178424020924"
+    "616515723350778707749817125772467962926386356373289912154831438167899885040445364023527381951378636564391212010397122822120720357";
+
+} // namespace
+
+// RSAGroup 实现
+RSAGroup::RSAGroup(const BigInt& modulus, const BigInt& base)
+    : modulus(modulus), base(base, modulus) {}
+
+bool RSAGroup::valid() const {
+    if (!base.valid() || modulus.bit_length() < 1024 || !BN_is_odd(modulus.get_const_bn())) {
+        return false;
+    }
+    const BigInt& value = base.get_value();
+    return BigInt("1") < value && !CryptoUtils::mod_inverse(value, modulus).is_zero();
+}
+
+bool RSAGroup::contains(const GroupElement& element) const {
+    if (!element.valid() || element.get_modulus() != modulus || element.get_value().is_zero()) {
+        return false;
+    }
+    // N 为奇数，x 与 N-x 不会相等
+    return element.get_value() < modulus - element.get_value();
+}
+
+GroupElement RSAGroup::canonical(const GroupElement& element) const {
+    if (!element.valid() || element.get_modulus() != modulus) {
+        return element;
+    }
+    BigInt negated = modulus - element.get_value();
+    return negated < element.get_value() ? GroupElement(negated, modulus) : element;
+}
+
+RSAGroup RSAGroup::generate(size_t bits, BigInt* trapdoor) {
+    BigIntArena::Scope scope;
+    BigInt p, q;
+    do {
+        BN_generate_prime_ex(p.get_bn(), static_cast<int>(bits / 2), 0, nullptr, nullptr, nullptr);
+        BN_generate_prime_ex(q.get_bn(), static_cast<int>(bits - bits / 2), 0, nullptr, nullptr, nullptr);
+    } while (p == q);
+    if (trapdoor) {
+        *trapdoor = (p - BigInt("1")) * (q - BigInt("1"));
+    }
+    return RSAGroup(p * q, BigInt("4"));
+}
+
+const RSAGroup& RSAGroup::rsa2048() {
+    static const RSAGroup group(BigInt(kRSA2048), BigInt("4"));
+    return group;
+}
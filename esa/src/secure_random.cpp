@@ -0,0 +1,204 @@
+#include "secure_random.h"
+#include <openssl/bn.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace {
+
+constexpr size_t kBufferSize = 4096;
+constexpr uint64_t kReseedInterval = uint64_t(1) << 30;   // 每输出1GiB重新播种
+
+// 与摘要一样，OpenSSL 3 中只查找一次ChaCha20实现
+const EVP_CIPHER* chacha20() {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static EVP_CIPHER* cipher = EVP_CIPHER_fetch(nullptr, "ChaCha20", nullptr);
+    return cipher;
+#else
+    return EVP_chacha20();
+#endif
+}
+
+// fork后子进程与父进程持有相同的密钥和缓冲，子进程中递增代数使各实例在下次取数时重新播种。
+// 取数路径上只读一个原子变量，不必每次调用getpid
+std::atomic<uint64_t> fork_generation{0};
+
+uint64_t current_generation() {
+#if defined(__unix__) || defined(__APPLE__)
+    static std::once_flag registered;
+    std::call_once(registered, [] {
+        pthread_atfork(nullptr, nullptr, [] { fork_generation.fetch_add(1); });
+    });
+#endif
+    return fork_generation.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+SecureRandom::SecureRandom()
+    : cipher(EVP_CIPHER_CTX_new()), buffer(kBufferSize), position(kBufferSize), output_since_seed(0), seeded_generation(0) {
+    if (!cipher) {
+        throw std::runtime_error("SecureRandom: EVP_CIPHER_CTX_new failed");
+    }
+    try {
+        reseed();
+    } catch (...) {
+        EVP_CIPHER_CTX_free(cipher);
+        throw;
+    }
+}
+
+SecureRandom::~SecureRandom() {
+    OPENSSL_cleanse(key, sizeof(key));
+    OPENSSL_cleanse(buffer.data(), buffer.size());
+    EVP_CIPHER_CTX_free(cipher);
+}
+
+SecureRandom& SecureRandom::local() {
+    thread_local SecureRandom instance;
+    return instance;
+}
+
+void SecureRandom::discard() {
+    OPENSSL_cleanse(key, sizeof(key));
+    OPENSSL_cleanse(buffer.data(), buffer.size());
+    position = buffer.size();
+    // 下次取数必须先重新播种
+    output_since_seed = kReseedInterval;
+}
+
+void SecureRandom::reseed() {
+    // 播种失败时不能继续用旧密钥或全零密钥输出，清除状态后抛出，由C接口边界转换为错误码
+    if (RAND_bytes(key, sizeof(key)) != 1) {
+        discard();
+        throw std::runtime_error("SecureRandom: RAND_bytes failed to seed");
+    }
+    OPENSSL_cleanse(buffer.data(), buffer.size());
+    position = buffer.size();
+    output_since_seed = 0;
+    seeded_generation = current_generation();
+    counters.reseeds++;
+}
+
+void SecureRandom::refill() {
+    if (seeded_generation != fork_generation.load(std::memory_order_relaxed) || output_since_seed >= kReseedInterval) {
+        reseed();
+    }
+    // 每次都换新密钥，计数器和nonce全零即可
+    static const uint8_t iv[16] = {0};
+    uint8_t next_key[sizeof(key)] = {0};
+    int length = 0;
+    std::memset(buffer.data(), 0, buffer.size());
+    if (!chacha20() || EVP_EncryptInit_ex(cipher, chacha20(), nullptr, key, iv) != 1 ||
+        EVP_EncryptUpdate(cipher, next_key, &length, next_key, sizeof(next_key)) != 1 ||
+        EVP_EncryptUpdate(cipher, buffer.data(), &length, buffer.data(), static_cast<int>(buffer.size())) != 1) {
+        OPENSSL_cleanse(next_key, sizeof(next_key));
+        discard();
+        throw std::runtime_error("SecureRandom: ChaCha20 keystream failed");
+    }
+    std::memcpy(key, next_key, sizeof(key));
+    OPENSSL_cleanse(next_key, sizeof(next_key));
+
+    position = 0;
+    output_since_seed += buffer.size();
+    counters.refills++;
+}
+
+void SecureRandom::fill(uint8_t* out, size_t length) {
+    while (length > 0) {
+        if (position == buffer.size() || seeded_generation != fork_generation.load(std::memory_order_relaxed)) {
+            refill();
+        }
+        size_t take = std::min(length, buffer.size() - position);
+        std::memcpy(out, buffer.data() + position, take);
+        // 已输出的字节立即清除
+        OPENSSL_cleanse(buffer.data() + position, take);
+        position += take;
+        out += take;
+        length -= take;
+    }
+}
+
+uint64_t SecureRandom::next_u64() {
+    uint8_t bytes[8];
+    fill(bytes, sizeof(bytes));
+    uint64_t word = 0;
+    for (uint8_t b : bytes) {
+        word = (word << 8) | b;
+    }
+    return word;
+}
+
+void SecureRandom::sample_below(const BigInt& range, size_t range_bytes, uint8_t top_mask, BigInt& out) {
+    uint8_t bytes[512];
+    std::vector<uint8_t> large;
+    uint8_t* data = bytes;
+    if (range_bytes > sizeof(bytes)) {
+        large.resize(range_bytes);
+        data = large.data();
+    }
+    // 候选取与range相同的位数，接受概率不低于1/2
+    while (true) {
+        fill(data, range_bytes);
+        data[0] &= top_mask;
+        BN_bin2bn(data, static_cast<int>(range_bytes), out.get_bn());
+        if (BN_cmp(out.get_const_bn(), range.get_const_bn()) < 0) {
+            break;
+        }
+        counters.rejections++;
+    }
+    OPENSSL_cleanse(data, range_bytes);
+}
+
+BigInt SecureRandom::uniform(const BigInt& min, const BigInt& max) {
+    if (max <= min) {
+        return min;
+    }
+    BigInt range = max - min;
+    size_t range_bits = range.bit_length();
+    size_t range_bytes = (range_bits + 7) / 8;
+    BigInt sample;
+    sample_below(range, range_bytes, static_cast<uint8_t>(0xff >> (range_bytes * 8 - range_bits)), sample);
+    return min + sample;
+}
+
+std::vector<BigInt> SecureRandom::uniform_batch(const BigInt& min, const BigInt& max, size_t count) {
+    std::vector<BigInt> values;
+    values.reserve(count);
+    if (max <= min) {
+        values.assign(count, min);
+        return values;
+    }
+    BigInt range = max - min;
+    size_t range_bits = range.bit_length();
+    size_t range_bytes = (range_bits + 7) / 8;
+    uint8_t top_mask = static_cast<uint8_t>(0xff >> (range_bytes * 8 - range_bits));
+    BigInt sample;
+    for (size_t i = 0; i < count; i++) {
+        sample_below(range, range_bytes, top_mask, sample);
+        values.push_back(min + sample);
+    }
+    return values;
+}
+
+BigInt SecureRandom::random_bits(size_t bits) {
+    BigInt result;
+    if (bits == 0) {
+        return result;
+    }
+    size_t bytes = (bits + 7) / 8;
+    std::vector<uint8_t> data(bytes);
+    fill(data.data(), bytes);
+    data[0] &= static_cast<uint8_t>(0xff >> (bytes * 8 - bits));
+    BN_bin2bn(data.data(), static_cast<int>(bytes), result.get_bn());
+    OPENSSL_cleanse(data.data(), bytes);
+    return result;
+}
@@ -0,0 +1,211 @@
+#include "sharded_accumulator.h"
+#include "parallel.h"
+#include <openssl/bn.h>
+#include <openssl/sha.h>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+    uint64_t ring_hash(const uint8_t* data, size_t length) {
+        uint8_t hash[SHA256_DIGEST_LENGTH];
+        SHA256(data, length, hash);
+        uint64_t word = 0;
+        for (int i = 0; i < 8; i++) {
+            word = (word << 8) | hash[i];
+        }
+        return word;
+    }
+
+    // 元素在哈希环上的位置，只依赖元素的字节编码，跨进程稳定
+    uint64_t element_point(const BigInt& element) {
+        uint8_t stack_buffer[64];
+        size_t length = BN_num_bytes(element.get_const_bn());
+        if (length <= sizeof(stack_buffer)) {
+            BN_bn2bin(element.get_const_bn(), stack_buffer);
+            return ring_hash(stack_buffer, length);
+        }
+        std::vector<uint8_t> heap_buffer(length);
+        BN_bn2bin(element.get_const_bn(), heap_buffer.data());
+        return ring_hash(heap_buffer.data(), length);
+    }
+
+    uint64_t virtual_point(uint32_t shard_id, size_t replica) {
+        std::string label = "esa-shard:" + std::to_string(shard_id) + ":" + std::to_string(replica);
+        return ring_hash(reinterpret_cast<const uint8_t*>(label.data()), label.size());
+    }
+}
+
+// ShardedAccumulator 实现
+ShardedAccumulator::ShardedAccumulator(size_t shard_count, size_t virtual_nodes, bool verbose)
+    : virtual_nodes(std::max<size_t>(1, virtual_nodes)), worker_threads(0), verbose(verbose) {
+    // 第一个分片生成群参数，其余分片复用
+    shards.emplace_back(new ESAAccumulator(false));
+    group_order = shards[0]->get_group_order();
+    generator = shards[0]->get_generator();
+    add_ring_points(0);
+    init_shards(shard_count);
+}
+
+ShardedAccumulator::ShardedAccumulator(const BigInt& group_order, const GroupElement& generator,
+                                       size_t shard_count, size_t virtual_nodes, bool verbose)
+    : group_order(group_order), generator(generator), virtual_nodes(std::max<size_t>(1, virtual_nodes)),
+      worker_threads(0), verbose(verbose) {
+    init_shards(shard_count);
+}
+
+void ShardedAccumulator::init_shards(size_t shard_count) {
+    while (shards.size() < std::max<size_t>(1, shard_count)) {
+        uint32_t shard_id = static_cast<uint32_t>(shards.size());
+        shards.emplace_back(new ESAAccumulator(group_order, generator, false));
+        add_ring_points(shard_id);
+    }
+    if (verbose) {
+        std::cout << "分片累加器: " << shards.size() << " 个分片, 每个分片 " << virtual_nodes << " 个虚拟节点" << std::endl;
+    }
+}
+
+void ShardedAccumulator::add_ring_points(uint32_t shard_id) {
+    for (size_t replica = 0; replica < virtual_nodes; replica++) {
+        ring.emplace_back(virtual_point(shard_id, replica), shard_id);
+    }
+    std::sort(ring.begin(), ring.end());
+}
+
+size_t ShardedAccumulator::shard_for(const BigInt& element) const {
+    // 顺时针方向第一个虚拟节点，越过环尾则回到环首
+    auto it = std::upper_bound(ring.begin(), ring.end(), std::make_pair(element_point(element), UINT32_MAX));
+    if (it == ring.end()) {
+        it = ring.begin();
+    }
+    return it->second;
+}
+
+bool ShardedAccumulator::add_element(const BigInt& element) {
+    return shards[shard_for(element)]->add_element(element);
+}
+
+bool ShardedAccumulator::remove_element(const BigInt& element) {
+    return shards[shard_for(element)]->remove_element(element);
+}
+
+bool ShardedAccumulator::contains(const BigInt& element) const {
+    return shards[shard_for(element)]->contains(element);
+}
+
+size_t ShardedAccumulator::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard->size();
+    }
+    return total;
+}
+
+std::vector<std::vector<BigInt>> ShardedAccumulator::partition(const std::vector<BigInt>& elements) const {
+    std::vector<std::vector<BigInt>> parts(shards.size());
+    for (const auto& element : elements) {
+        parts[shard_for(element)].push_back(element);
+    }
+    return parts;
+}
+
+template<typename Op>
+size_t ShardedAccumulator::run_parallel(const std::vector<std::vector<BigInt>>& parts, Op op) {
+    // 每个分片只被一个工作线程处理，分片之间不共享状态
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (!parts[i].empty()) {
+            pending.push_back(i);
+        }
+    }
+    size_t threads = worker_threads ? worker_threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, pending.size());
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> changed{0};
+    auto worker = [&]() {
+        BigIntArena::Scope scope;
+        for (size_t i = next.fetch_add(1); i < pending.size(); i = next.fetch_add(1)) {
+            size_t shard_id = pending[i];
+            changed.fetch_add(op(*shards[shard_id], parts[shard_id]));
+        }
+    };
+
+    Parallel::run(threads, [&](size_t) { worker(); });
+    return changed.load();
+}
+
+size_t ShardedAccumulator::add_elements(const std::vector<BigInt>& elements) {
+    size_t added = run_parallel(partition(elements), [](ESAAccumulator& shard, const std::vector<BigInt>& part) {
+        return shard.add_elements(part);
+    });
+    if (verbose) {
+        std::cout << "分片批量添加 " << added << " 个元素" << std::endl;
+    }
+    return added;
+}
+
+size_t ShardedAccumulator::remove_elements(const std::vector<BigInt>& elements) {
+    size_t removed = run_parallel(partition(elements), [](ESAAccumulator& shard, const std::vector<BigInt>& part) {
+        return shard.remove_elements(part);
+    });
+    if (verbose) {
+        std::cout << "分片批量移除 " << removed << " 个元素" << std::endl;
+    }
+    return removed;
+}
+
+size_t ShardedAccumulator::add_shard() {
+    uint32_t shard_id = static_cast<uint32_t>(shards.size());
+    shards.emplace_back(new ESAAccumulator(group_order, generator, false));
+    add_ring_points(shard_id);
+
+    // 只有落在新虚拟节点区间内的元素需要迁移
+    std::vector<BigInt> moved;
+    for (uint32_t i = 0; i < shard_id; i++) {
+        std::vector<BigInt> leaving;
+        for (const auto& element : shards[i]->get_current_set()) {
+            if (shard_for(element) == shard_id) {
+                leaving.push_back(element);
+            }
+        }
+        shards[i]->remove_elements(leaving);
+        moved.insert(moved.end(), leaving.begin(), leaving.end());
+    }
+    shards[shard_id]->add_elements(moved);
+
+    if (verbose) {
+        std::cout << "新增分片 " << shard_id << ", 迁移 " << moved.size() << " 个元素" << std::endl;
+    }
+    return moved.size();
+}
+
+ShardedAccumulator::Commitment ShardedAccumulator::aggregate(const std::vector<GroupElement>& shard_values) {
+    Commitment commitment;
+    if (shard_values.empty()) {
+        return commitment;
+    }
+
+    Transcript transcript("esa-sharded-accumulator");
+    transcript.append_u64("shards", shard_values.size());
+    GroupElement product = GroupElement::identity(shard_values[0].get_modulus());
+    for (size_t i = 0; i < shard_values.size(); i++) {
+        transcript.append_u64("shard", i);
+        transcript.append_group_element("value", shard_values[i]);
+        product = product * shard_values[i];
+    }
+    transcript.challenge_bytes("digest", commitment.digest.data());
+    commitment.product = product;
+    return commitment;
+}
+
+ShardedAccumulator::Commitment ShardedAccumulator::commitment() const {
+    std::vector<GroupElement> values;
+    values.reserve(shards.size());
+    for (const auto& shard : shards) {
+        values.push_back(shard->get_accumulator_value());
+    }
+    return aggregate(values);
+}
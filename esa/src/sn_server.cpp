@@ -0,0 +1,889 @@
+#include "sn_server.h"
+#include <openssl/bn.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+using SNProtocol::Method;
+using SNProtocol::Status;
+
+// 消息体编解码
+namespace {
+    const uint64_t kListenToken = 0;
+    const uint64_t kWakeToken = 1;
+
+    // 每个连接最多同时交给工作线程的请求数，以及暂停读取的输出积压上限
+    const size_t kMaxInFlight = 64;
+    const size_t kOutputHighWater = 4 * 1024 * 1024;
+    // 一次读事件最多缓冲一个最大帧，其余留在套接字中由TCP流控限速
+    const size_t kInputHighWater = SNProtocol::kLengthSize + SNProtocol::kMaxFrameSize;
+
+    class Writer {
+    public:
+        std::vector<uint8_t> data;
+
+        void put_u8(uint8_t value) { data.push_back(value); }
+
+        void put_u32(uint32_t value) {
+            for (int shift = 24; shift >= 0; shift -= 8) {
+                data.push_back(static_cast<uint8_t>((value >> shift) & 0xff));
+            }
+        }
+
+        void put_u64(uint64_t value) {
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                data.push_back(static_cast<uint8_t>((value >> shift) & 0xff));
+            }
+        }
+
+        void put_bytes(const uint8_t* bytes, size_t length) {
+            put_u32(static_cast<uint32_t>(length));
+            data.insert(data.end(), bytes, bytes + length);
+        }
+
+        void put_string(const std::string& value) {
+            put_bytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+        }
+
+        void put_bigint(const BigInt& value) {
+            size_t length = BN_num_bytes(value.get_const_bn());
+            put_u32(static_cast<uint32_t>(length));
+            size_t offset = data.size();
+            data.resize(offset + length);
+            BN_bn2bin(value.get_const_bn(), data.data() + offset);
+        }
+
+        // 无效的群元素编码为有效标志0
+        void put_element(const GroupElement& element) {
+            put_u8(element.valid() ? 1 : 0);
+            if (element.valid()) {
+                put_bigint(element.get_value());
+            }
+        }
+    };
+
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t length) : data(data), length(length), pos(0), ok(true) {}
+
+        bool good() const { return ok; }
+        bool at_end() const { return ok && pos == length; }
+
+        uint8_t get_u8() {
+            if (!require(1)) {
+                return 0;
+            }
+            return data[pos++];
+        }
+
+        uint32_t get_u32() {
+            if (!require(4)) {
+                return 0;
+            }
+            uint32_t value = (static_cast<uint32_t>(data[pos]) << 24) | (static_cast<uint32_t>(data[pos + 1]) << 16) |
+                             (static_cast<uint32_t>(data[pos + 2]) << 8) | data[pos + 3];
+            pos += 4;
+            return value;
+        }
+
+        std::string get_string() {
+            uint32_t size = get_u32();
+            if (!require(size)) {
+                return std::string();
+            }
+            std::string value(reinterpret_cast<const char*>(data + pos), size);
+            pos += size;
+            return value;
+        }
+
+        BigInt get_bigint() {
+            BigInt value;
+            uint32_t size = get_u32();
+            if (require(size)) {
+                BN_bin2bn(data + pos, static_cast<int>(size), value.get_bn());
+                pos += size;
+            }
+            return value;
+        }
+
+        GroupElement get_element(const BigInt& modulus) {
+            if (get_u8() == 0) {
+                return GroupElement();
+            }
+            BigInt value = get_bigint();
+            return ok ? GroupElement(value, modulus) : GroupElement();
+        }
+
+    private:
+        const uint8_t* data;
+        size_t length;
+        size_t pos;
+        bool ok;
+
+        bool require(size_t size) {
+            if (!ok || length - pos < size) {
+                ok = false;
+            }
+            return ok;
+        }
+    };
+
+    std::vector<uint8_t> make_frame(uint64_t request_id, uint8_t method, const std::vector<uint8_t>& body) {
+        Writer frame;
+        frame.put_u32(static_cast<uint32_t>(SNProtocol::kHeaderSize + body.size()));
+        frame.put_u64(request_id);
+        frame.put_u8(method);
+        frame.data.insert(frame.data.end(), body.begin(), body.end());
+        return std::move(frame.data);
+    }
+
+    // 摘要定长，不带长度前缀
+    void put_digest(Writer& writer, const AccTrie::Digest& digest) {
+        writer.data.insert(writer.data.end(), digest.begin(), digest.end());
+    }
+
+    AccTrie::Digest get_digest(Reader& reader) {
+        AccTrie::Digest digest;
+        for (auto& byte : digest) {
+            byte = reader.get_u8();
+        }
+        return digest;
+    }
+
+    // 通用累加器值都在 RSAGroup::rsa2048() 中
+    void encode_path(Writer& writer, const AccTrie::PathProof& proof) {
+        writer.put_u8(proof.valid ? 1 : 0);
+        if (!proof.valid) {
+            return;
+        }
+        writer.put_string(proof.key);
+        writer.put_element(proof.ln_acc);
+        writer.put_element(proof.ln_universal);
+        writer.put_u32(static_cast<uint32_t>(proof.steps.size()));
+        for (const auto& step : proof.steps) {
+            writer.put_string(step.prefix);
+            writer.put_u8(step.has_terminal ? 1 : 0);
+            put_digest(writer, step.terminal);
+            writer.put_u32(static_cast<uint32_t>(step.children.size()));
+            for (const auto& child : step.children) {
+                writer.put_u8(child.first);
+                put_digest(writer, child.second);
+            }
+            writer.put_u32(static_cast<uint32_t>(step.position));
+        }
+        writer.put_element(proof.end_acc);
+        writer.put_element(proof.end_universal);
+    }
+
+    AccTrie::PathProof decode_path(Reader& reader, const BigInt& modulus) {
+        AccTrie::PathProof proof;
+        if (reader.get_u8() != 1) {
+            return proof;
+        }
+        const BigInt& universal_modulus = RSAGroup::rsa2048().get_modulus();
+        proof.key = reader.get_string();
+        proof.ln_acc = reader.get_element(modulus);
+        proof.ln_universal = reader.get_element(universal_modulus);
+        uint32_t count = reader.get_u32();
+        for (uint32_t i = 0; i < count && reader.good(); i++) {
+            AccTrie::PathStep step;
+            step.prefix = reader.get_string();
+            step.has_terminal = reader.get_u8() == 1;
+            step.terminal = get_digest(reader);
+            uint32_t children = reader.get_u32();
+            for (uint32_t j = 0; j < children && reader.good(); j++) {
+                uint8_t byte = reader.get_u8();
+                step.children.emplace_back(byte, get_digest(reader));
+            }
+            step.position = static_cast<int32_t>(reader.get_u32());
+            proof.steps.push_back(std::move(step));
+        }
+        proof.end_acc = reader.get_element(modulus);
+        proof.end_universal = reader.get_element(universal_modulus);
+        proof.valid = reader.good();
+        return proof;
+    }
+
+    void encode_update(Writer& writer, const AccTrie::UpdateResult& result) {
+        writer.put_u8(result.success ? 1 : 0);
+        writer.put_string(result.keyp);
+        writer.put_string(result.key);
+        writer.put_string(result.keyn);
+        writer.put_element(result.ln_acc);
+        writer.put_element(result.old_lnn_acc);
+        writer.put_element(result.new_lnn_acc);
+        put_digest(writer, result.root);
+    }
+
+    AccTrie::UpdateResult decode_update(Reader& reader, const BigInt& modulus) {
+        AccTrie::UpdateResult result;
+        result.success = reader.get_u8() == 1;
+        result.keyp = reader.get_string();
+        result.key = reader.get_string();
+        result.keyn = reader.get_string();
+        result.ln_acc = reader.get_element(modulus);
+        result.old_lnn_acc = reader.get_element(modulus);
+        result.new_lnn_acc = reader.get_element(modulus);
+        result.root = get_digest(reader);
+        return result;
+    }
+
+    void encode_query(Writer& writer, const AccTrie::QueryResult& result) {
+        writer.put_u8(result.exists ? 1 : 0);
+        writer.put_string(result.keyword);
+        writer.put_u32(static_cast<uint32_t>(result.values.size()));
+        for (const auto& value : result.values) {
+            writer.put_string(value);
+        }
+        writer.put_element(result.ln_acc);
+        writer.put_string(result.keyp);
+        writer.put_string(result.keyn);
+        writer.put_element(result.lnn_acc);
+        writer.put_element(result.link_witness);
+        encode_path(writer, result.keyp_path);
+        encode_path(writer, result.keyn_path);
+    }
+
+    AccTrie::QueryResult decode_query(Reader& reader, const BigInt& modulus) {
+        AccTrie::QueryResult result;
+        result.exists = reader.get_u8() == 1;
+        result.keyword = reader.get_string();
+        uint32_t count = reader.get_u32();
+        for (uint32_t i = 0; i < count && reader.good(); i++) {
+            result.values.push_back(reader.get_string());
+        }
+        result.ln_acc = reader.get_element(modulus);
+        result.keyp = reader.get_string();
+        result.keyn = reader.get_string();
+        result.lnn_acc = reader.get_element(modulus);
+        result.link_witness = reader.get_element(RSAGroup::rsa2048().get_modulus());
+        result.keyp_path = decode_path(reader, modulus);
+        result.keyn_path = decode_path(reader, modulus);
+        return result;
+    }
+}
+
+// SNServer 实现
+SNServer::SNServer(size_t worker_count)
+    : worker_count(std::max<size_t>(1, worker_count)), verbose(false), listen_fd(-1), epoll_fd(-1), wake_fd(-1),
+      bound_port(0), loop_running(false), next_connection_id(2), workers_stopping(false),
+      connection_count(0), request_count(0), bad_frame_count(0) {}
+
+SNServer::SNServer(const BigInt& group_order, const GroupElement& generator, size_t worker_count)
+    : trie(group_order, generator), worker_count(std::max<size_t>(1, worker_count)), verbose(false),
+      listen_fd(-1), epoll_fd(-1), wake_fd(-1), bound_port(0), loop_running(false), next_connection_id(2),
+      workers_stopping(false), connection_count(0), request_count(0), bad_frame_count(0) {}
+
+SNServer::~SNServer() {
+    stop();
+}
+
+bool SNServer::start(const std::string& host, uint16_t port) {
+    if (loop_running.load()) {
+        return false;
+    }
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        if (verbose) {
+            std::cout << "无效的监听地址: " << host << std::endl;
+        }
+        return false;
+    }
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    socklen_t addr_len = sizeof(addr);
+    if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0 ||
+        getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+        if (verbose) {
+            std::cout << "监听失败: " << std::strerror(errno) << std::endl;
+        }
+        if (listen_fd >= 0) {
+            ::close(listen_fd);
+            listen_fd = -1;
+        }
+        return false;
+    }
+    bound_port = ntohs(addr.sin_port);
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    bool registered = epoll_fd >= 0 && wake_fd >= 0;
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = kListenToken;
+    registered = registered && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) == 0;
+    event.data.u64 = kWakeToken;
+    registered = registered && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) == 0;
+    if (!registered) {
+        if (verbose) {
+            std::cout << "事件循环初始化失败: " << std::strerror(errno) << std::endl;
+        }
+        for (int* fd : {&listen_fd, &wake_fd, &epoll_fd}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+        return false;
+    }
+
+    workers_stopping = false;
+    for (size_t i = 0; i < worker_count; i++) {
+        workers.emplace_back(&SNServer::worker_main, this);
+    }
+    loop_running = true;
+    loop_thread = std::thread(&SNServer::event_loop, this);
+
+    if (verbose) {
+        std::cout << "存储节点开始监听 " << host << ":" << bound_port << ", 工作线程 " << worker_count << std::endl;
+    }
+    return true;
+}
+
+void SNServer::stop() {
+    if (!loop_running.exchange(false)) {
+        return;
+    }
+
+    uint64_t one = 1;
+    ssize_t ignored = write(wake_fd, &one, sizeof(one));
+    (void)ignored;
+    loop_thread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(task_mutex);
+        workers_stopping = true;
+        tasks.clear();
+    }
+    task_ready.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    completions.clear();
+
+    for (auto& entry : connections) {
+        ::close(entry.second.fd);
+    }
+    connections.clear();
+    ::close(listen_fd);
+    ::close(wake_fd);
+    ::close(epoll_fd);
+    listen_fd = epoll_fd = wake_fd = -1;
+}
+
+SNServer::Stats SNServer::stats() const {
+    Stats stats;
+    stats.connections = connection_count.load();
+    stats.requests = request_count.load();
+    stats.bad_frames = bad_frame_count.load();
+    return stats;
+}
+
+void SNServer::event_loop() {
+    epoll_event events[64];
+    while (loop_running.load()) {
+        int ready = epoll_wait(epoll_fd, events, 64, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            uint64_t token = events[i].data.u64;
+            if (token == kListenToken) {
+                accept_connections();
+            } else if (token == kWakeToken) {
+                uint64_t value;
+                ssize_t ignored = read(wake_fd, &value, sizeof(value));
+                (void)ignored;
+                drain_completions();
+            } else if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                // 暂停读取时水平触发的挂断事件仍会上报，直接关闭，避免空转
+                close_connection(token);
+            } else {
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                    handle_readable(token);
+                }
+                if (events[i].events & EPOLLOUT) {
+                    handle_writable(token);
+                }
+            }
+        }
+    }
+}
+
+void SNServer::accept_connections() {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        uint64_t id = next_connection_id++;
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = id;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        Connection connection;
+        connection.fd = fd;
+        connection.events = event.events;
+        connections.emplace(id, std::move(connection));
+        connection_count++;
+    }
+}
+
+void SNServer::handle_readable(uint64_t connection_id) {
+    auto it = connections.find(connection_id);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection& connection = it->second;
+
+    bool closed = false;
+    uint8_t buffer[16384];
+    while (connection.input.size() - connection.input_offset < kInputHighWater) {
+        ssize_t n = read(connection.fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            connection.input.insert(connection.input.end(), buffer, buffer + n);
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            closed = true;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        break;
+    }
+
+    if (!dispatch_frames(connection_id, connection) || closed) {
+        close_connection(connection_id);
+        return;
+    }
+    update_interest(connection_id, connection);
+}
+
+bool SNServer::dispatch_frames(uint64_t connection_id, Connection& connection) {
+    // 切分出完整的帧交给工作线程，在途请求达到上限或输出积压时剩余的帧留在缓冲区
+    bool ok = true;
+    std::vector<Task> parsed;
+    while (connection.input.size() - connection.input_offset >= SNProtocol::kLengthSize &&
+           connection.in_flight + parsed.size() < kMaxInFlight &&
+           connection.output.size() - connection.output_offset < kOutputHighWater) {
+        const uint8_t* frame = connection.input.data() + connection.input_offset;
+        size_t length = (static_cast<size_t>(frame[0]) << 24) | (static_cast<size_t>(frame[1]) << 16) |
+                        (static_cast<size_t>(frame[2]) << 8) | frame[3];
+        if (length < SNProtocol::kHeaderSize || length > SNProtocol::kMaxFrameSize) {
+            bad_frame_count++;
+            ok = false;
+            break;
+        }
+        if (connection.input.size() - connection.input_offset < SNProtocol::kLengthSize + length) {
+            break;
+        }
+        Task task;
+        task.connection_id = connection_id;
+        task.request_id = 0;
+        for (size_t i = 0; i < 8; i++) {
+            task.request_id = (task.request_id << 8) | frame[SNProtocol::kLengthSize + i];
+        }
+        task.method = frame[SNProtocol::kLengthSize + 8];
+        task.body.assign(frame + SNProtocol::kLengthSize + SNProtocol::kHeaderSize,
+                         frame + SNProtocol::kLengthSize + length);
+        parsed.push_back(std::move(task));
+        connection.input_offset += SNProtocol::kLengthSize + length;
+    }
+    if (connection.input_offset == connection.input.size()) {
+        connection.input.clear();
+        connection.input_offset = 0;
+    } else if (connection.input_offset > 65536) {
+        connection.input.erase(connection.input.begin(), connection.input.begin() + connection.input_offset);
+        connection.input_offset = 0;
+    }
+
+    if (!parsed.empty()) {
+        connection.in_flight += parsed.size();
+        request_count += parsed.size();
+        {
+            std::lock_guard<std::mutex> lock(task_mutex);
+            for (auto& task : parsed) {
+                tasks.push_back(std::move(task));
+            }
+        }
+        task_ready.notify_all();
+    }
+    return ok;
+}
+
+void SNServer::handle_writable(uint64_t connection_id) {
+    auto it = connections.find(connection_id);
+    if (it == connections.end()) {
+        return;
+    }
+    // 输出积压回落后继续派发暂缓的帧
+    if (!flush_output(it->second) || !dispatch_frames(connection_id, it->second)) {
+        close_connection(connection_id);
+        return;
+    }
+    update_interest(connection_id, it->second);
+}
+
+bool SNServer::flush_output(Connection& connection) {
+    while (connection.output_offset < connection.output.size()) {
+        ssize_t n = write(connection.fd, connection.output.data() + connection.output_offset,
+                          connection.output.size() - connection.output_offset);
+        if (n > 0) {
+            connection.output_offset += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    connection.output.clear();
+    connection.output_offset = 0;
+    return true;
+}
+
+void SNServer::update_interest(uint64_t connection_id, Connection& connection) {
+    // 只有输出缓冲区有剩余数据时才关注可写事件；
+    // 在途请求达到上限或输出积压超过高水位时停止读取，由TCP流控让客户端减速，回落后恢复
+    size_t pending_output = connection.output.size() - connection.output_offset;
+    uint32_t events = 0;
+    if (connection.in_flight < kMaxInFlight && pending_output < kOutputHighWater) {
+        events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (pending_output > 0) {
+        events |= EPOLLOUT;
+    }
+    if (events == connection.events) {
+        return;
+    }
+    epoll_event event;
+    event.events = events;
+    event.data.u64 = connection_id;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event) == 0) {
+        connection.events = events;
+    }
+}
+
+void SNServer::drain_completions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex);
+        ready.swap(completions);
+    }
+
+    // 先把同一连接的响应都追加到缓冲区，再统一写出
+    std::vector<uint64_t> touched;
+    for (auto& completion : ready) {
+        auto it = connections.find(completion.connection_id);
+        if (it == connections.end()) {
+            continue;  // 连接已关闭，丢弃响应
+        }
+        it->second.in_flight--;
+        it->second.output.insert(it->second.output.end(), completion.frame.begin(), completion.frame.end());
+        touched.push_back(completion.connection_id);
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    // 在途请求减少后继续处理缓冲区中暂缓的帧
+    for (uint64_t id : touched) {
+        auto it = connections.find(id);
+        if (it == connections.end()) {
+            continue;
+        }
+        if (!flush_output(it->second) || !dispatch_frames(id, it->second)) {
+            close_connection(id);
+            continue;
+        }
+        update_interest(id, it->second);
+    }
+}
+
+void SNServer::close_connection(uint64_t connection_id) {
+    auto it = connections.find(connection_id);
+    if (it == connections.end()) {
+        return;
+    }
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    ::close(it->second.fd);
+    connections.erase(it);
+}
+
+void SNServer::worker_main() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(task_mutex);
+            task_ready.wait(lock, [this]() { return workers_stopping || !tasks.empty(); });
+            if (workers_stopping) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        Completion completion;
+        completion.connection_id = task.connection_id;
+        completion.frame = make_frame(task.request_id, task.method, handle_request(task));
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex);
+            completions.push_back(std::move(completion));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+std::vector<uint8_t> SNServer::handle_request(const Task& task) {
+    BigIntArena::Scope scope;
+    Reader reader(task.body.data(), task.body.size());
+    Writer writer;
+
+    switch (static_cast<Method>(task.method)) {
+        case Method::INSERT_KV:
+        case Method::DELETE_KV: {
+            std::string key = reader.get_string();
+            std::string value = reader.get_string();
+            if (!reader.at_end()) {
+                break;
+            }
+            AccTrie::UpdateResult result;
+            {
+                std::lock_guard<std::mutex> lock(trie_mutex);
+                result = static_cast<Method>(task.method) == Method::INSERT_KV ? trie.insert(key, value)
+                                                                               : trie.remove(key, value);
+            }
+            writer.put_u8(static_cast<uint8_t>(Status::OK));
+            encode_update(writer, result);
+            return std::move(writer.data);
+        }
+        case Method::SINGLE_KEYWORD_QUERY: {
+            std::string keyword = reader.get_string();
+            if (!reader.at_end()) {
+                break;
+            }
+            AccTrie::QueryResult result;
+            {
+                std::lock_guard<std::mutex> lock(trie_mutex);
+                result = trie.query(keyword);
+            }
+            writer.put_u8(static_cast<uint8_t>(Status::OK));
+            encode_query(writer, result);
+            return std::move(writer.data);
+        }
+        case Method::GET_PARAMS: {
+            if (!reader.at_end()) {
+                break;
+            }
+            writer.put_u8(static_cast<uint8_t>(Status::OK));
+            writer.put_bigint(trie.get_group_order());
+            writer.put_bigint(trie.get_generator().get_value());
+            return std::move(writer.data);
+        }
+    }
+
+    bad_frame_count++;
+    writer.put_u8(static_cast<uint8_t>(Status::BAD_REQUEST));
+    return std::move(writer.data);
+}
+
+// SNClient 实现
+SNClient::SNClient() : fd(-1), next_request_id(1) {}
+
+SNClient::~SNClient() {
+    close();
+}
+
+bool SNClient::connect(const std::string& host, uint16_t port) {
+    close();
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        return false;
+    }
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close();
+        return false;
+    }
+    int nodelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    // 群参数用于把响应中的累加器值还原为群元素
+    Response response;
+    if (send_request(Method::GET_PARAMS, std::vector<uint8_t>()) == 0 || !receive(response) ||
+        response.status != Status::OK || group_order.is_zero()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SNClient::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+uint64_t SNClient::send_request(Method method, const std::vector<uint8_t>& body) {
+    if (fd < 0) {
+        return 0;
+    }
+    uint64_t request_id = next_request_id++;
+    std::vector<uint8_t> frame = make_frame(request_id, static_cast<uint8_t>(method), body);
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = send(fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            close();
+            return 0;
+        }
+        sent += n;
+    }
+    return request_id;
+}
+
+bool SNClient::read_exact(uint8_t* data, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+        ssize_t n = recv(fd, data + received, length - received, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        received += n;
+    }
+    return true;
+}
+
+uint64_t SNClient::send_insert(const std::string& key, const std::string& value) {
+    Writer writer;
+    writer.put_string(key);
+    writer.put_string(value);
+    return send_request(Method::INSERT_KV, writer.data);
+}
+
+uint64_t SNClient::send_delete(const std::string& key, const std::string& value) {
+    Writer writer;
+    writer.put_string(key);
+    writer.put_string(value);
+    return send_request(Method::DELETE_KV, writer.data);
+}
+
+uint64_t SNClient::send_query(const std::string& keyword) {
+    Writer writer;
+    writer.put_string(keyword);
+    return send_request(Method::SINGLE_KEYWORD_QUERY, writer.data);
+}
+
+bool SNClient::receive(Response& response) {
+    if (fd < 0) {
+        return false;
+    }
+    uint8_t length_bytes[SNProtocol::kLengthSize];
+    if (!read_exact(length_bytes, sizeof(length_bytes))) {
+        close();
+        return false;
+    }
+    size_t length = (static_cast<size_t>(length_bytes[0]) << 24) | (static_cast<size_t>(length_bytes[1]) << 16) |
+                    (static_cast<size_t>(length_bytes[2]) << 8) | length_bytes[3];
+    if (length < SNProtocol::kHeaderSize + 1 || length > SNProtocol::kMaxFrameSize) {
+        close();
+        return false;
+    }
+    std::vector<uint8_t> frame(length);
+    if (!read_exact(frame.data(), length)) {
+        close();
+        return false;
+    }
+
+    response = Response();
+    for (size_t i = 0; i < 8; i++) {
+        response.request_id = (response.request_id << 8) | frame[i];
+    }
+    response.method = static_cast<Method>(frame[8]);
+    Reader reader(frame.data() + SNProtocol::kHeaderSize, length - SNProtocol::kHeaderSize);
+    response.status = static_cast<Status>(reader.get_u8());
+    if (response.status != Status::OK) {
+        return true;
+    }
+
+    switch (response.method) {
+        case Method::INSERT_KV:
+        case Method::DELETE_KV:
+            response.update = decode_update(reader, group_order);
+            break;
+        case Method::SINGLE_KEYWORD_QUERY:
+            response.query = decode_query(reader, group_order);
+            break;
+        case Method::GET_PARAMS: {
+            group_order = reader.get_bigint();
+            BigInt g = reader.get_bigint();
+            if (!reader.good() || group_order.is_zero()) {
+                return false;
+            }
+            generator = GroupElement(g, group_order);
+            break;
+        }
+    }
+    return reader.at_end();
+}
+
+AccTrie::UpdateResult SNClient::insert(const std::string& key, const std::string& value) {
+    Response response;
+    if (send_insert(key, value) == 0 || !receive(response)) {
+        return AccTrie::UpdateResult();
+    }
+    return response.update;
+}
+
+AccTrie::UpdateResult SNClient::remove(const std::string& key, const std::string& value) {
+    Response response;
+    if (send_delete(key, value) == 0 || !receive(response)) {
+        return AccTrie::UpdateResult();
+    }
+    return response.update;
+}
+
+AccTrie::QueryResult SNClient::query(const std::string& keyword) {
+    Response response;
+    if (send_query(keyword) == 0 || !receive(response)) {
+        return AccTrie::QueryResult();
+    }
+    return response.query;
+}
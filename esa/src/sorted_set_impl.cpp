@@ -0,0 +1,155 @@
+#include "esa_accumulator.h"
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// SortedElementSet 实现
+SortedElementSet::SortedElementSet(std::vector<uint64_t> unsorted_ids) : ids(std::move(unsorted_ids)) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+bool SortedElementSet::from_set(const std::unordered_set<BigInt, BigInt::Hash>& set, SortedElementSet& out) {
+    std::vector<uint64_t> column;
+    column.reserve(set.size());
+    bool complete = true;
+    for (const auto& elem : set) {
+        if (elem.fits_u64()) {
+            column.push_back(elem.to_u64());
+        } else {
+            complete = false;
+        }
+    }
+    std::sort(column.begin(), column.end());
+    out.ids = std::move(column);
+    return complete;
+}
+
+void SortedElementSet::to_set(std::unordered_set<BigInt, BigInt::Hash>& out) const {
+    out.reserve(out.size() + ids.size());
+    for (uint64_t id : ids) {
+        out.insert(BigInt::from_u64(id));
+    }
+}
+
+bool SortedElementSet::insert(uint64_t id) {
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it != ids.end() && *it == id) {
+        return false;
+    }
+    ids.insert(it, id);
+    return true;
+}
+
+bool SortedElementSet::erase(uint64_t id) {
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id) {
+        return false;
+    }
+    ids.erase(it);
+    return true;
+}
+
+bool SortedElementSet::contains(uint64_t id) const {
+    return std::binary_search(ids.begin(), ids.end(), id);
+}
+
+// SIMD块内比较：统计有序块中小于target的元素个数
+namespace {
+#if defined(__AVX2__)
+    constexpr size_t kBlock = 8;
+
+    size_t block_count_less(const uint64_t* data, size_t n, uint64_t target) {
+        // AVX2只有有符号64位比较，两边同时翻转符号位即可按无符号比较
+        const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+        const __m256i t = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(target)), bias);
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), bias);
+            int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(t, v)));
+            count += __builtin_popcount(static_cast<unsigned>(mask));
+        }
+        for (; i < n; i++) {
+            count += data[i] < target ? 1 : 0;
+        }
+        return count;
+    }
+#else
+    constexpr size_t kBlock = 8;
+
+    size_t block_count_less(const uint64_t* data, size_t n, uint64_t target) {
+        // 无分支计数，编译器可自动向量化
+        size_t count = 0;
+        for (size_t i = 0; i < n; i++) {
+            count += data[i] < target ? 1 : 0;
+        }
+        return count;
+    }
+#endif
+}
+
+namespace SortedSetOps {
+    size_t gallop_lower_bound(const uint64_t* data, size_t n, size_t pos, uint64_t target) {
+        if (pos >= n || data[pos] >= target) {
+            return pos;
+        }
+        
+        // 指数搜索：data[pos + bound/2] < target <= data[pos + bound]
+        size_t bound = 1;
+        while (pos + bound < n && data[pos + bound] < target) {
+            bound <<= 1;
+        }
+        size_t lo = pos + bound / 2 + 1;
+        size_t hi = std::min(pos + bound, n);
+        
+        // 二分缩小到一个块，再用块内比较定位
+        while (hi - lo > kBlock) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (data[mid] < target) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo + block_count_less(data + lo, hi - lo, target);
+    }
+    
+    size_t intersect_k(std::vector<const SortedElementSet*> operands, std::vector<uint64_t>& out) {
+        if (operands.empty()) {
+            return 0;
+        }
+        std::sort(operands.begin(), operands.end(),
+                  [](const SortedElementSet* a, const SortedElementSet* b) { return a->size() < b->size(); });
+        
+        const SortedElementSet& smallest = *operands.front();
+        if (operands.size() == 1) {
+            out.insert(out.end(), smallest.begin(), smallest.end());
+            return smallest.size();
+        }
+        
+        std::vector<size_t> cursors(operands.size(), 0);
+        size_t count = 0;
+        for (uint64_t candidate : smallest) {
+            bool present = true;
+            for (size_t j = 1; j < operands.size(); j++) {
+                const SortedElementSet& other = *operands[j];
+                cursors[j] = gallop_lower_bound(other.data(), other.size(), cursors[j], candidate);
+                if (cursors[j] == other.size()) {
+                    // 某个集合已扫描完，后面不会再有交集
+                    return count;
+                }
+                if (other.data()[cursors[j]] != candidate) {
+                    present = false;
+                    break;
+                }
+            }
+            if (present) {
+                out.push_back(candidate);
+                count++;
+            }
+        }
+        return count;
+    }
+}
@@ -0,0 +1,117 @@
+#include "esa_accumulator.h"
+#include <openssl/bn.h>
+#include <cstring>
+
+namespace {
+    // OpenSSL 3 中 EVP_sha256() 每次初始化都会隐式查找算法实现，这里只查找一次
+    const EVP_MD* transcript_md(Transcript::Hash hash) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        static EVP_MD* sha256 = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+        static EVP_MD* sha3_256 = EVP_MD_fetch(nullptr, "SHA3-256", nullptr);
+        return hash == Transcript::Hash::SHA3_256 ? sha3_256 : sha256;
+#else
+        return hash == Transcript::Hash::SHA3_256 ? EVP_sha3_256() : EVP_sha256();
+#endif
+    }
+
+    // 挤出挑战时使用的临时上下文，每个线程复用一个
+    EVP_MD_CTX* scratch_ctx() {
+        struct Holder {
+            EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+            ~Holder() { EVP_MD_CTX_free(ctx); }
+        };
+        thread_local Holder holder;
+        return holder.ctx;
+    }
+
+    void put_u64(uint8_t out[8], uint64_t value) {
+        for (int i = 7; i >= 0; i--) {
+            out[i] = static_cast<uint8_t>(value & 0xff);
+            value >>= 8;
+        }
+    }
+
+    void absorb_label(EVP_MD_CTX* ctx, const char* label) {
+        size_t length = std::strlen(label);
+        uint8_t prefix[8];
+        put_u64(prefix, length);
+        EVP_DigestUpdate(ctx, prefix, sizeof(prefix));
+        EVP_DigestUpdate(ctx, label, length);
+    }
+}
+
+// Transcript 实现
+Transcript::Transcript(const char* domain, Hash hash) {
+    ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, transcript_md(hash), nullptr);
+    append_message("domain", reinterpret_cast<const uint8_t*>(domain), std::strlen(domain));
+}
+
+Transcript::Transcript(const Transcript& other) {
+    ctx = EVP_MD_CTX_new();
+    EVP_MD_CTX_copy_ex(ctx, other.ctx);
+}
+
+Transcript& Transcript::operator=(const Transcript& other) {
+    if (this != &other) {
+        EVP_MD_CTX_copy_ex(ctx, other.ctx);
+    }
+    return *this;
+}
+
+Transcript::~Transcript() {
+    EVP_MD_CTX_free(ctx);
+}
+
+void Transcript::append_message(const char* label, const uint8_t* data, size_t length) {
+    absorb_label(ctx, label);
+    uint8_t prefix[8];
+    put_u64(prefix, length);
+    EVP_DigestUpdate(ctx, prefix, sizeof(prefix));
+    EVP_DigestUpdate(ctx, data, length);
+}
+
+void Transcript::append_u64(const char* label, uint64_t value) {
+    uint8_t bytes[8];
+    put_u64(bytes, value);
+    append_message(label, bytes, sizeof(bytes));
+}
+
+void Transcript::append_bigint(const char* label, const BigInt& value) {
+    // 常见尺寸直接在栈上编码
+    uint8_t stack_buffer[128];
+    size_t length = BN_num_bytes(value.get_const_bn());
+    if (length <= sizeof(stack_buffer)) {
+        BN_bn2bin(value.get_const_bn(), stack_buffer);
+        append_message(label, stack_buffer, length);
+    } else {
+        std::vector<uint8_t> heap_buffer(length);
+        BN_bn2bin(value.get_const_bn(), heap_buffer.data());
+        append_message(label, heap_buffer.data(), length);
+    }
+}
+
+void Transcript::append_group_element(const char* label, const GroupElement& element) {
+    append_bigint(label, element.get_value());
+}
+
+void Transcript::challenge_bytes(const char* label, uint8_t out[32]) {
+    absorb_label(ctx, label);
+
+    EVP_MD_CTX* squeeze = scratch_ctx();
+    EVP_MD_CTX_copy_ex(squeeze, ctx);
+    EVP_DigestFinal_ex(squeeze, out, nullptr);
+
+    append_message("challenge", out, 32);
+}
+
+BigInt Transcript::challenge(const char* label, const BigInt& modulus) {
+    uint8_t digest[32];
+    challenge_bytes(label, digest);
+
+    BigInt result;
+    BN_bin2bn(digest, sizeof(digest), result.get_bn());
+    BigIntArena::CtxGuard bn_ctx;
+    BN_nnmod(result.get_bn(), result.get_const_bn(), modulus.get_const_bn(), bn_ctx);
+    return result;
+}
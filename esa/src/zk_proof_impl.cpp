@@ -1,7 +1,45 @@
 #include "esa_accumulator.h"
+#include <openssl/bn.h>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 
+namespace {
+    const uint8_t kBinaryProofVersion = 1;
+
+    void put_bigint(std::vector<uint8_t>& out, const BigInt& value) {
+        size_t length = value.get_const_bn() ? BN_num_bytes(value.get_const_bn()) : 0;
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>((length >> shift) & 0xff));
+        }
+        size_t offset = out.size();
+        out.resize(offset + length);
+        if (length > 0) {
+            BN_bn2bin(value.get_const_bn(), out.data() + offset);
+        }
+    }
+
+    bool get_u32(const uint8_t* data, size_t length, size_t& pos, uint32_t& value) {
+        if (length - pos < 4) {
+            return false;
+        }
+        value = (static_cast<uint32_t>(data[pos]) << 24) | (static_cast<uint32_t>(data[pos + 1]) << 16) |
+                (static_cast<uint32_t>(data[pos + 2]) << 8) | data[pos + 3];
+        pos += 4;
+        return true;
+    }
+
+    bool get_bigint(const uint8_t* data, size_t length, size_t& pos, BigInt& value) {
+        uint32_t size;
+        if (!get_u32(data, length, pos, size) || length - pos < size) {
+            return false;
+        }
+        BN_bin2bn(data + pos, static_cast<int>(size), value.get_bn());
+        pos += size;
+        return true;
+    }
+}
+
 // ZeroKnowledgeProof 序列化实现
 std::string ZeroKnowledgeProof::serialize() const {
     std::ostringstream oss;
@@ -94,3 +132,282 @@ ZeroKnowledgeProof ZeroKnowledgeProof::deserialize(const std::string& data) {
     
     return proof;
 }
+
+void ZeroKnowledgeProof::serialize_binary(std::vector<uint8_t>& out) const {
+    out.push_back(kBinaryProofVersion);
+    out.push_back(static_cast<uint8_t>(type));
+    out.push_back(is_valid ? 1 : 0);
+    
+    // 所有群元素共享承诺的模数
+    put_bigint(out, commitment.get_modulus());
+    put_bigint(out, commitment.get_value());
+    put_bigint(out, challenge);
+    put_bigint(out, response);
+    
+    uint32_t count = static_cast<uint32_t>(auxiliary_data.size());
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>((count >> shift) & 0xff));
+    }
+    for (const auto& aux : auxiliary_data) {
+        put_bigint(out, aux.get_value());
+    }
+}
+
+ZeroKnowledgeProof ZeroKnowledgeProof::deserialize_binary(const uint8_t* data, size_t length) {
+    ZeroKnowledgeProof proof(ProofType::MEMBERSHIP);
+    if (!data || length < 3 || data[0] != kBinaryProofVersion || data[1] > static_cast<uint8_t>(ProofType::COMPLEMENT)) {
+        return proof;
+    }
+    proof.type = static_cast<ProofType>(data[1]);
+    bool valid = data[2] == 1;
+    size_t pos = 3;
+    
+    BigInt modulus, commitment_value;
+    uint32_t count;
+    if (!get_bigint(data, length, pos, modulus) || !get_bigint(data, length, pos, commitment_value) ||
+        !get_bigint(data, length, pos, proof.challenge) || !get_bigint(data, length, pos, proof.response) ||
+        !get_u32(data, length, pos, count) || modulus.is_zero()) {
+        return proof;
+    }
+    proof.commitment = GroupElement(commitment_value, modulus);
+    for (uint32_t i = 0; i < count; i++) {
+        BigInt value;
+        if (!get_bigint(data, length, pos, value)) {
+            proof.auxiliary_data.clear();
+            return proof;
+        }
+        proof.auxiliary_data.push_back(GroupElement(value, modulus));
+    }
+    
+    // 必须恰好消耗全部输入
+    proof.is_valid = valid && pos == length;
+    return proof;
+}
+
+// MembershipProofBundle 实现
+namespace {
+    // 定长大端编码，value必须小于 2^(8·width)
+    void put_fixed(std::vector<uint8_t>& out, const BigInt& value, size_t width) {
+        size_t offset = out.size();
+        out.resize(offset + width);
+        BN_bn2binpad(value.get_const_bn(), out.data() + offset, static_cast<int>(width));
+    }
+}
+
+void MembershipProofBundle::serialize_binary(std::vector<uint8_t>& out) const {
+    out.push_back(kBinaryProofVersion);
+    out.push_back(is_valid ? 1 : 0);
+    const BigInt& modulus = accumulator.get_modulus();
+    put_bigint(out, modulus);
+    put_bigint(out, accumulator.get_value());
+    
+    uint32_t count = static_cast<uint32_t>(commitments.size());
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>((count >> shift) & 0xff));
+    }
+    // 承诺和响应都小于模数，按模数字节宽定长编码，不需要逐项长度
+    size_t width = BN_num_bytes(modulus.get_const_bn());
+    out.reserve(out.size() + 2 * width * commitments.size());
+    for (size_t i = 0; i < commitments.size(); i++) {
+        put_fixed(out, commitments[i].get_value(), width);
+        put_fixed(out, responses[i], width);
+    }
+}
+
+MembershipProofBundle MembershipProofBundle::deserialize_binary(const uint8_t* data, size_t length) {
+    MembershipProofBundle bundle;
+    if (!data || length < 2 || data[0] != kBinaryProofVersion) {
+        return bundle;
+    }
+    bool valid = data[1] == 1;
+    size_t pos = 2;
+    
+    BigInt modulus, accumulator_value;
+    uint32_t count;
+    if (!get_bigint(data, length, pos, modulus) || !get_bigint(data, length, pos, accumulator_value) ||
+        !get_u32(data, length, pos, count) || modulus.is_zero()) {
+        return bundle;
+    }
+    size_t width = BN_num_bytes(modulus.get_const_bn());
+    if ((length - pos) / (2 * width) != count || (length - pos) % (2 * width) != 0) {
+        return bundle;
+    }
+    bundle.accumulator = GroupElement(accumulator_value, modulus);
+    bundle.commitments.reserve(count);
+    bundle.responses.resize(count);
+    BigInt value;
+    for (uint32_t i = 0; i < count; i++) {
+        BN_bin2bn(data + pos, static_cast<int>(width), value.get_bn());
+        BN_bin2bn(data + pos + width, static_cast<int>(width), bundle.responses[i].get_bn());
+        // 只接受规范编码
+        if (value >= modulus || bundle.responses[i] >= modulus) {
+            bundle.commitments.clear();
+            bundle.responses.clear();
+            return bundle;
+        }
+        bundle.commitments.push_back(GroupElement(value, modulus));
+        pos += 2 * width;
+    }
+    bundle.is_valid = valid;
+    return bundle;
+}
+
+// ExponentiationProof 实现
+namespace {
+    const size_t kChallengePrimeBytes = 16;  // ℓ 为128位素数
+
+    // 从当前转录状态挤出32字节种子，按计数器模式 SHA-256(种子 || 计数器) 产生128位候选，
+    // 取第一个素数作为 ℓ。与元素到素数代表的映射相互独立
+    BigInt challenge_prime(Transcript& transcript) {
+        uint8_t seed[32];
+        transcript.challenge_bytes("prime", seed);
+        uint8_t input[sizeof(seed) + 4];
+        std::memcpy(input, seed, sizeof(seed));
+        for (uint32_t counter = 0;; counter++) {
+            for (int j = 0; j < 4; j++) {
+                input[sizeof(seed) + j] = static_cast<uint8_t>(counter >> (24 - 8 * j));
+            }
+            uint8_t hash[SHA256_DIGEST_LENGTH];
+            SHA256(input, sizeof(input), hash);
+            hash[0] |= 0x80;
+            hash[kChallengePrimeBytes - 1] |= 1;
+            BigInt candidate = BigInt::from_bytes(std::vector<uint8_t>(hash, hash + kChallengePrimeBytes));
+            if (CryptoUtils::is_prime(candidate)) {
+                return candidate;
+            }
+        }
+    }
+
+    Transcript poe_transcript(const RSAGroup& group, const GroupElement& base, const std::vector<BigInt>& factors,
+                              const GroupElement& result) {
+        Transcript transcript("esa-poe");
+        transcript.append_bigint("modulus", group.get_modulus());
+        transcript.append_group_element("base", base);
+        transcript.append_group_element("result", result);
+        transcript.append_u64("factors", factors.size());
+        for (const auto& factor : factors) {
+            transcript.append_bigint("factor", factor);
+        }
+        return transcript;
+    }
+}
+
+ExponentiationProof ExponentiationProof::prove(const RSAGroup& group, const GroupElement& base,
+                                               const std::vector<BigInt>& factors, const GroupElement& result) {
+    ExponentiationProof proof;
+    if (!group.valid() || !group.contains(base) || !group.contains(result)) {
+        return proof;
+    }
+    BigIntArena::Scope scope;
+    Transcript transcript = poe_transcript(group, base, factors, result);
+    BigInt prime = challenge_prime(transcript);
+    
+    proof.quotient = group.canonical(base ^ (CryptoUtils::balanced_product(factors) / prime));
+    proof.is_valid = true;
+    return proof;
+}
+
+bool ExponentiationProof::verify(const RSAGroup& group, const GroupElement& base, const std::vector<BigInt>& factors,
+                                 const GroupElement& result, const ExponentiationProof& proof) {
+    if (proof.kind != Kind::POE || !proof.is_valid || !group.valid() || !group.contains(base) ||
+        !group.contains(result) || !group.contains(proof.quotient)) {
+        return false;
+    }
+    BigIntArena::Scope scope;
+    Transcript transcript = poe_transcript(group, base, factors, result);
+    BigInt prime = challenge_prime(transcript);
+    
+    // x mod ℓ 由各因子逐个约简，不需要计算x本身
+    BigInt remainder = BigInt("1") % prime;
+    for (const auto& factor : factors) {
+        remainder = (remainder * (factor % prime)) % prime;
+    }
+    return group.canonical(CryptoUtils::multi_exp({proof.quotient, base}, {prime, remainder})) == result;
+}
+
+ExponentiationProof ExponentiationProof::prove_knowledge(const RSAGroup& group, const GroupElement& base,
+                                                         const BigInt& exponent, const GroupElement& result) {
+    ExponentiationProof proof;
+    proof.kind = Kind::POKE;
+    if (!group.valid() || !group.contains(base) || !group.contains(result)) {
+        return proof;
+    }
+    BigIntArena::Scope scope;
+    const GroupElement& generator = group.get_base();
+    proof.exponent_commitment = group.canonical(generator.pow_secret(exponent));
+    
+    Transcript transcript("esa-poke");
+    transcript.append_bigint("modulus", group.get_modulus());
+    transcript.append_group_element("generator", generator);
+    transcript.append_group_element("base", base);
+    transcript.append_group_element("result", result);
+    transcript.append_group_element("z", proof.exponent_commitment);
+    BigInt prime = challenge_prime(transcript);
+    BigInt alpha = transcript.challenge("alpha", base.get_modulus());
+    
+    GroupElement blinded_base = base * (generator ^ alpha);
+    proof.quotient = group.canonical(blinded_base.pow_secret(exponent / prime));
+    proof.remainder = exponent % prime;
+    proof.is_valid = true;
+    return proof;
+}
+
+bool ExponentiationProof::verify_knowledge(const RSAGroup& group, const GroupElement& base,
+                                           const GroupElement& result, const ExponentiationProof& proof) {
+    if (proof.kind != Kind::POKE || !proof.is_valid || !group.valid() || !group.contains(base) ||
+        !group.contains(result) || !group.contains(proof.quotient) || !group.contains(proof.exponent_commitment)) {
+        return false;
+    }
+    BigIntArena::Scope scope;
+    const GroupElement& generator = group.get_base();
+    Transcript transcript("esa-poke");
+    transcript.append_bigint("modulus", group.get_modulus());
+    transcript.append_group_element("generator", generator);
+    transcript.append_group_element("base", base);
+    transcript.append_group_element("result", result);
+    transcript.append_group_element("z", proof.exponent_commitment);
+    BigInt prime = challenge_prime(transcript);
+    BigInt alpha = transcript.challenge("alpha", base.get_modulus());
+    if (proof.remainder >= prime) {
+        return false;
+    }
+    
+    // (base·g^α)^r 展开为 base^r · g^(α·r)，左侧是一次三项多重幂
+    GroupElement left_side = CryptoUtils::multi_exp({proof.quotient, base, generator},
+                                                    {prime, proof.remainder, alpha * proof.remainder});
+    return group.canonical(left_side) == group.canonical(result * (proof.exponent_commitment ^ alpha));
+}
+
+void ExponentiationProof::serialize_binary(std::vector<uint8_t>& out) const {
+    out.push_back(kBinaryProofVersion);
+    out.push_back(static_cast<uint8_t>(kind));
+    out.push_back(is_valid ? 1 : 0);
+    put_bigint(out, quotient.get_modulus());
+    put_bigint(out, quotient.get_value());
+    put_bigint(out, exponent_commitment.get_value());
+    put_bigint(out, remainder);
+}
+
+ExponentiationProof ExponentiationProof::deserialize_binary(const uint8_t* data, size_t length) {
+    ExponentiationProof proof;
+    if (!data || length < 3 || data[0] != kBinaryProofVersion ||
+        data[1] < static_cast<uint8_t>(Kind::POE) || data[1] > static_cast<uint8_t>(Kind::POKE)) {
+        return proof;
+    }
+    proof.kind = static_cast<Kind>(data[1]);
+    bool valid = data[2] == 1;
+    size_t pos = 3;
+    
+    BigInt modulus, quotient_value, commitment_value;
+    if (!get_bigint(data, length, pos, modulus) || !get_bigint(data, length, pos, quotient_value) ||
+        !get_bigint(data, length, pos, commitment_value) || !get_bigint(data, length, pos, proof.remainder) ||
+        modulus.is_zero()) {
+        return proof;
+    }
+    proof.quotient = GroupElement(quotient_value, modulus);
+    if (proof.kind == Kind::POKE) {
+        proof.exponent_commitment = GroupElement(commitment_value, modulus);
+    }
+    proof.is_valid = valid && pos == length;
+    return proof;
+}
@@ -0,0 +1,238 @@
+#include "acc_trie.h"
+#include "test_util.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+void fill(AccTrie& trie) {
+    for (const char* key : {"apple", "apricot", "app", "banana", "band", "cherry"}) {
+        trie.insert(key, std::string(key) + "-1");
+    }
+    trie.insert("apple", "apple-2");
+}
+
+// 值与链接元素取完整摘要并按域分离
+void test_element_mapping() {
+    ESA_CHECK(AccTrie::value_element("apple") != AccTrie::link_element("apple"));
+    ESA_CHECK(!AccTrie::value_element("apple").fits_u64());
+    ESA_CHECK(!AccTrie::link_element("").fits_u64());
+    ESA_CHECK(AccTrie::value_element("apple") == AccTrie::value_element("apple"));
+}
+
+void test_path_proofs() {
+    AccTrie trie;
+    // 空树只有哨兵证明
+    AccTrie::Digest empty_root = trie.root_digest();
+    AccTrie::PathProof empty_end = trie.prove_end();
+    ESA_CHECK(AccTrie::verify_path(empty_end, empty_root));
+
+    fill(trie);
+    AccTrie::Digest root = trie.root_digest();
+    // "app" 是内部节点上的终止叶子
+    for (const char* key : {"app", "apple", "apricot", "banana", "band", "cherry"}) {
+        ESA_CHECK(AccTrie::verify_path(trie.prove_path(key), root));
+    }
+    AccTrie::PathProof end = trie.prove_end();
+    ESA_CHECK(end.key == "cherry");
+    ESA_CHECK(AccTrie::verify_path(end, root));
+    ESA_CHECK(!trie.prove_path("apri").valid);
+    ESA_CHECK(!AccTrie::verify_path(empty_end, root));
+}
+
+// 证明的任一部分被改动、或对照的根不对时验证失败
+void test_rejects_tampered_path() {
+    AccTrie trie;
+    fill(trie);
+    AccTrie::Digest root = trie.root_digest();
+    AccTrie::PathProof proof = trie.prove_path("apple");
+    ESA_CHECK(AccTrie::verify_path(proof, root));
+
+    AccTrie::PathProof renamed = proof;
+    renamed.key = "apply";
+    ESA_CHECK(!AccTrie::verify_path(renamed, root));
+
+    AccTrie::PathProof sibling = proof;
+    sibling.steps[0].children[1].second[0] ^= 1;
+    ESA_CHECK(!AccTrie::verify_path(sibling, root));
+
+    // 加法累加器值相同而通用累加器值不同
+    AccTrie::PathProof universal = proof;
+    universal.ln_universal = RSAGroup::rsa2048().canonical(universal.ln_universal * universal.ln_universal);
+    ESA_CHECK(!AccTrie::verify_path(universal, root));
+    AccTrie::PathProof additive = proof;
+    additive.ln_acc = additive.ln_acc * trie.get_generator();
+    ESA_CHECK(!AccTrie::verify_path(additive, root));
+    AccTrie::PathProof end = proof;
+    end.end_universal = end.ln_universal;
+    ESA_CHECK(!AccTrie::verify_path(end, root));
+
+    // 空路径的哨兵证明不能用于非空树
+    AccTrie::PathProof emptied = proof;
+    emptied.key.clear();
+    emptied.steps.clear();
+    ESA_CHECK(!AccTrie::verify_path(emptied, root));
+
+    // 更新后旧证明对新根失效
+    trie.insert("apple", "apple-3");
+    ESA_CHECK(!AccTrie::verify_path(proof, trie.root_digest()));
+    ESA_CHECK(AccTrie::verify_path(trie.prove_path("apple"), trie.root_digest()));
+}
+
+void test_absence_proofs() {
+    AccTrie trie;
+    AccTrie::QueryResult nothing = trie.query("apple");
+    ESA_CHECK(AccTrie::verify_absence(nothing, trie.root_digest()));
+
+    fill(trie);
+    AccTrie::Digest root = trie.root_digest();
+    // 中间、链表头之前、尾部之后
+    for (const char* keyword : {"avocado", "aa", "zzz", "apples", "bana"}) {
+        AccTrie::QueryResult result = trie.query(keyword);
+        ESA_CHECK(!result.exists);
+        ESA_CHECK(AccTrie::verify_absence(result, root));
+    }
+    ESA_CHECK(!AccTrie::verify_absence(trie.query("apple"), root));
+}
+
+// 伪造邻居、跳过叶子、改动见证或使用不可信的根时验证失败
+void test_rejects_forged_absence() {
+    AccTrie trie;
+    AccTrie::Digest empty_root = trie.root_digest();
+    fill(trie);
+    AccTrie::Digest root = trie.root_digest();
+    AccTrie::QueryResult result = trie.query("avocado");
+    ESA_CHECK(result.keyp == "apricot" && result.keyn == "banana");
+    ESA_CHECK(AccTrie::verify_absence(result, root));
+    ESA_CHECK(!AccTrie::verify_absence(result, empty_root));
+
+    // 跳过apricot，声称它不存在
+    AccTrie::QueryResult skipped = result;
+    skipped.keyword = "apricot";
+    skipped.keyp = "apple";
+    skipped.keyp_path = trie.prove_path("apple");
+    ESA_CHECK(!AccTrie::verify_absence(skipped, root));
+    // 后序换成尾部哨兵
+    AccTrie::QueryResult tail = result;
+    tail.keyn.clear();
+    tail.keyn_path = trie.prove_end();
+    tail.lnn_acc = tail.keyn_path.end_acc;
+    ESA_CHECK(!AccTrie::verify_absence(tail, root));
+    // 后序换成更远的叶子
+    AccTrie::QueryResult far = result;
+    far.keyn = "band";
+    far.keyn_path = trie.prove_path("band");
+    far.lnn_acc = far.keyn_path.ln_acc;
+    ESA_CHECK(!AccTrie::verify_absence(far, root));
+
+    // 邻居不在根之下或与路径证明不一致
+    AccTrie::QueryResult renamed = result;
+    renamed.keyp = "apricots";
+    renamed.keyword = "avocado";
+    ESA_CHECK(!AccTrie::verify_absence(renamed, root));
+    AccTrie::QueryResult lnn = result;
+    lnn.lnn_acc = lnn.lnn_acc * trie.get_generator();
+    ESA_CHECK(!AccTrie::verify_absence(lnn, root));
+    AccTrie::QueryResult unproven = result;
+    unproven.keyp_path = AccTrie::PathProof();
+    ESA_CHECK(!AccTrie::verify_absence(unproven, root));
+
+    AccTrie::QueryResult witness = result;
+    witness.link_witness = RSAGroup::rsa2048().canonical(witness.link_witness * witness.link_witness);
+    ESA_CHECK(!AccTrie::verify_absence(witness, root));
+    witness.link_witness = GroupElement(result.link_witness.get_value(), trie.get_group_order());
+    ESA_CHECK(!AccTrie::verify_absence(witness, root));
+
+    // 插入avocado之后旧证明对新根失效
+    trie.insert("avocado", "avocado-1");
+    ESA_CHECK(!AccTrie::verify_absence(result, trie.root_digest()));
+}
+
+void test_range_proofs() {
+    AccTrie trie;
+    AccTrie::RangeResult empty = trie.range_query("a", "z");
+    ESA_CHECK(empty.entries.empty());
+    ESA_CHECK(AccTrie::verify_range(empty, "a", "z", trie.root_digest()));
+
+    fill(trie);
+    AccTrie::Digest root = trie.root_digest();
+    AccTrie::RangeResult all = trie.range_query("a", "z");
+    ESA_CHECK(all.entries.size() == 6);
+    ESA_CHECK(AccTrie::verify_range(all, "a", "z", root));
+    AccTrie::RangeResult middle = trie.range_query("apple", "band");
+    ESA_CHECK(middle.entries.size() == 4);
+    ESA_CHECK(AccTrie::verify_range(middle, "apple", "band", root));
+    AccTrie::RangeResult gap = trie.range_query("avocado", "azure");
+    ESA_CHECK(gap.entries.empty());
+    ESA_CHECK(AccTrie::verify_range(gap, "avocado", "azure", root));
+
+    for (const char* prefix : {"ap", "app", "b", "c", "z", ""}) {
+        ESA_CHECK(AccTrie::verify_prefix(trie.prefix_query(prefix), prefix, root));
+    }
+    ESA_CHECK(trie.prefix_query("ap").entries.size() == 3);
+}
+
+// 删掉中间的叶子、改动值、伪造边界或使用不可信的根时验证失败
+void test_rejects_forged_range() {
+    AccTrie trie;
+    fill(trie);
+    AccTrie::Digest root = trie.root_digest();
+    AccTrie::RangeResult result = trie.prefix_query("ap");
+    ESA_CHECK(AccTrie::verify_prefix(result, "ap", root));
+
+    AccTrie::RangeResult dropped = result;
+    dropped.entries.erase(dropped.entries.begin() + 1);
+    ESA_CHECK(!AccTrie::verify_prefix(dropped, "ap", root));
+    AccTrie::RangeResult truncated = result;
+    truncated.entries.pop_back();
+    ESA_CHECK(!AccTrie::verify_prefix(truncated, "ap", root));
+
+    // 值被改动、删掉或多出一个，叶子的通用累加器不再一致
+    AccTrie::RangeResult changed = result;
+    changed.entries[1].values[0] = "forged";
+    ESA_CHECK(!AccTrie::verify_prefix(changed, "ap", root));
+    AccTrie::RangeResult missing = result;
+    missing.entries[1].values.pop_back();
+    ESA_CHECK(!AccTrie::verify_prefix(missing, "ap", root));
+    AccTrie::RangeResult extra = result;
+    extra.entries[0].values.push_back("forged");
+    ESA_CHECK(!AccTrie::verify_prefix(extra, "ap", root));
+    AccTrie::RangeResult swapped = result;
+    swapped.entries[0].path = swapped.entries[1].path;
+    ESA_CHECK(!AccTrie::verify_prefix(swapped, "ap", root));
+
+    // 右边界换成更远的叶子或尾部哨兵
+    AccTrie::RangeResult far = result;
+    far.keyn = "band";
+    far.keyn_path = trie.prove_path("band");
+    far.lnn_acc = far.keyn_path.ln_acc;
+    ESA_CHECK(!AccTrie::verify_prefix(far, "ap", root));
+    AccTrie::RangeResult tail = result;
+    tail.keyn.clear();
+    tail.keyn_path = trie.prove_end();
+    tail.lnn_acc = tail.keyn_path.end_acc;
+    ESA_CHECK(!AccTrie::verify_prefix(tail, "ap", root));
+    AccTrie::RangeResult witness = result;
+    witness.link_witness = RSAGroup::rsa2048().canonical(witness.link_witness * witness.link_witness);
+    ESA_CHECK(!AccTrie::verify_prefix(witness, "ap", root));
+
+    // 左边界：范围查询中冒充存在一个不在树中的前序
+    AccTrie::RangeResult range = trie.range_query("b", "bz");
+    ESA_CHECK(AccTrie::verify_range(range, "b", "bz", root));
+    AccTrie::RangeResult left = range;
+    left.keyp = "azure";
+    ESA_CHECK(!AccTrie::verify_range(left, "b", "bz", root));
+    AccTrie::RangeResult unproven = range;
+    unproven.keyp_path = AccTrie::PathProof();
+    ESA_CHECK(!AccTrie::verify_range(unproven, "b", "bz", root));
+
+    // 更新后旧结果对新根失效
+    trie.insert("apply", "apply-1");
+    ESA_CHECK(!AccTrie::verify_prefix(result, "ap", trie.root_digest()));
+    ESA_CHECK(AccTrie::verify_prefix(trie.prefix_query("ap"), "ap", trie.root_digest()));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_element_mapping, test_path_proofs, test_rejects_tampered_path, test_absence_proofs, test_rejects_forged_absence,
+              test_range_proofs, test_rejects_forged_range)
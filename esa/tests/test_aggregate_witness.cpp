@@ -0,0 +1,58 @@
+#include "esa_accumulator.h"
+#include "esa_verifier.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+using esa_test::range;
+
+void test_honest_witnesses() {
+    ESAAccumulator acc(false);
+    acc.add_elements(range(1, 33));
+    std::vector<BigInt> first = range(1, 5);
+    std::vector<BigInt> second = range(10, 13);
+    GroupElement w1 = acc.generate_aggregate_witness(first);
+    GroupElement w2 = acc.generate_aggregate_witness(second);
+    ESA_CHECK(acc.verify_aggregate_witness(w1, first));
+
+    std::vector<BigInt> both = first;
+    both.insert(both.end(), second.begin(), second.end());
+    GroupElement combined = acc.combine_aggregate_witnesses(w1, first, w2, second);
+    ESA_CHECK(acc.verify_aggregate_witness(combined, both));
+
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(3, acc);
+    ESA_CHECK(verifier.verify_aggregate_witness(combined, both, 3));
+    ESA_CHECK(!acc.generate_aggregate_witness({BigInt::from_u64(99)}).valid());
+}
+
+// 阶公开时 W = U^(∏x^-1 mod ord) 可以给任意集合伪造见证；在未知阶群中用猜测的阶得到的值不能通过
+void test_rejects_forged_witness() {
+    ESAAccumulator acc(false);
+    acc.add_elements(range(1, 17));
+    std::vector<BigInt> claimed = {BigInt::from_u64(3), BigInt::from_u64(1000)};
+    BigInt product = CryptoUtils::hash_to_prime(claimed[0]) * CryptoUtils::hash_to_prime(claimed[1]);
+    BigInt guessed = acc.get_group_order() - BigInt("1");
+    GroupElement forged = acc.get_universal_group().canonical(
+        acc.get_universal_value() ^ CryptoUtils::mod_inverse(product % guessed, guessed));
+    ESA_CHECK(!acc.verify_aggregate_witness(forged, claimed));
+
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(1, acc);
+    ESA_CHECK(!verifier.verify_aggregate_witness(forged, claimed, 1));
+
+    // 成员子集的见证不能扩展到非成员，也不能改动
+    GroupElement honest = acc.generate_aggregate_witness({claimed[0]});
+    ESA_CHECK(acc.verify_aggregate_witness(honest, {claimed[0]}));
+    ESA_CHECK(!acc.verify_aggregate_witness(honest, claimed));
+    ESA_CHECK(!acc.verify_aggregate_witness(honest * acc.get_universal_group().get_base(), {claimed[0]}));
+    ESA_CHECK(!verifier.verify_aggregate_witness(honest, {claimed[0], claimed[0]}, 1));
+
+    // Z_p 中的元素不属于通用累加器的群
+    ESA_CHECK(!acc.verify_aggregate_witness(acc.get_generator(), {claimed[0]}));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_honest_witnesses, test_rejects_forged_witness)
@@ -0,0 +1,93 @@
+#include "batch_scheduler.h"
+#include "test_util.h"
+#include <chrono>
+#include <future>
+#include <vector>
+
+namespace {
+
+// 批次恰好在第size个请求到达时处理，窗口足够长，不会被计时器提前切开
+BatchScheduler::Config one_batch(size_t size) {
+    BatchScheduler::Config config;
+    config.max_batch_size = size;
+    config.max_delay = std::chrono::seconds(10);
+    return config;
+}
+
+// 同一批次内对同一元素插入、删除、再插入：各自按提交顺序成功，净效果只有一次插入
+void test_coalesced_updates() {
+    ESAAccumulator acc(false);
+    BigInt x = BigInt::from_u64(42);
+    BatchScheduler scheduler(acc, one_batch(4));
+    std::future<bool> first = scheduler.submit_insert(x);
+    std::future<bool> removed = scheduler.submit_remove(x);
+    std::future<bool> again = scheduler.submit_insert(x);
+    std::future<bool> duplicate = scheduler.submit_insert(x);
+    ESA_CHECK(first.get());
+    ESA_CHECK(removed.get());
+    ESA_CHECK(again.get());
+    ESA_CHECK(!duplicate.get());
+    scheduler.stop();
+
+    ESA_CHECK(acc.contains(x));
+    BatchScheduler::Stats stats = scheduler.stats();
+    ESA_CHECK(stats.batches == 1);
+    ESA_CHECK(stats.requests == 4);
+    ESA_CHECK(stats.max_batch == 4);
+    // 四个更新中只有一个改动了累加器
+    ESA_CHECK(stats.coalesced == 3);
+}
+
+// 批次中的查询都在更新后的同一个快照上回答，包括在更新之前提交的查询
+void test_queries_share_snapshot() {
+    ESAAccumulator acc(false);
+    BigInt a = BigInt::from_u64(7);
+    BigInt b = BigInt::from_u64(8);
+    BatchScheduler scheduler(acc, one_batch(4));
+    std::future<BatchScheduler::QueryResult> early = scheduler.submit_query(a);
+    std::future<bool> inserted = scheduler.submit_insert(a);
+    std::future<BatchScheduler::QueryResult> late = scheduler.submit_query(a);
+    std::future<BatchScheduler::QueryResult> absent = scheduler.submit_query(b);
+    ESA_CHECK(inserted.get());
+
+    std::vector<BatchScheduler::QueryResult> results = {early.get(), late.get(), absent.get()};
+    scheduler.stop();
+    for (const auto& result : results) {
+        ESA_CHECK(result.epoch == 1);
+        ESA_CHECK(result.accumulator == acc.get_accumulator_value());
+    }
+    ESA_CHECK(results[0].member && results[1].member && !results[2].member);
+    ESA_CHECK(acc.verify_membership_proof(results[0].proof, a));
+    ESA_CHECK(acc.verify_membership_proof(results[1].proof, a));
+    ESA_CHECK(acc.verify_non_membership_proof(results[2].proof, b));
+}
+
+// stop() 先处理完队列中的请求，之后的提交立即失败
+void test_stop_drains_queue() {
+    ESAAccumulator acc(false);
+    BatchScheduler scheduler(acc, one_batch(1000));
+    std::vector<std::future<bool>> pending;
+    for (uint64_t i = 1; i <= 5; i++) {
+        pending.push_back(scheduler.submit_insert(BigInt::from_u64(i)));
+    }
+    scheduler.stop();
+    for (auto& result : pending) {
+        ESA_CHECK(result.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        ESA_CHECK(result.get());
+    }
+    ESA_CHECK(scheduler.stats().requests == 5);
+    ESA_CHECK(acc.contains(BigInt::from_u64(5)));
+
+    ESA_CHECK(!scheduler.submit_insert(BigInt::from_u64(6)).get());
+    ESA_CHECK(!scheduler.submit_remove(BigInt::from_u64(1)).get());
+    BatchScheduler::QueryResult late = scheduler.submit_query(BigInt::from_u64(1)).get();
+    ESA_CHECK(!late.member && late.epoch == 0);
+    ESA_CHECK(!acc.contains(BigInt::from_u64(6)));
+    ESA_CHECK(acc.contains(BigInt::from_u64(1)));
+    ESA_CHECK(scheduler.stats().requests == 5);
+    scheduler.stop();
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_coalesced_updates, test_queries_share_snapshot, test_stop_drains_queue)
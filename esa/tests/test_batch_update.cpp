@@ -0,0 +1,113 @@
+#include "esa_accumulator.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+using esa_test::range;
+
+// 序列化后替换商Q：版本、种类、有效性之后依次是带4字节长度的模数和Q
+ExponentiationProof with_quotient(const ExponentiationProof& proof, const BigInt& quotient) {
+    std::vector<uint8_t> bytes;
+    proof.serialize_binary(bytes);
+    auto length_at = [&bytes](size_t pos) {
+        return (size_t(bytes[pos]) << 24) | (size_t(bytes[pos + 1]) << 16) | (size_t(bytes[pos + 2]) << 8) |
+               bytes[pos + 3];
+    };
+    size_t start = 3 + 4 + length_at(3);
+    size_t end = start + 4 + length_at(start);
+    std::vector<uint8_t> value = quotient.to_bytes();
+    std::vector<uint8_t> out(bytes.begin(), bytes.begin() + start);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>((value.size() >> shift) & 0xff));
+    }
+    out.insert(out.end(), value.begin(), value.end());
+    out.insert(out.end(), bytes.begin() + end, bytes.end());
+    return ExponentiationProof::deserialize_binary(out.data(), out.size());
+}
+
+void test_update_proofs() {
+    ESAAccumulator acc(false);
+    acc.add_elements(range(1, 9));
+    const RSAGroup& group = acc.get_universal_group();
+
+    GroupElement before = acc.get_universal_value();
+    std::vector<BigInt> applied;
+    ExponentiationProof proof;
+    acc.add_elements(range(5, 21), applied, proof);
+    GroupElement after = acc.get_universal_value();
+    ESA_CHECK(applied.size() == 12);
+    ESA_CHECK(ESAAccumulator::verify_batch_update(group, before, after, applied, true, proof));
+
+    std::vector<uint8_t> encoded;
+    proof.serialize_binary(encoded);
+    ExponentiationProof decoded = ExponentiationProof::deserialize_binary(encoded.data(), encoded.size());
+    ESA_CHECK(ESAAccumulator::verify_batch_update(group, before, after, applied, true, decoded));
+
+    // 少报一个生效元素、方向相反、商被改动都不能通过
+    std::vector<BigInt> partial(applied.begin(), applied.end() - 1);
+    ESA_CHECK(!ESAAccumulator::verify_batch_update(group, before, after, partial, true, proof));
+    ESA_CHECK(!ESAAccumulator::verify_batch_update(group, before, after, applied, false, proof));
+    encoded[encoded.size() - 20] ^= 1;
+    ExponentiationProof tampered = ExponentiationProof::deserialize_binary(encoded.data(), encoded.size());
+    ESA_CHECK(!ESAAccumulator::verify_batch_update(group, before, after, applied, true, tampered));
+
+    // 已知阶为2的 -1：Q' = -Q 时 Q'^ℓ·base^r = -after，-after 与 after 是同一个规范代表，
+    // 非规范的 N-after 不被当作新的U接受
+    BigInt modulus = group.get_modulus();
+    GroupElement negated(modulus - after.get_value(), modulus);
+    ESA_CHECK(!group.contains(negated));
+    ESA_CHECK(group.canonical(negated) == after);
+    ESA_CHECK(!group.contains(GroupElement(modulus - BigInt("1"), modulus)));
+    ESA_CHECK(!ESAAccumulator::verify_batch_update(group, before, negated, applied, true, proof));
+    ESA_CHECK(ESAAccumulator::verify_batch_update(group, before, after, applied, true,
+                                                  with_quotient(proof, proof.get_quotient().get_value())));
+    ExponentiationProof flipped = with_quotient(proof, modulus - proof.get_quotient().get_value());
+    ESA_CHECK(flipped.valid());
+    ESA_CHECK(!ESAAccumulator::verify_batch_update(group, before, after, applied, true, flipped));
+    ESA_CHECK(!ESAAccumulator::verify_batch_update(group, before, negated, applied, true, flipped));
+
+    // 删除方向
+    GroupElement full = acc.get_universal_value();
+    acc.remove_elements(range(1, 4), applied, proof);
+    ESA_CHECK(ESAAccumulator::verify_batch_update(group, full, acc.get_universal_value(), applied, false, proof));
+    ESA_CHECK(!ESAAccumulator::verify_batch_update(group, full, before, applied, false, proof));
+}
+
+// 阶已知的群里 PoE 可以随意伪造，这里不接受群外的元素，也不接受无效的群参数
+void test_rejects_known_order_group() {
+    ESAAccumulator acc(false);
+    const RSAGroup& group = acc.get_universal_group();
+    GroupElement g = acc.get_generator();
+    std::vector<BigInt> factors = {CryptoUtils::hash_to_prime(BigInt("7"))};
+    GroupElement result = g ^ factors[0];
+    ESA_CHECK(!ExponentiationProof::prove(group, g, factors, result).valid());
+
+    RSAGroup prime_group(acc.get_group_order(), BigInt("4"));
+    ESA_CHECK(!prime_group.valid());
+    GroupElement base(BigInt("4"), acc.get_group_order());
+    ExponentiationProof forged = ExponentiationProof::prove(prime_group, base, factors, base ^ factors[0]);
+    ESA_CHECK(!ExponentiationProof::verify(prime_group, base, factors, base ^ factors[0], forged));
+}
+
+void test_knowledge_proof() {
+    const RSAGroup& group = RSAGroup::rsa2048();
+    GroupElement base = group.canonical(group.get_base() ^ BigInt("12345"));
+    BigInt exponent = CryptoUtils::random_bits(256);
+    GroupElement result = group.canonical(base ^ exponent);
+    ExponentiationProof proof = ExponentiationProof::prove_knowledge(group, base, exponent, result);
+    ESA_CHECK(ExponentiationProof::verify_knowledge(group, base, result, proof));
+    ESA_CHECK(!ExponentiationProof::verify_knowledge(group, base, result * group.get_base(), proof));
+    // r = x mod ℓ，ℓ 为128位挑战素数
+    ESA_CHECK(proof.get_remainder().bit_length() > 64);
+
+    std::vector<uint8_t> encoded;
+    proof.serialize_binary(encoded);
+    encoded[encoded.size() - 1] ^= 1;   // 改动余数 r
+    ExponentiationProof tampered = ExponentiationProof::deserialize_binary(encoded.data(), encoded.size());
+    ESA_CHECK(!ExponentiationProof::verify_knowledge(group, base, result, tampered));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_update_proofs, test_rejects_known_order_group, test_knowledge_proof)
@@ -0,0 +1,169 @@
+#include "esa_c_api.h"
+#include "test_util.h"
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+// 置位时全局operator new抛出bad_alloc，用来走通C边界的异常路径
+bool fail_allocations = false;
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (fail_allocations) {
+        throw std::bad_alloc();
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// 与上面的operator new配对；GCC把内联后的new/free视为不匹配，这里是有意的
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+void put_u32_item(std::vector<uint8_t>& out, const std::vector<uint8_t>& item) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>((item.size() >> shift) & 0xff));
+    }
+    out.insert(out.end(), item.begin(), item.end());
+}
+
+void test_rejects_degenerate_params() {
+    const uint8_t zero[] = {0};
+    const uint8_t one[] = {1};
+    const uint8_t two[] = {2};
+    const uint8_t order[] = {23};
+    ESA_CHECK(esa_accumulator_new_with_params(zero, 1, two, 1) == nullptr);
+    ESA_CHECK(esa_accumulator_new_with_params(one, 1, zero, 1) == nullptr);
+    ESA_CHECK(esa_accumulator_new_with_params(order, 1, zero, 1) == nullptr);
+    ESA_CHECK(esa_accumulator_new_with_params(order, 1, order, 1) == nullptr);
+    esa_accumulator* acc = esa_accumulator_new_with_params(order, 1, two, 1);
+    ESA_CHECK(acc != nullptr);
+    esa_accumulator_free(acc);
+}
+
+void test_prove_retry_reuses_proofs() {
+    esa_accumulator* acc = esa_accumulator_new();
+    ESA_CHECK(acc != nullptr);
+    std::vector<uint8_t> elements;
+    for (uint8_t i = 1; i <= 8; i++) {
+        put_u32_item(elements, {i, static_cast<uint8_t>(i * 3)});
+    }
+    size_t count = 0;
+    ESA_CHECK(esa_add_batch(acc, elements.data(), elements.size(), &count) == ESA_OK && count == 8);
+
+    // 先查询大小，再用足够的缓冲区取回同一批证明
+    size_t needed = 0;
+    ESA_CHECK(esa_prove_membership_batch(acc, elements.data(), elements.size(), nullptr, 0, &needed) ==
+              ESA_ERR_BUFFER_TOO_SMALL);
+    std::vector<uint8_t> first(needed);
+    size_t written = 0;
+    ESA_CHECK(esa_prove_membership_batch(acc, elements.data(), elements.size(), first.data(), first.size(),
+                                         &written) == ESA_OK);
+    ESA_CHECK(written == needed);
+
+    std::vector<uint8_t> results(8);
+    ESA_CHECK(esa_verify_membership_batch(acc, elements.data(), elements.size(), first.data(), written,
+                                          results.data(), results.size(), &count) == ESA_OK);
+    ESA_CHECK(count == 8 && std::vector<uint8_t>(8, 1) == results);
+
+    // 缓存交付后失效：再次调用会重新生成（随机数不同），篡改的证明被拒绝
+    std::vector<uint8_t> second(needed * 2);
+    ESA_CHECK(esa_prove_membership_batch(acc, elements.data(), elements.size(), second.data(), second.size(),
+                                         &written) == ESA_OK);
+    ESA_CHECK(std::vector<uint8_t>(second.begin(), second.begin() + written) != first);
+    first[first.size() - 1] ^= 1;
+    ESA_CHECK(esa_verify_membership_batch(acc, elements.data(), elements.size(), first.data(), first.size(),
+                                          results.data(), results.size(), &count) == ESA_OK);
+    ESA_CHECK(results[7] == 0);
+    esa_accumulator_free(acc);
+}
+
+void test_null_arguments() {
+    size_t length = 0;
+    ESA_CHECK(esa_accumulator_value(nullptr, nullptr, 0, &length) == ESA_ERR_ARGUMENT);
+    ESA_CHECK(esa_add_batch(nullptr, nullptr, 0, &length) == ESA_ERR_ARGUMENT);
+}
+
+// 内部抛出的异常转换为错误码，句柄保持可用
+void test_exception_becomes_error_code() {
+    esa_accumulator* acc = esa_accumulator_new();
+    ESA_CHECK(acc != nullptr);
+    std::vector<uint8_t> elements;
+    put_u32_item(elements, {7});
+    put_u32_item(elements, {9});
+    size_t count = 0;
+    size_t length = 0;
+
+    fail_allocations = true;
+    ESA_CHECK(esa_accumulator_new() == nullptr);
+    ESA_CHECK(esa_add_batch(acc, elements.data(), elements.size(), &count) == ESA_ERR_INTERNAL);
+    ESA_CHECK(esa_prove_membership_batch(acc, elements.data(), elements.size(), nullptr, 0, &length) ==
+              ESA_ERR_INTERNAL);
+    fail_allocations = false;
+
+    ESA_CHECK(esa_accumulator_size(acc) == 0);
+    ESA_CHECK(esa_add_batch(acc, elements.data(), elements.size(), &count) == ESA_OK && count == 2);
+    ESA_CHECK(esa_prove_membership_batch(acc, elements.data(), elements.size(), nullptr, 0, &length) ==
+              ESA_ERR_BUFFER_TOO_SMALL);
+    esa_accumulator_free(acc);
+}
+
+// 同一句柄在多个线程间共享，更新和带重试状态的证明生成互不干扰
+void test_shared_handle() {
+    esa_accumulator* acc = esa_accumulator_new();
+    ESA_CHECK(acc != nullptr);
+    const size_t threads = 4;
+    const size_t per_thread = 16;
+    std::vector<int> failures(threads, 0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([acc, t, per_thread, &failures]() {
+            for (size_t i = 0; i < per_thread; i++) {
+                std::vector<uint8_t> element;
+                put_u32_item(element, {static_cast<uint8_t>(t + 1), static_cast<uint8_t>(i + 1)});
+                size_t count = 0;
+                size_t needed = 0;
+                size_t written = 0;
+                if (esa_add_batch(acc, element.data(), element.size(), &count) != ESA_OK || count != 1) {
+                    failures[t]++;
+                }
+                int status = esa_prove_membership_batch(acc, element.data(), element.size(), nullptr, 0, &needed);
+                std::vector<uint8_t> proof(needed);
+                if (status != ESA_ERR_BUFFER_TOO_SMALL ||
+                    esa_prove_membership_batch(acc, element.data(), element.size(), proof.data(), proof.size(),
+                                               &written) != ESA_OK) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    ESA_CHECK(failures == std::vector<int>(threads, 0));
+    ESA_CHECK(esa_accumulator_size(acc) == threads * per_thread);
+    esa_accumulator_free(acc);
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_rejects_degenerate_params, test_prove_retry_reuses_proofs, test_null_arguments,
+              test_exception_becomes_error_code, test_shared_handle)
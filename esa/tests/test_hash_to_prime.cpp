@@ -0,0 +1,90 @@
+#include "hash_to_prime.h"
+#include "parallel.h"
+#include "test_util.h"
+#include <openssl/bn.h>
+#include <set>
+#include <vector>
+
+namespace {
+
+bool openssl_prime(const BigInt& n) {
+    BN_CTX* ctx = BN_CTX_new();
+    bool prime = BN_check_prime(n.get_const_bn(), ctx, nullptr) == 1;
+    BN_CTX_free(ctx);
+    return prime;
+}
+
+// 不论缓存状态和调用线程，同一元素总是得到同一个256位素数
+void test_deterministic_wide_primes() {
+    HashToPrimeEngine uncached(0);
+    std::vector<BigInt> expected;
+    std::set<std::vector<uint8_t>> distinct;
+    for (uint64_t i = 0; i < 64; i++) {
+        BigInt prime = uncached.prime_for(BigInt::from_u64(i));
+        ESA_CHECK(BN_num_bits(prime.get_const_bn()) == 256);
+        ESA_CHECK(openssl_prime(prime));
+        distinct.insert(prime.to_bytes());
+        expected.push_back(prime);
+    }
+    ESA_CHECK(distinct.size() == expected.size());
+    ESA_CHECK(CryptoUtils::hash_to_prime(BigInt::from_u64(7)) == expected[7]);
+
+    HashToPrimeEngine cached(16);
+    std::vector<std::vector<BigInt>> results(4, std::vector<BigInt>(expected.size()));
+    Parallel::run(results.size(), [&](size_t worker) {
+        for (size_t i = 0; i < expected.size(); i++) {
+            size_t index = (i + worker * 16) % expected.size();
+            results[worker][index] = cached.prime_for(BigInt::from_u64(index));
+        }
+    });
+    for (const auto& result : results) {
+        ESA_CHECK(result == expected);
+    }
+    ESA_CHECK(cached.cache_size() <= 16);
+}
+
+void test_lru_cache() {
+    HashToPrimeEngine engine(2);
+    BigInt one = engine.prime_for(BigInt::from_u64(1));
+    engine.prime_for(BigInt::from_u64(2));
+    ESA_CHECK(engine.prime_for(BigInt::from_u64(1)) == one);
+    ESA_CHECK(engine.stats().hits == 1);
+
+    // 2是最久未使用的，插入3时被淘汰
+    engine.prime_for(BigInt::from_u64(3));
+    ESA_CHECK(engine.cache_size() == 2);
+    engine.prime_for(BigInt::from_u64(1));
+    ESA_CHECK(engine.stats().hits == 2);
+    engine.prime_for(BigInt::from_u64(2));
+    HashToPrimeEngine::Stats stats = engine.stats();
+    ESA_CHECK(stats.hits == 2 && stats.misses == 4);
+    ESA_CHECK(stats.candidates >= stats.sieved + stats.prime_tests);
+
+    engine.clear_cache();
+    ESA_CHECK(engine.cache_size() == 0);
+    ESA_CHECK(engine.prime_for(BigInt::from_u64(1)) == one);
+}
+
+void test_baillie_psw() {
+    // 对前几个底的强伪素数，以及Carmichael数
+    for (uint64_t n : {2047ULL, 561ULL, 3215031751ULL, 2152302898747ULL, 3474749660383ULL,
+                       341550071728321ULL, 3825123056546413051ULL}) {
+        ESA_CHECK(!HashToPrimeEngine::baillie_psw(n));
+    }
+    for (uint64_t n : {2ULL, 3ULL, 1021ULL, 1031ULL, 4294967291ULL, 2305843009213693951ULL,
+                       18446744073709551557ULL}) {
+        ESA_CHECK(HashToPrimeEngine::baillie_psw(n));
+    }
+    ESA_CHECK(!HashToPrimeEngine::baillie_psw(0));
+    ESA_CHECK(!HashToPrimeEngine::baillie_psw(1));
+    ESA_CHECK(!HashToPrimeEngine::baillie_psw(18446744073709551557ULL - 2));
+
+    // 超过试除范围的奇数与OpenSSL的判定一致
+    for (uint64_t n = 1000000000001ULL; n < 1000000004001ULL; n += 2) {
+        ESA_CHECK(HashToPrimeEngine::baillie_psw(n) == openssl_prime(BigInt::from_u64(n)));
+    }
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_deterministic_wide_primes, test_lru_cache, test_baillie_psw)
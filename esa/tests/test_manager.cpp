@@ -0,0 +1,78 @@
+#include "esa_manager.h"
+#include "esa_verifier.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+using esa_test::range;
+
+void test_trapdoor_matches_public_path() {
+    ESAAccumulatorManager manager(false);
+    ESA_CHECK(manager.has_trapdoor());
+    ESAAccumulator public_acc(manager.get_group_order(), manager.get_generator(), manager.get_universal_group(),
+                              false);
+    std::vector<BigInt> elements = range(1, 41);
+    manager.add_elements(elements);
+    public_acc.add_elements(elements);
+    manager.remove_element(elements[0]);
+    public_acc.remove_element(elements[0]);
+    ESA_CHECK(manager.get_universal_value() == public_acc.get_universal_value());
+
+    ESAVerifier verifier(manager.get_group_order(), manager.get_generator(), manager.get_universal_group());
+    verifier.trust(1, manager);
+    GroupElement witness = manager.generate_aggregate_witness({elements[1], elements[2]});
+    ESA_CHECK(public_acc.verify_aggregate_witness(witness, {elements[1], elements[2]}));
+    ESA_CHECK(verifier.verify_aggregate_witness(witness, {elements[1], elements[2]}, 1));
+    ZeroKnowledgeProof proof = manager.generate_non_membership_proof(elements[0]);
+    ESA_CHECK(public_acc.verify_non_membership_proof(proof, elements[0]));
+    ESA_CHECK(verifier.verify_non_membership(proof, elements[0], 1));
+
+    // 成员不会得到非成员证明，非成员不会得到见证
+    ESA_CHECK(!manager.generate_non_membership_proof(elements[1]).valid());
+    ESA_CHECK(!manager.generate_universal_witness(elements[0]).valid());
+}
+
+// 不知道 φ(N) 时，用公开的 Z_p 阶冒充陷门开根得不到有效的见证或非成员证明
+void test_public_order_gives_no_trapdoor() {
+    ESAAccumulatorManager manager(false);
+    std::vector<BigInt> elements = range(1, 21);
+    manager.add_elements(elements);
+    const RSAGroup& group = manager.get_universal_group();
+    BigInt guessed = manager.get_group_order() - BigInt("1");
+    BigInt x = CryptoUtils::hash_to_prime(BigInt::from_u64(500));
+
+    GroupElement forged_witness = group.canonical(manager.get_universal_value() ^ CryptoUtils::mod_inverse(x, guessed));
+    ESA_CHECK(!manager.verify_aggregate_witness(forged_witness, {BigInt::from_u64(500)}));
+
+    BigInt member_prime = CryptoUtils::hash_to_prime(elements[3]);
+    ZeroKnowledgeProof forged(ProofType::NON_MEMBERSHIP);
+    forged.set_commitment(group.canonical((manager.get_universal_value() * group.get_base().inverse()) ^
+                                          CryptoUtils::mod_inverse(member_prime, guessed)));
+    forged.set_response(BigInt("1"));
+    forged.add_auxiliary_data(manager.get_universal_value());
+    forged.set_valid(true);
+    ESA_CHECK(!manager.verify_non_membership_proof(forged, elements[3]));
+}
+
+void test_rejects_wrong_trapdoor() {
+    BigInt phi;
+    RSAGroup group = RSAGroup::generate(1024, &phi);
+    ESAAccumulator params(false);
+    ESAAccumulatorManager bogus(params.get_group_order(), params.get_generator(), group, phi + BigInt("2"), false);
+    ESA_CHECK(!bogus.has_trapdoor());
+    ESAAccumulatorManager manager(params.get_group_order(), params.get_generator(), group, phi, false);
+    ESA_CHECK(manager.has_trapdoor());
+
+    // 没有陷门时退回公开路径，结果仍然正确
+    std::vector<BigInt> elements = range(1, 11);
+    bogus.add_elements(elements);
+    manager.add_elements(elements);
+    ESA_CHECK(bogus.get_universal_value() == manager.get_universal_value());
+    GroupElement witness = bogus.generate_aggregate_witness({elements[4]});
+    ESA_CHECK(manager.verify_aggregate_witness(witness, {elements[4]}));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_trapdoor_matches_public_path, test_public_order_gives_no_trapdoor, test_rejects_wrong_trapdoor)
@@ -0,0 +1,68 @@
+#include "esa_accumulator.h"
+#include "test_util.h"
+#include <openssl/bn.h>
+#include <vector>
+
+namespace {
+
+using esa_test::range;
+
+// 定长区的起点：承诺和响应各占模数字节宽
+size_t entries_offset(const std::vector<uint8_t>& bytes, const ESAAccumulator& acc, size_t count) {
+    size_t width = BN_num_bytes(acc.get_group_order().get_const_bn());
+    return bytes.size() - 2 * width * count;
+}
+
+void test_rejects_tampered_entries() {
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements = range(1, 17);
+    acc.add_elements(elements);
+    MembershipProofBundle bundle = acc.generate_membership_proofs(elements, 3);
+    ESA_CHECK(acc.verify_membership_bundle(bundle, elements));
+
+    std::vector<uint8_t> bytes;
+    bundle.serialize_binary(bytes);
+    MembershipProofBundle decoded = MembershipProofBundle::deserialize_binary(bytes.data(), bytes.size());
+    ESA_CHECK(acc.verify_membership_bundle(decoded, elements, 2));
+
+    size_t width = BN_num_bytes(acc.get_group_order().get_const_bn());
+    size_t offset = entries_offset(bytes, acc, elements.size());
+    // 依次改动第一个承诺、中间一个响应
+    for (size_t pos : {offset + width - 1, offset + 9 * 2 * width + 2 * width - 1}) {
+        std::vector<uint8_t> tampered = bytes;
+        tampered[pos] ^= 1;
+        MembershipProofBundle forged = MembershipProofBundle::deserialize_binary(tampered.data(), tampered.size());
+        ESA_CHECK(forged.valid());
+        ESA_CHECK(!acc.verify_membership_bundle(forged, elements, 2));
+    }
+
+    // 截断或非规范编码不能解码成有效证明包
+    MembershipProofBundle truncated = MembershipProofBundle::deserialize_binary(bytes.data(), bytes.size() - 1);
+    ESA_CHECK(!truncated.valid());
+    std::vector<uint8_t> oversized = bytes;
+    for (size_t i = 0; i < width; i++) {
+        oversized[offset + width + i] = 0xff;
+    }
+    ESA_CHECK(!MembershipProofBundle::deserialize_binary(oversized.data(), oversized.size()).valid());
+}
+
+void test_rejects_mismatched_bundle() {
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements = range(1, 9);
+    acc.add_elements(elements);
+    MembershipProofBundle bundle = acc.generate_membership_proofs(elements);
+    ESA_CHECK(acc.verify_membership_bundle(bundle, elements));
+
+    ESA_CHECK(!acc.verify_membership_bundle(bundle, range(1, 8)));
+    ESA_CHECK(!acc.verify_membership_bundle(bundle, range(2, 10)));
+    ESA_CHECK(!acc.verify_membership_bundle(MembershipProofBundle(), {}));
+    ESA_CHECK(!acc.generate_membership_proofs({BigInt::from_u64(100)}).valid());
+
+    // 累加器变化后旧证明包失效
+    acc.add_element(BigInt::from_u64(100));
+    ESA_CHECK(!acc.verify_membership_bundle(bundle, elements));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_rejects_tampered_entries, test_rejects_mismatched_bundle)
@@ -0,0 +1,66 @@
+#include "esa_accumulator.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+// 分段并行的多重幂与逐项模幂结果一致
+void test_parallel_multi_exp() {
+    ESAAccumulator acc(false);
+    const BigInt& modulus = acc.get_group_order();
+    std::vector<BigInt> bases;
+    std::vector<BigInt> exponents;
+    for (uint64_t i = 0; i < 300; i++) {
+        bases.push_back(BigInt::from_u64(3 + i * 7919) % modulus);
+        exponents.push_back(BigInt::from_u64(i * 104729 + 1));
+    }
+    BigInt expected("1");
+    for (size_t i = 0; i < bases.size(); i++) {
+        expected = expected * CryptoUtils::mod_pow(bases[i], exponents[i], modulus) % modulus;
+    }
+    ESA_CHECK(CryptoUtils::multi_exp(bases, exponents, modulus, 1) == expected);
+    ESA_CHECK(CryptoUtils::multi_exp(bases, exponents, modulus, 3) == expected);
+    ESA_CHECK(CryptoUtils::multi_exp(bases, exponents, modulus, 16) == expected);
+}
+
+// 负指数按底数的逆元计算，Straus、Pippenger和分段并行三条路径一致
+void test_negative_exponents() {
+    ESAAccumulator acc(false);
+    const BigInt& modulus = acc.get_group_order();
+    for (size_t count : {3, 40, 300}) {
+        std::vector<BigInt> bases;
+        std::vector<BigInt> exponents;
+        BigInt expected("1");
+        for (uint64_t i = 0; i < count; i++) {
+            bases.push_back(BigInt::from_u64(5 + i * 7919) % modulus);
+            BigInt e = BigInt::from_u64(i * 104729 + 3);
+            BigInt base = i % 3 == 0 ? CryptoUtils::mod_inverse(bases.back(), modulus) : bases.back();
+            expected = expected * CryptoUtils::mod_pow(base, e, modulus) % modulus;
+            exponents.push_back(i % 3 == 0 ? BigInt("0") - e : e);
+        }
+        ESA_CHECK(exponents[0] < BigInt("0"));
+        ESA_CHECK(CryptoUtils::multi_exp(bases, exponents, modulus, 1) == expected);
+        ESA_CHECK(CryptoUtils::multi_exp(bases, exponents, modulus, 4) == expected);
+    }
+
+    GroupElement g = acc.get_generator();
+    GroupElement product = CryptoUtils::multi_exp({g, g}, {BigInt("-5"), BigInt("5")});
+    ESA_CHECK(product.valid() && product.get_value() == BigInt("1"));
+    ESA_CHECK(CryptoUtils::multi_exp({g}, {BigInt("-1")}) == g.inverse());
+}
+
+// 负指数对应的底数不可逆时没有定义，返回无效结果而不是按绝对值计算
+void test_rejects_non_invertible_base() {
+    BigInt modulus = BigInt::from_u64(3 * 1000003);
+    std::vector<BigInt> bases{BigInt("3"), BigInt("2")};
+    ESA_CHECK(CryptoUtils::multi_exp(bases, {BigInt("-1"), BigInt("1")}, modulus).is_zero());
+    ESA_CHECK(CryptoUtils::multi_exp(bases, {BigInt("1"), BigInt("-1")}, modulus) ==
+              BigInt("3") * CryptoUtils::mod_inverse(BigInt("2"), modulus) % modulus);
+    GroupElement three(BigInt("3"), modulus);
+    ESA_CHECK(!CryptoUtils::multi_exp({three}, {BigInt("-2")}).valid());
+    ESA_CHECK(CryptoUtils::multi_exp(bases, {BigInt("1"), BigInt("1")}, BigInt("0")).is_zero());
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_parallel_multi_exp, test_negative_exponents, test_rejects_non_invertible_base)
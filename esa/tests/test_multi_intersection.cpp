@@ -0,0 +1,65 @@
+#include "esa_accumulator.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+void fill(ESAAccumulator& acc, const std::vector<uint64_t>& ids) {
+    for (uint64_t id : ids) {
+        acc.add_element(BigInt::from_u64(id));
+    }
+}
+
+void test_honest_conjunction() {
+    ESAAccumulator acc(false);
+    fill(acc, {10, 20, 30, 40, 50, 60, 70, 80, 90, 100});
+    SortedElementSet posting(std::vector<uint64_t>{5, 20, 40, 45, 60, 100, 120});
+    SortedElementSet third(std::vector<uint64_t>{20, 60, 70, 100});
+    std::vector<GroupElement> digests = {acc.compute_set_digest(posting), acc.compute_set_digest(third)};
+
+    SetOperationResult result = acc.compute_multi_intersection({&posting, &third});
+    ESA_CHECK(result.result_set.size() == 3);
+    ESA_CHECK(acc.verify_set_operation_proof(result, digests));
+
+    // 两两相交但三者没有公共元素
+    SortedElementSet a(std::vector<uint64_t>{10, 200});
+    SortedElementSet b(std::vector<uint64_t>{20, 200});
+    SetOperationResult empty = acc.compute_multi_intersection({&a, &b});
+    ESA_CHECK(empty.result_set.empty());
+    ESA_CHECK(acc.verify_set_operation_proof(empty, {acc.compute_set_digest(a), acc.compute_set_digest(b)}));
+
+    // 只有当前集合一个操作数
+    SetOperationResult single = acc.compute_multi_intersection({});
+    ESA_CHECK(single.result_set.size() == acc.size());
+    ESA_CHECK(acc.verify_set_operation_proof(single, {}));
+}
+
+void test_rejects_tampered_conjunction() {
+    ESAAccumulator acc(false);
+    fill(acc, {10, 20, 30, 40, 50, 60, 70, 80, 90, 100});
+    SortedElementSet posting(std::vector<uint64_t>{5, 20, 40, 45, 60, 100, 120});
+    SortedElementSet third(std::vector<uint64_t>{20, 60, 70, 100});
+    std::vector<GroupElement> digests = {acc.compute_set_digest(posting), acc.compute_set_digest(third)};
+    SetOperationResult result = acc.compute_multi_intersection({&posting, &third});
+
+    // 去掉一个元素：剩余部分有公共元素60，不能通过
+    SetOperationResult dropped = result;
+    dropped.result_set.erase(BigInt::from_u64(60));
+    ESA_CHECK(!acc.verify_set_operation_proof(dropped, digests));
+    SetOperationResult extended = result;
+    extended.result_set.insert(BigInt::from_u64(40));
+    ESA_CHECK(!acc.verify_set_operation_proof(extended, digests));
+
+    // 操作数摘要顺序不对、缺少或换成另一个倒排列表
+    ESA_CHECK(!acc.verify_set_operation_proof(result, {digests[1], digests[0]}));
+    ESA_CHECK(!acc.verify_set_operation_proof(result, {digests[0]}));
+    SortedElementSet forged(std::vector<uint64_t>{20, 60, 100});
+    ESA_CHECK(!acc.verify_set_operation_proof(result, {digests[0], acc.compute_set_digest(forged)}));
+    // 证明者用缺了元素的倒排列表计算，验证方持有真正的摘要
+    SortedElementSet trimmed(std::vector<uint64_t>{20, 70, 100});
+    ESA_CHECK(!acc.verify_set_operation_proof(acc.compute_multi_intersection({&posting, &trimmed}), digests));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_honest_conjunction, test_rejects_tampered_conjunction)
@@ -0,0 +1,80 @@
+#include "esa_accumulator.h"
+#include "esa_verifier.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+using esa_test::range;
+
+void test_honest_proofs() {
+    ESAAccumulator acc(false);
+    acc.add_elements(range(1, 33));
+    std::vector<BigInt> queries = range(100, 108);
+    std::vector<ZeroKnowledgeProof> proofs = acc.generate_non_membership_proofs(queries);
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(1, acc);
+    for (size_t i = 0; i < queries.size(); i++) {
+        ESA_CHECK(acc.verify_non_membership_proof(proofs[i], queries[i]));
+        ESA_CHECK(verifier.verify_non_membership(proofs[i], queries[i], 1));
+    }
+    // 集合中的元素得不到证明
+    ESA_CHECK(!acc.generate_non_membership_proof(BigInt::from_u64(5)).valid());
+}
+
+// 阶公开时的伪造：a = 1，d = (U·h^-1)^(x^-1 mod ord)。在未知阶群中只能拿 p-1 之类的猜测值去算
+void test_rejects_forged_member_proof() {
+    ESAAccumulator acc(false);
+    acc.add_elements(range(1, 17));
+    const RSAGroup& group = acc.get_universal_group();
+    BigInt member = BigInt::from_u64(7);
+    BigInt x = CryptoUtils::hash_to_prime(member);
+    GroupElement target = acc.get_universal_value() * group.get_base().inverse();
+    BigInt guessed_order = acc.get_group_order() - BigInt("1");
+
+    ZeroKnowledgeProof forged(ProofType::NON_MEMBERSHIP);
+    forged.set_commitment(group.canonical(target ^ CryptoUtils::mod_inverse(x, guessed_order)));
+    forged.set_response(BigInt("1"));
+    forged.add_auxiliary_data(acc.get_universal_value());
+    forged.set_valid(true);
+    ESA_CHECK(!acc.verify_non_membership_proof(forged, member));
+
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(1, acc);
+    ESA_CHECK(!verifier.verify_non_membership(forged, member, 1));
+
+    // 借用非成员的证明去证明成员
+    ZeroKnowledgeProof borrowed = acc.generate_non_membership_proof(BigInt::from_u64(1000));
+    ESA_CHECK(borrowed.valid());
+    ESA_CHECK(!acc.verify_non_membership_proof(borrowed, member));
+}
+
+void test_rejects_tampered_proof() {
+    ESAAccumulator acc(false);
+    acc.add_elements(range(1, 17));
+    BigInt query = BigInt::from_u64(500);
+    ZeroKnowledgeProof proof = acc.generate_non_membership_proof(query);
+    ESA_CHECK(acc.verify_non_membership_proof(proof, query));
+
+    ZeroKnowledgeProof bad_response = proof;
+    bad_response.set_response(proof.get_response() + BigInt("1"));
+    ESA_CHECK(!acc.verify_non_membership_proof(bad_response, query));
+
+    ZeroKnowledgeProof bad_commitment = proof;
+    const RSAGroup& group = acc.get_universal_group();
+    bad_commitment.set_commitment(group.canonical(proof.get_commitment() * group.get_base()));
+    ESA_CHECK(!acc.verify_non_membership_proof(bad_commitment, query));
+
+    // 承诺不在未知阶群中
+    ZeroKnowledgeProof wrong_group = proof;
+    wrong_group.set_commitment(acc.get_generator());
+    ESA_CHECK(!acc.verify_non_membership_proof(wrong_group, query));
+
+    // 之后加入集合的元素，旧证明对新的U失效
+    acc.add_element(query);
+    ESA_CHECK(!acc.verify_non_membership_proof(proof, query));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_honest_proofs, test_rejects_forged_member_proof, test_rejects_tampered_proof)
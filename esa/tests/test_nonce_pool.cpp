@@ -0,0 +1,96 @@
+#include "nonce_pool.h"
+#include "test_util.h"
+#include <memory>
+#include <set>
+#include <string>
+
+namespace {
+
+NoncePool::Config small_pool() {
+    NoncePool::Config config;
+    config.capacity = 8;
+    config.low_watermark = 2;
+    config.batch_size = 3;
+    return config;
+}
+
+bool consistent(const NoncePool& pool, const NoncePool::Nonce& nonce) {
+    return !nonce.r.is_zero() && nonce.r < pool.get_exponent_order() &&
+           nonce.commitment == (pool.get_generator() ^ nonce.r);
+}
+
+// 停止后台线程后计数是确定的：队列为空时现场计算，prefill之后从队列取
+void test_accounting() {
+    ESAAccumulator acc(false);
+    NoncePool pool(acc.get_generator(), acc.get_group_order() - BigInt("1"), small_pool());
+    pool.stop();
+    pool.prefill();
+    NoncePool::Stats stats = pool.stats();
+    ESA_CHECK(stats.capacity == 8);
+    ESA_CHECK(stats.depth == 8);
+    uint64_t produced = stats.produced;
+    ESA_CHECK(produced >= 8);
+
+    std::set<std::string> seen;
+    for (int i = 0; i < 8; i++) {
+        NoncePool::Nonce nonce = pool.take();
+        ESA_CHECK(consistent(pool, nonce));
+        seen.insert(nonce.r.to_string());
+    }
+    // 每个随机数只取出一次
+    ESA_CHECK(seen.size() == 8);
+    stats = pool.stats();
+    ESA_CHECK(stats.depth == 0);
+    ESA_CHECK(stats.served == 8);
+    ESA_CHECK(stats.exhausted == 0);
+
+    for (int i = 0; i < 3; i++) {
+        ESA_CHECK(consistent(pool, pool.take()));
+    }
+    stats = pool.stats();
+    ESA_CHECK(stats.served == 8);
+    ESA_CHECK(stats.exhausted == 3);
+    ESA_CHECK(stats.produced == produced);
+}
+
+// prefill在后台线程运行时同样把队列补到容量上限，不会超出
+void test_prefill_reaches_capacity() {
+    ESAAccumulator acc(false);
+    NoncePool::Config config = small_pool();
+    config.constant_time = false;
+    NoncePool pool(acc.get_generator(), acc.get_group_order() - BigInt("1"), config);
+    pool.prefill();
+    ESA_CHECK(pool.stats().depth == config.capacity);
+    ESA_CHECK(consistent(pool, pool.take()));
+    pool.prefill();
+    ESA_CHECK(pool.stats().depth == config.capacity);
+    pool.stop();
+    ESA_CHECK(pool.stats().depth <= config.capacity);
+}
+
+// 群参数不一致的池被拒绝，累加器保持原来的设置
+void test_rejects_foreign_pool() {
+    ESAAccumulator acc(false);
+    BigInt order = acc.get_group_order() - BigInt("1");
+    auto other_generator = std::make_shared<NoncePool>(acc.get_generator() * acc.get_generator(), order, small_pool());
+    auto other_order = std::make_shared<NoncePool>(acc.get_generator(), order - BigInt("1"), small_pool());
+    auto matching = std::make_shared<NoncePool>(acc.get_generator(), order, small_pool());
+
+    ESA_CHECK(!acc.set_nonce_pool(other_generator));
+    ESA_CHECK(!acc.get_nonce_pool());
+    ESA_CHECK(!acc.set_nonce_pool(other_order));
+    ESA_CHECK(acc.set_nonce_pool(matching));
+    ESA_CHECK(!acc.set_nonce_pool(other_generator));
+    ESA_CHECK(acc.get_nonce_pool() == matching);
+
+    // 取自池的随机数生成的证明照常验证
+    BigInt x = BigInt::from_u64(11);
+    acc.add_element(x);
+    ESA_CHECK(acc.verify_membership_proof(acc.generate_membership_proof(x), x));
+    ESA_CHECK(acc.set_nonce_pool(nullptr));
+    ESA_CHECK(!acc.get_nonce_pool());
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_accounting, test_prefill_reaches_capacity, test_rejects_foreign_pool)
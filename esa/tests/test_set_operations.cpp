@@ -0,0 +1,123 @@
+#include "esa_accumulator.h"
+#include "test_util.h"
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using ElementSet = std::unordered_set<BigInt, BigInt::Hash>;
+
+ElementSet make_set(std::initializer_list<uint64_t> ids) {
+    ElementSet out;
+    for (uint64_t id : ids) {
+        out.insert(BigInt::from_u64(id));
+    }
+    return out;
+}
+
+void fill(ESAAccumulator& acc, const ElementSet& set) {
+    for (const auto& element : set) {
+        acc.add_element(element);
+    }
+}
+
+// 加法摘要 g^(Σx) 下 {1,4} 和 {2,3} 相同，乘积摘要能区分
+void test_digest_is_binding() {
+    ESAAccumulator acc(false);
+    ESA_CHECK(acc.compute_set_digest(make_set({1, 4})) != acc.compute_set_digest(make_set({2, 3})));
+    ESA_CHECK(acc.compute_set_digest(make_set({1, 2})) != acc.compute_set_digest(make_set({3})));
+    ESA_CHECK(acc.compute_set_digest(make_set({})) == acc.get_universal_group().get_base());
+
+    fill(acc, make_set({5, 6, 7}));
+    ESA_CHECK(acc.compute_set_digest(acc.get_current_set()) == acc.get_universal_value());
+    ESA_CHECK(acc.compute_set_digest(SortedElementSet(std::vector<uint64_t>{7, 5, 6})) == acc.get_universal_value());
+}
+
+void test_honest_operations() {
+    ESAAccumulator acc(false);
+    fill(acc, make_set({1, 2, 3, 4, 5}));
+    ElementSet other = make_set({4, 5, 6, 7});
+    std::vector<GroupElement> digest = {acc.compute_set_digest(other)};
+
+    SetOperationResult intersection = acc.compute_intersection(other);
+    SetOperationResult union_result = acc.compute_union(other);
+    SetOperationResult difference = acc.compute_difference(other);
+    SetOperationResult complement = acc.compute_complement(other);
+    ESA_CHECK(intersection.result_set == make_set({4, 5}));
+    ESA_CHECK(union_result.result_set == make_set({1, 2, 3, 4, 5, 6, 7}));
+    ESA_CHECK(difference.result_set == make_set({1, 2, 3}));
+    ESA_CHECK(acc.verify_set_operation_proof(intersection, digest));
+    ESA_CHECK(acc.verify_set_operation_proof(union_result, digest));
+    ESA_CHECK(acc.verify_set_operation_proof(difference, digest));
+    ESA_CHECK(acc.verify_set_operation_proof(complement, digest));
+    ESA_CHECK(acc.verify_complement_proof(complement, other));
+    ESA_CHECK(!acc.verify_complement_proof(difference, other));
+
+    // 空结果和空操作数
+    ElementSet disjoint = make_set({10, 11});
+    std::vector<GroupElement> disjoint_digest = {acc.compute_set_digest(disjoint)};
+    SetOperationResult empty = acc.compute_intersection(disjoint);
+    ESA_CHECK(empty.result_set.empty());
+    ESA_CHECK(acc.verify_set_operation_proof(empty, disjoint_digest));
+    SetOperationResult everything = acc.compute_difference(disjoint);
+    ESA_CHECK(acc.verify_set_operation_proof(everything, disjoint_digest));
+    SetOperationResult nothing_removed = acc.compute_difference(ElementSet());
+    ESA_CHECK(acc.verify_set_operation_proof(nothing_removed, {acc.compute_set_digest(ElementSet())}));
+}
+
+// 结果集合被改动、或证明针对的是另一个操作数时，验证必须失败
+void test_rejects_wrong_results() {
+    ESAAccumulator acc(false);
+    fill(acc, make_set({1, 2, 3, 4, 5}));
+    ElementSet other = make_set({4, 5, 6, 7});
+    std::vector<GroupElement> digest = {acc.compute_set_digest(other)};
+
+    SetOperationResult intersection = acc.compute_intersection(other);
+    SetOperationResult dropped = intersection;
+    dropped.result_set.erase(BigInt::from_u64(5));
+    ESA_CHECK(!acc.verify_set_operation_proof(dropped, digest));
+    SetOperationResult extended = intersection;
+    extended.result_set.insert(BigInt::from_u64(6));
+    ESA_CHECK(!acc.verify_set_operation_proof(extended, digest));
+
+    SetOperationResult union_result = acc.compute_union(other);
+    SetOperationResult shrunk = union_result;
+    shrunk.result_set.erase(BigInt::from_u64(7));
+    ESA_CHECK(!acc.verify_set_operation_proof(shrunk, digest));
+    SetOperationResult swapped = union_result;
+    swapped.result_set.erase(BigInt::from_u64(7));
+    swapped.result_set.insert(BigInt::from_u64(8));
+    ESA_CHECK(!acc.verify_set_operation_proof(swapped, digest));
+
+    SetOperationResult difference = acc.compute_difference(other);
+    SetOperationResult leaked = difference;
+    leaked.result_set.insert(BigInt::from_u64(4));
+    ESA_CHECK(!acc.verify_set_operation_proof(leaked, digest));
+    SetOperationResult missing = difference;
+    missing.result_set.erase(BigInt::from_u64(1));
+    ESA_CHECK(!acc.verify_set_operation_proof(missing, digest));
+
+    // 证明者对另一个集合计算，验证方持有真正操作数的摘要
+    ElementSet forged_other = make_set({4, 6, 7});
+    ESA_CHECK(!acc.verify_set_operation_proof(acc.compute_intersection(forged_other), digest));
+    ESA_CHECK(!acc.verify_set_operation_proof(acc.compute_union(forged_other), digest));
+    ESA_CHECK(!acc.verify_set_operation_proof(acc.compute_difference(forged_other), digest));
+    // {1,4} 与 {2,3} 的和相同，但乘积摘要不同
+    ElementSet left = make_set({1, 4});
+    ElementSet right = make_set({2, 3});
+    ESA_CHECK(!acc.verify_set_operation_proof(acc.compute_intersection(right), {acc.compute_set_digest(left)}));
+
+    // 摘要个数不对或不在未知阶群中
+    ESA_CHECK(!acc.verify_set_operation_proof(intersection, {}));
+    ESA_CHECK(!acc.verify_set_operation_proof(intersection, {digest[0], digest[0]}));
+    ESA_CHECK(!acc.verify_set_operation_proof(intersection, {acc.get_accumulator_value()}));
+
+    // 集合变化后旧证明不再对应当前的U
+    acc.add_element(BigInt::from_u64(9));
+    ESA_CHECK(!acc.verify_set_operation_proof(intersection, digest));
+    ESA_CHECK(!acc.verify_set_operation_proof(difference, digest));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_digest_is_binding, test_honest_operations, test_rejects_wrong_results)
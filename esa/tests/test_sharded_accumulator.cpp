@@ -0,0 +1,24 @@
+#include "sharded_accumulator.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+using esa_test::range;
+
+// 多线程批量增删：重复插入不计数，删除后各分片的成员关系正确
+void test_sharded_parallel_updates() {
+    ShardedAccumulator sharded(4);
+    sharded.set_worker_threads(3);
+    std::vector<BigInt> elements = range(1, 101);
+    ESA_CHECK(sharded.add_elements(elements) == elements.size());
+    ESA_CHECK(sharded.add_elements(elements) == 0);
+    ESA_CHECK(sharded.size() == elements.size());
+    ESA_CHECK(sharded.remove_elements(range(1, 51)) == 50);
+    ESA_CHECK(!sharded.contains(BigInt::from_u64(10)));
+    ESA_CHECK(sharded.contains(BigInt::from_u64(60)));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_sharded_parallel_updates)
@@ -0,0 +1,139 @@
+#include "sn_server.h"
+#include "test_util.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace {
+
+using SNProtocol::Method;
+using SNProtocol::Status;
+
+// 流水线发送插入、查询和删除，按请求编号匹配乱序到达的响应
+void test_pipelined_requests() {
+    SNServer server(4);
+    ESA_CHECK(server.start("127.0.0.1", 0));
+    ESA_CHECK(server.port() != 0);
+
+    SNClient client;
+    ESA_CHECK(client.connect("127.0.0.1", server.port()));
+    ESA_CHECK(client.insert("apple", "apple-1").success);
+    ESA_CHECK(client.insert("cherry", "cherry-1").success);
+
+    std::map<uint64_t, std::string> inserts;
+    std::map<uint64_t, std::string> queries;
+    for (int i = 0; i < 16; i++) {
+        std::string key = "key-" + std::to_string(i);
+        inserts[client.send_insert(key, key + "-v")] = key;
+        queries[client.send_query(i % 2 == 0 ? "apple" : "cherry")] = i % 2 == 0 ? "apple" : "cherry";
+    }
+    uint64_t removed = client.send_delete("cherry", "cherry-1");
+
+    size_t expected = inserts.size() + queries.size() + 1;
+    size_t received = 0;
+    bool saw_delete = false;
+    SNClient::Response response;
+    while (received < expected && client.receive(response)) {
+        received++;
+        ESA_CHECK(response.status == Status::OK);
+        if (inserts.count(response.request_id)) {
+            ESA_CHECK(response.method == Method::INSERT_KV);
+            ESA_CHECK(response.update.success);
+            ESA_CHECK(response.update.key == inserts[response.request_id]);
+            inserts.erase(response.request_id);
+        } else if (queries.count(response.request_id)) {
+            ESA_CHECK(response.method == Method::SINGLE_KEYWORD_QUERY);
+            ESA_CHECK(response.query.keyword == queries[response.request_id]);
+            // 删除可能先于查询执行，此时cherry已不存在
+            if (response.query.exists) {
+                ESA_CHECK(response.query.values.size() == 1);
+                ESA_CHECK(response.query.values[0] == response.query.keyword + "-1");
+            } else {
+                ESA_CHECK(response.query.keyword == "cherry");
+            }
+            queries.erase(response.request_id);
+        } else {
+            ESA_CHECK(response.request_id == removed);
+            ESA_CHECK(response.method == Method::DELETE_KV);
+            ESA_CHECK(response.update.success);
+            saw_delete = true;
+        }
+    }
+    ESA_CHECK(received == expected);
+    ESA_CHECK(inserts.empty() && queries.empty() && saw_delete);
+
+    // 最后一次更新返回的根即可信根，不存在证明对它验证
+    AccTrie::UpdateResult last = client.insert("banana", "banana-1");
+    ESA_CHECK(last.success);
+    ESA_CHECK(last.root == server.get_trie().root_digest());
+    AccTrie::QueryResult absent = client.query("cherry");
+    ESA_CHECK(!absent.exists);
+    ESA_CHECK(AccTrie::verify_absence(absent, last.root));
+    ESA_CHECK(!AccTrie::verify_absence(client.query("apple"), last.root));
+
+    client.close();
+    server.stop();
+    ESA_CHECK(!server.running());
+    ESA_CHECK(server.stats().bad_frames == 0);
+}
+
+// 超过单连接在途上限的流水线请求仍全部得到响应
+void test_in_flight_limit() {
+    SNServer server(2);
+    ESA_CHECK(server.start("127.0.0.1", 0));
+    SNClient client;
+    ESA_CHECK(client.connect("127.0.0.1", server.port()));
+    ESA_CHECK(client.insert("apple", "apple-1").success);
+
+    const size_t count = 500;
+    std::map<uint64_t, bool> pending;
+    for (size_t i = 0; i < count; i++) {
+        pending[client.send_query("apple")] = true;
+    }
+    SNClient::Response response;
+    size_t received = 0;
+    while (received < count && client.receive(response)) {
+        received++;
+        ESA_CHECK(pending.erase(response.request_id) == 1);
+        ESA_CHECK(response.query.exists);
+    }
+    ESA_CHECK(received == count);
+    ESA_CHECK(pending.empty());
+    ESA_CHECK(server.stats().requests == count + 2);
+    server.stop();
+}
+
+// 长度字段小于帧头的帧计入bad_frames，服务器关闭连接
+void test_malformed_frame() {
+    SNServer server(1);
+    ESA_CHECK(server.start("127.0.0.1", 0));
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(server.port());
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ESA_CHECK(fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    const uint8_t frame[] = {0, 0, 0, 3, 1, 2, 3};
+    ESA_CHECK(send(fd, frame, sizeof(frame), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(frame)));
+    uint8_t byte;
+    ESA_CHECK(recv(fd, &byte, 1, 0) == 0);
+    ::close(fd);
+    ESA_CHECK(server.stats().bad_frames == 1);
+
+    // 其他连接不受影响
+    SNClient client;
+    ESA_CHECK(client.connect("127.0.0.1", server.port()));
+    ESA_CHECK(client.insert("apple", "apple-1").success);
+    server.stop();
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_pipelined_requests, test_in_flight_limit, test_malformed_frame)
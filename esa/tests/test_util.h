@@ -0,0 +1,45 @@
+#ifndef ESA_TEST_UTIL_H
+#define ESA_TEST_UTIL_H
+
+#include "esa_accumulator.h"
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// 极简测试工具：检查失败时打印位置并计数，main 以失败个数作为退出码
+namespace esa_test {
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+// [begin, end) 中的连续整数元素
+inline std::vector<BigInt> range(uint64_t begin, uint64_t end) {
+    std::vector<BigInt> out;
+    for (uint64_t i = begin; i < end; i++) {
+        out.push_back(BigInt::from_u64(i));
+    }
+    return out;
+}
+} // namespace esa_test
+
+#define ESA_CHECK(cond)                                                                  \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << " 检查失败: " #cond << std::endl; \
+            esa_test::failures()++;                                                      \
+        }                                                                                \
+    } while (0)
+
+#define ESA_TEST_MAIN(...)                                   \
+    int main() {                                             \
+        for (auto test : {__VA_ARGS__}) {                    \
+            test();                                          \
+        }                                                    \
+        if (esa_test::failures() > 0) {                      \
+            std::cerr << esa_test::failures() << " 项检查失败" << std::endl; \
+        }                                                    \
+        return esa_test::failures() > 0 ? 1 : 0;             \
+    }
+
+#endif // ESA_TEST_UTIL_H
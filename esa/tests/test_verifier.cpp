@@ -0,0 +1,119 @@
+#include "esa_accumulator.h"
+#include "esa_verifier.h"
+#include "test_util.h"
+#include <vector>
+
+namespace {
+
+using esa_test::range;
+
+ZeroKnowledgeProof copy_with(const ZeroKnowledgeProof& proof, const GroupElement& commitment, const BigInt& challenge,
+                             const BigInt& response) {
+    ZeroKnowledgeProof out(proof.get_type());
+    out.set_commitment(commitment);
+    out.set_challenge(challenge);
+    out.set_response(response);
+    out.set_valid(true);
+    return out;
+}
+
+void test_rejects_tampered_membership() {
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements = range(1, 9);
+    acc.add_elements(elements);
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(1, acc);
+
+    ZeroKnowledgeProof proof = acc.generate_membership_proof(elements[2]);
+    ESA_CHECK(verifier.verify_membership(proof, elements[2], 1));
+    ESA_CHECK(!verifier.verify_membership(proof, elements[3], 1));
+    ESA_CHECK(!verifier.verify_membership(proof, elements[2], 2));
+
+    BigInt one("1");
+    ESA_CHECK(!verifier.verify_membership(
+        copy_with(proof, proof.get_commitment(), proof.get_challenge(), proof.get_response() + one), elements[2], 1));
+    ESA_CHECK(!verifier.verify_membership(
+        copy_with(proof, proof.get_commitment() * acc.get_generator(), proof.get_challenge(), proof.get_response()),
+        elements[2], 1));
+
+    // 承诺换到另一个模数下，按新承诺重新计算挑战和响应后仍被拒绝
+    GroupElement moved(proof.get_commitment().get_value(), acc.get_group_order() + BigInt("2"));
+    Transcript transcript("esa-membership");
+    transcript.append_group_element("commitment", moved);
+    transcript.append_group_element("accumulator", acc.get_accumulator_value());
+    transcript.append_bigint("element", elements[2]);
+    BigInt challenge = transcript.challenge("challenge", acc.get_group_order());
+    BigInt exponent_order = acc.get_group_order() - one;
+    BigInt response = (proof.get_randomness() + challenge * elements[2]) % exponent_order;
+    ZeroKnowledgeProof forged = copy_with(proof, moved, challenge, response);
+    ESA_CHECK(!verifier.verify_membership(forged, elements[2], 1));
+    ESA_CHECK(!verifier.verify_membership_batch({proof, forged}, {elements[2], elements[2]}, 1, 2));
+}
+
+void test_batch_matches_single() {
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements = range(100, 140);
+    acc.add_elements(elements);
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(7, acc);
+
+    std::vector<ZeroKnowledgeProof> proofs;
+    for (const auto& element : elements) {
+        proofs.push_back(acc.generate_membership_proof(element));
+    }
+    ESA_CHECK(verifier.verify_membership_batch(proofs, elements, 7, 1));
+    ESA_CHECK(verifier.verify_membership_batch(proofs, elements, 7, 4));
+    ESA_CHECK(verifier.verify_membership_batch(proofs, elements, 7, 64));
+
+    // 任一证明无效时整批失败，不论它落在哪个线程的区间
+    for (size_t bad : {size_t(0), size_t(17), elements.size() - 1}) {
+        std::vector<ZeroKnowledgeProof> tampered = proofs;
+        tampered[bad] = copy_with(proofs[bad], proofs[bad].get_commitment(), proofs[bad].get_challenge(),
+                                  proofs[bad].get_response() + BigInt("1"));
+        ESA_CHECK(!verifier.verify_membership_batch(tampered, elements, 7, 4));
+    }
+    std::vector<BigInt> swapped = elements;
+    std::swap(swapped[3], swapped[4]);
+    ESA_CHECK(!verifier.verify_membership_batch(proofs, swapped, 7, 4));
+}
+
+void test_rejects_tampered_bundle() {
+    ESAAccumulator acc(false);
+    std::vector<BigInt> elements = range(1, 33);
+    acc.add_elements(elements);
+    ESAVerifier verifier(acc.get_group_order(), acc.get_generator());
+    verifier.trust(1, acc);
+
+    MembershipProofBundle bundle = acc.generate_membership_proofs(elements, 4);
+    ESA_CHECK(bundle.valid());
+    ESA_CHECK(verifier.verify_membership_bundle(bundle, elements, 1));
+    ESA_CHECK(verifier.verify_membership_bundle(bundle, elements, 4));
+    ESA_CHECK(acc.verify_membership_bundle(bundle, elements, 4));
+
+    std::vector<BigInt> swapped = elements;
+    std::swap(swapped[0], swapped[31]);
+    ESA_CHECK(!verifier.verify_membership_bundle(bundle, swapped, 4));
+    ESA_CHECK(!verifier.verify_membership_bundle(bundle, range(1, 32), 4));
+
+    // 改动最后一个响应的最低字节
+    std::vector<uint8_t> bytes;
+    bundle.serialize_binary(bytes);
+    bytes.back() ^= 1;
+    MembershipProofBundle tampered = MembershipProofBundle::deserialize_binary(bytes.data(), bytes.size());
+    ESA_CHECK(tampered.valid());
+    ESA_CHECK(!verifier.verify_membership_bundle(tampered, elements, 4));
+    ESA_CHECK(!acc.verify_membership_bundle(tampered, elements, 4));
+
+    // 未登记的累加器值上的证明包不被接受
+    ESAAccumulator other(acc.get_group_order(), acc.get_generator(), false);
+    other.add_elements(elements);
+    other.add_element(BigInt::from_u64(1000));
+    MembershipProofBundle foreign = other.generate_membership_proofs(elements, 2);
+    ESA_CHECK(!verifier.verify_membership_bundle(foreign, elements, 2));
+    verifier.trust(2, other);
+    ESA_CHECK(verifier.verify_membership_bundle(foreign, elements, 2));
+}
+
+} // namespace
+
+ESA_TEST_MAIN(test_rejects_tampered_membership, test_batch_matches_single, test_rejects_tampered_bundle)